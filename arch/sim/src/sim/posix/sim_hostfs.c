@@ -26,6 +26,7 @@
 #include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 
 #include <dirent.h>
 #include <stdio.h>
@@ -399,6 +400,53 @@ int host_ftruncate(int fd, nuttx_off_t length)
   return ret;
 }
 
+/****************************************************************************
+ * Name: host_mmap
+ *
+ * Description:
+ *   Map a region of a host file.  The region does not need to start on a
+ *   host page boundary.
+ *
+ * Returned Value:
+ *   The address of the byte of the file at 'offset', or NULL on failure.
+ *
+ ****************************************************************************/
+
+void *host_mmap(int fd, nuttx_off_t offset, nuttx_size_t length,
+                int writable, int shared)
+{
+  nuttx_off_t pgoff = offset & (sysconf(_SC_PAGESIZE) - 1);
+  void *addr;
+
+  addr = mmap(NULL, length + pgoff,
+              writable ? PROT_READ | PROT_WRITE : PROT_READ,
+              shared ? MAP_SHARED : MAP_PRIVATE, fd, offset - pgoff);
+  if (addr == MAP_FAILED)
+    {
+      return NULL;
+    }
+
+  return (char *)addr + pgoff;
+}
+
+/****************************************************************************
+ * Name: host_munmap
+ ****************************************************************************/
+
+int host_munmap(void *addr, nuttx_size_t length)
+{
+  uintptr_t pgoff = (uintptr_t)addr & (sysconf(_SC_PAGESIZE) - 1);
+  int ret;
+
+  ret = munmap((char *)addr - pgoff, length + pgoff);
+  if (ret < 0)
+    {
+      ret = -errno;
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: host_opendir
  ****************************************************************************/
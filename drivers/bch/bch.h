@@ -35,6 +35,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -42,22 +43,64 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#ifndef CONFIG_BCH_CACHE_NSECTORS
+#  define CONFIG_BCH_CACHE_NSECTORS 1
+#endif
+
+#ifndef CONFIG_BCH_CACHE_READAHEAD
+#  define CONFIG_BCH_CACHE_READAHEAD 0
+#endif
+
+#if CONFIG_BCH_CACHE_READAHEAD > CONFIG_BCH_CACHE_NSECTORS
+#  error CONFIG_BCH_CACHE_READAHEAD exceeds CONFIG_BCH_CACHE_NSECTORS
+#endif
+
+/* The work queue used to write back the dirty sectors of an idle device */
+
+#ifdef CONFIG_BCH_CACHE_IDLE_FLUSH
+#  ifdef CONFIG_SCHED_LPWORK
+#    define BCHWORK LPWORK
+#  else
+#    define BCHWORK HPWORK
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One sector of the cache */
+
+struct bch_sector_s
+{
+  size_t sector;           /* The sector in the buffer, -1 if none */
+  uint32_t stamp;          /* Time of the last access, for LRU replacement */
+  bool dirty;              /* true: Data has been written to the buffer */
+  FAR uint8_t *buffer;     /* One sector buffer */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t sector;           /* The last sector accessed through the cache */
+  uint32_t stamp;          /* Access counter, for LRU replacement */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* The sector buffers of the cache */
+
+  /* The cached sectors.  The buffers of consecutive entries are adjacent
+   * in memory.
+   */
+
+  struct bch_sector_s cache[CONFIG_BCH_CACHE_NSECTORS];
+
+#ifdef CONFIG_BCH_CACHE_IDLE_FLUSH
+  struct work_s work;      /* Writes back the dirty sectors when idle */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -83,8 +126,13 @@ EXTERN const struct file_operations g_bch_fops;
  * Public Function Prototypes
  ****************************************************************************/
 
-EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
-EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_flushcache(FAR struct bchlib_s *bch, bool discard);
+EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                              FAR struct bch_sector_s **cache);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
+EXTERN void bchlib_copydirty(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                             size_t sector, size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
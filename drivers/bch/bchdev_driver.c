@@ -94,6 +94,33 @@ const struct file_operations g_bch_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: bch_flushworker
+ *
+ * Description:
+ *   Write back the dirty sectors of the cache once the device is idle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_CACHE_IDLE_FLUSH
+static void bch_flushworker(FAR void *arg)
+{
+  FAR struct bchlib_s *bch = (FAR struct bchlib_s *)arg;
+
+  /* Try again later if the device is busy */
+
+  if (nxmutex_trylock(&bch->lock) < 0)
+    {
+      work_queue(BCHWORK, &bch->work, bch_flushworker, bch,
+                 MSEC2TICK(CONFIG_BCH_CACHE_IDLE_FLUSH_DELAY));
+      return;
+    }
+
+  bchlib_flushcache(bch, false);
+  nxmutex_unlock(&bch->lock);
+}
+#endif
+
 /****************************************************************************
  * Name: bch_poll
  ****************************************************************************/
@@ -172,7 +199,7 @@ static int bch_close(FAR struct file *filep)
 
   /* Flush any dirty pages remaining in the cache */
 
-  bchlib_flushsector(bch, false);
+  bchlib_flushcache(bch, false);
 
   /* Decrement the reference count (I don't use bchlib_decref() because I
    * want the entire close operation to be atomic wrt other driver
@@ -343,6 +370,15 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
       if (ret > 0)
         {
           filep->f_pos += ret;
+
+#ifdef CONFIG_BCH_CACHE_IDLE_FLUSH
+          /* (Re-)start the delay before the dirty sectors are written
+           * back.
+           */
+
+          work_queue(BCHWORK, &bch->work, bch_flushworker, bch,
+                     MSEC2TICK(CONFIG_BCH_CACHE_IDLE_FLUSH_DELAY));
+#endif
         }
 
       nxmutex_unlock(&bch->lock);
@@ -439,7 +475,14 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         {
           /* Flush any dirty pages remaining in the cache */
 
-          ret = bchlib_flushsector(bch, false);
+          ret = nxmutex_lock(&bch->lock);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          ret = bchlib_flushcache(bch, false);
+          nxmutex_unlock(&bch->lock);
           if (ret < 0)
             {
               break;
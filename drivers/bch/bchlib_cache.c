@@ -27,8 +27,11 @@
 #include <nuttx/config.h>
 #include <nuttx/kmalloc.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -62,10 +65,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch,
+                      FAR struct bch_sector_s *cache, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)cache->buffer;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -73,7 +77,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        cache->sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -92,122 +96,441 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bchlib_alloccache
+ *
+ * Description:
+ *   Allocate the sector buffers of the cache on first use.
+ *
  ****************************************************************************/
 
+static int bchlib_alloccache(FAR struct bchlib_s *bch)
+{
+  size_t size = (size_t)bch->sectsize * CONFIG_BCH_CACHE_NSECTORS;
+  int i;
+
+#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
+  bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, size);
+#else
+  bch->buffer = kmm_malloc(size);
+#endif
+  if (bch->buffer == NULL)
+    {
+      ferr("Failed to allocate sector buffers\n");
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+    {
+      bch->cache[i].sector = (size_t)-1;
+      bch->cache[i].dirty  = false;
+      bch->cache[i].buffer = &bch->buffer[(size_t)bch->sectsize * i];
+    }
+
+  return OK;
+}
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bchlib_findsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Return the cache entry of a sector, or NULL if it is not cached.
  *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ ****************************************************************************/
+
+static FAR struct bch_sector_s *
+bchlib_findsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+    {
+      if (bch->cache[i].sector == sector)
+        {
+          return &bch->cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bchlib_age
+ *
+ * Description:
+ *   Return the number of cache accesses since a cache entry was last used.
+ *   Unused entries are the oldest ones.
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+static uint32_t bchlib_age(FAR struct bchlib_s *bch,
+                           FAR struct bch_sector_s *cache)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  if (cache->sector == (size_t)-1)
+    {
+      return UINT32_MAX;
+    }
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
-   */
+  return bch->stamp - cache->stamp;
+}
+
+/****************************************************************************
+ * Name: bchlib_replace
+ *
+ * Description:
+ *   Select the nsectors adjacent cache entries that will receive new
+ *   sectors: those whose most recently used entry is the least recently
+ *   used one.
+ *
+ * Returned Value:
+ *   The index of the first entry.
+ *
+ ****************************************************************************/
 
-  if (bch->dirty && bch->buffer != NULL)
+static int bchlib_replace(FAR struct bchlib_s *bch, size_t nsectors)
+{
+  uint32_t bestage = 0;
+  uint32_t age;
+  size_t best = 0;
+  size_t i;
+  size_t j;
+
+  for (i = 0; i + nsectors <= CONFIG_BCH_CACHE_NSECTORS; i++)
     {
-      inode = bch->inode;
+      age = UINT32_MAX;
+      for (j = i; j < i + nsectors; j++)
+        {
+          age = MIN(age, bchlib_age(bch, &bch->cache[j]));
+        }
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-      /* Encrypt data as necessary */
+      if (age > bestage)
+        {
+          bestage = age;
+          best    = i;
+        }
+    }
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
-#endif
+  return (int)best;
+}
 
-      /* Write the sector to the media */
+/****************************************************************************
+ * Name: bchlib_readahead
+ *
+ * Description:
+ *   Return the number of sectors to read, starting with a sector that is
+ *   not cached.  The following sectors are read ahead if the sector
+ *   follows the last one accessed, as long as they are not cached.  At
+ *   most half of the cache is filled by read-ahead.
+ *
+ ****************************************************************************/
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-      if (ret < 0)
+static size_t bchlib_readahead(FAR struct bchlib_s *bch, size_t sector)
+{
+  size_t nsectors = 1;
+#if CONFIG_BCH_CACHE_READAHEAD > 0
+  size_t maxsectors;
+
+  if (sector == bch->sector + 1)
+    {
+      maxsectors = MIN(CONFIG_BCH_CACHE_READAHEAD + 1,
+                       CONFIG_BCH_CACHE_NSECTORS / 2);
+      maxsectors = MIN(maxsectors, bch->nsectors - sector);
+
+      while (nsectors < maxsectors &&
+             bchlib_findsector(bch, sector + nsectors) == NULL)
         {
-          ferr("Write failed: %zd\n", ret);
-          return (int)ret;
+          nsectors++;
         }
+    }
+#endif
+
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: bchlib_writecache
+ *
+ * Description:
+ *   Write nsectors adjacent cache entries holding consecutive sectors back
+ *   to the media with a single request.
+ *
+ ****************************************************************************/
+
+static int bchlib_writecache(FAR struct bchlib_s *bch,
+                             FAR struct bch_sector_s *cache,
+                             size_t nsectors)
+{
+  FAR struct inode *inode = bch->inode;
+  ssize_t ret;
+  size_t i;
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
+
+  for (i = 0; i < nsectors; i++)
+    {
+      bch_cypher(bch, &cache[i], CYPHER_ENCRYPT);
+    }
+#endif
+
+  /* Write the sectors to the media */
+
+  ret = inode->u.i_bops->write(inode, cache->buffer, cache->sector,
+                               nsectors);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-      /* Computation overhead to save memory for extra sector buffer
-       * TODO: Add configuration switch for extra sector buffer
-       */
+  /* Computation overhead to save memory for extra sector buffer
+   * TODO: Add configuration switch for extra sector buffer
+   */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+  for (i = 0; i < nsectors; i++)
+    {
+      bch_cypher(bch, &cache[i], CYPHER_DECRYPT);
+    }
 #endif
 
-      /* The sector is now in sync with the media */
+  if (ret < 0)
+    {
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+  /* The sectors are now in sync with the media */
 
-      bch->dirty = false;
+  for (i = 0; i < nsectors; i++)
+    {
+      cache[i].dirty = false;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_flushcache
+ *
+ * Description:
+ *   Write the dirty sectors of the cache back to the media, in ascending
+ *   order.  Consecutive dirty sectors in adjacent cache entries are
+ *   written with a single request.  If discard is true, the cache is then
+ *   emptied.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushcache(FAR struct bchlib_s *bch, bool discard)
+{
+  FAR struct bch_sector_s *cache;
+  size_t nsectors;
+  int ret;
+  int i;
+
+  if (bch->buffer == NULL)
+    {
+      return OK;
+    }
+
+  for (; ; )
+    {
+      /* Find the lowest dirty sector */
+
+      cache = NULL;
+      for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+        {
+          if (bch->cache[i].dirty &&
+              (cache == NULL || bch->cache[i].sector < cache->sector))
+            {
+              cache = &bch->cache[i];
+            }
+        }
+
+      if (cache == NULL)
+        {
+          break;
+        }
+
+      /* Extend the run through the following entries */
+
+      for (nsectors = 1;
+           cache + nsectors < &bch->cache[CONFIG_BCH_CACHE_NSECTORS] &&
+           cache[nsectors].dirty &&
+           cache[nsectors].sector == cache->sector + nsectors;
+           nsectors++);
+
+      ret = bchlib_writecache(bch, cache, nsectors);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
 
   if (discard)
     {
-      bch->sector = (size_t)-1;
+      for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+        {
+          bch->cache[i].sector = (size_t)-1;
+        }
     }
 
-  return (int)ret;
+  return OK;
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Return the cache entry of a sector, reading the sector into the cache
+ *   if needed.  The least recently used entry is replaced, after it is
+ *   written back if dirty.  When the sectors are accessed sequentially,
+ *   the following sectors are read ahead with the same request.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                      FAR struct bch_sector_s **cache)
 {
   FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct bch_sector_s *entry;
+  size_t nsectors;
+  size_t i;
+  ssize_t ret;
 
   if (bch->buffer == NULL)
     {
-#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
-#else
-      bch->buffer = kmm_malloc(bch->sectsize);
-#endif
-      if (bch->buffer == NULL)
+      ret = bchlib_alloccache(bch);
+      if (ret < 0)
         {
-          ferr("Failed to allocate sector buffer\n");
-          return -ENOMEM;
+          return (int)ret;
         }
     }
 
-  if (bch->sector != sector)
+  entry = bchlib_findsector(bch, sector);
+  if (entry == NULL)
     {
-      inode = bch->inode;
+      inode    = bch->inode;
+      nsectors = bchlib_readahead(bch, sector);
+      entry    = &bch->cache[bchlib_replace(bch, nsectors)];
 
-      ret = bchlib_flushsector(bch, true);
-      if (ret < 0)
+      /* Write back the dirty sectors being replaced */
+
+      for (i = 0; i < nsectors; i++)
         {
-          ferr("Flush failed: %zd\n", ret);
-          return (int)ret;
+          if (entry[i].dirty)
+            {
+              ret = bchlib_writecache(bch, &entry[i], 1);
+              if (ret < 0)
+                {
+                  ferr("Flush failed: %zd\n", ret);
+                  return (int)ret;
+                }
+            }
+
+          entry[i].sector = (size_t)-1;
         }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      ret = inode->u.i_bops->read(inode, entry->buffer, sector, nsectors);
       if (ret < 0)
         {
           ferr("Read failed: %zd\n", ret);
           return (int)ret;
         }
 
-      bch->sector = sector;
+      /* Only keep what was actually read ahead */
+
+      if (ret > 0 && (size_t)ret < nsectors)
+        {
+          nsectors = ret;
+        }
+
+      for (i = 0; i < nsectors; i++)
+        {
+          entry[i].sector = sector + i;
+          entry[i].stamp  = bch->stamp;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+          bch_cypher(bch, &entry[i], CYPHER_DECRYPT);
 #endif
+        }
     }
 
-  return (int)ret;
+  entry->stamp = ++bch->stamp;
+  bch->sector  = sector;
+  *cache       = entry;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Drop the cached copies of a range of sectors, which were overwritten
+ *   on the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors)
+{
+  FAR struct bch_sector_s *cache;
+  int i;
+
+  if (bch->buffer == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+    {
+      cache = &bch->cache[i];
+      if (cache->sector != (size_t)-1 && cache->sector >= sector &&
+          cache->sector - sector < nsectors)
+        {
+          cache->sector = (size_t)-1;
+          cache->dirty  = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_copydirty
+ *
+ * Description:
+ *   Copy the dirty cached sectors of a range of sectors, which was read
+ *   from the media, over the stale data in the user buffer.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_copydirty(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+                      size_t sector, size_t nsectors)
+{
+  FAR struct bch_sector_s *cache;
+  int i;
+
+  if (bch->buffer == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+    {
+      cache = &bch->cache[i];
+      if (cache->dirty && cache->sector >= sector &&
+          cache->sector - sector < nsectors)
+        {
+          memcpy(&buffer[(cache->sector - sector) * bch->sectsize],
+                 cache->buffer, bch->sectsize);
+        }
+    }
 }
@@ -70,6 +70,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
                     size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  FAR struct bch_sector_s *cache;
   size_t   nsectors;
   size_t   sector;
   uint16_t sectoffset;
@@ -103,7 +104,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
       if (ret < 0)
         {
           return ret;
@@ -120,7 +121,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, &cache->buffer[sectoffset], nbytes);
 
       /* Adjust pointers and counts */
 
@@ -156,6 +157,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           return ret;
         }
 
+      /* The cache may hold data not yet written back to the media */
+
+      bchlib_copydirty(bch, (FAR uint8_t *)buffer, sector, nsectors);
+      bch->sector = sector + nsectors - 1;
+
       /* Adjust pointers and counts */
 
       sector    += nsectors;
@@ -177,7 +183,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
       if (ret < 0)
         {
           return ret;
@@ -185,7 +191,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, cache->buffer, len);
 
       /* Adjust counts */
 
@@ -64,7 +64,15 @@ int bchlib_teardown(FAR void *handle)
 
   /* Flush any pending data to the block driver */
 
-  bchlib_flushsector(bch, false);
+#ifdef CONFIG_BCH_CACHE_IDLE_FLUSH
+  /* Cancel the delayed write back, which requeues itself while the device
+   * is busy.
+   */
+
+  while (work_cancel_sync(BCHWORK, &bch->work) > 0);
+#endif
+
+  bchlib_flushcache(bch, false);
 
   /* Close the block driver */
 
@@ -56,6 +56,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
         size_t len)
 {
   FAR struct bchlib_s *bch = (FAR struct bchlib_s *)handle;
+  FAR struct bch_sector_s *cache;
   size_t   nsectors;
   size_t   sector;
   uint16_t sectoffset;
@@ -87,7 +88,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
     {
       /* Read the full sector into the sector buffer */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
       if (ret < 0)
         {
           return ret;
@@ -104,8 +105,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(&cache->buffer[sectoffset], buffer, nbytes);
+      cache->dirty = true;
 
       /* Adjust pointers and counts */
 
@@ -133,10 +134,12 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Flush the dirty sector to keep the sector sequence */
+      /* The cached sectors in the range are overwritten.  Flush the other
+       * dirty sectors to keep the sector sequence.
+       */
 
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
+      bchlib_invalidate(bch, sector, nsectors);
+      ret = bchlib_flushcache(bch, false);
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
@@ -174,7 +177,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      ret = bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &cache);
       if (ret < 0)
         {
           return ret;
@@ -182,8 +185,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(cache->buffer, buffer, len);
+      cache->dirty = true;
 
       /* Adjust counts */
 
@@ -38,8 +38,10 @@
 #include <net/if.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/irq.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
@@ -61,6 +63,26 @@
 #  error Worker thread support is required (CONFIG_SCHED_WORKQUEUE)
 #endif
 
+#ifndef CONFIG_NET_LOOPBACK_LOSS
+#  define CONFIG_NET_LOOPBACK_LOSS 0
+#endif
+
+#ifndef CONFIG_NET_LOOPBACK_DELAY
+#  define CONFIG_NET_LOOPBACK_DELAY 0
+#endif
+
+/* The loopback device emulates a lossy or a long-delay link, instead of
+ * relaying the packets back at once.
+ */
+
+#if CONFIG_NET_LOOPBACK_LOSS > 0 || CONFIG_NET_LOOPBACK_DELAY > 0
+#  define LO_IMPAIR 1
+#endif
+
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+#  define LO_DELAY_TICKS MSEC2TICK(CONFIG_NET_LOOPBACK_DELAY)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -73,6 +95,16 @@ struct lo_driver_s
 {
   bool lo_bifup;               /* true:ifup false:ifdown */
   struct work_s lo_work;       /* For deferring poll work to the work queue */
+#if CONFIG_NET_LOOPBACK_LOSS > 0
+  uint32_t lo_seed;            /* State of the packet loss generator */
+#endif
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+  struct work_s lo_dwork;      /* For delivering the delayed packets */
+  uint16_t lo_dhead;           /* Slot of the next packet to deliver */
+  uint16_t lo_dcount;          /* Number of packets on the delay line */
+  FAR struct iob_s *lo_dpkt[CONFIG_NET_LOOPBACK_DELAY_QLEN];
+  clock_t lo_ddue[CONFIG_NET_LOOPBACK_DELAY_QLEN];
+#endif
 
   /* This holds the information visible to the NuttX network */
 
@@ -95,6 +127,14 @@ static int lo_ifup(FAR struct net_driver_s *dev);
 static int lo_ifdown(FAR struct net_driver_s *dev);
 static void lo_txavail_work(FAR void *arg);
 static int lo_txavail(FAR struct net_driver_s *dev);
+#ifdef LO_IMPAIR
+static void lo_input(FAR struct net_driver_s *dev);
+static void lo_transmit(FAR struct lo_driver_s *priv);
+static int lo_txpoll(FAR struct net_driver_s *dev);
+#endif
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+static void lo_delay_work(FAR void *arg);
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
 static int lo_addmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 static int lo_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
@@ -165,12 +205,248 @@ static int lo_ifdown(FAR struct net_driver_s *dev)
 
   netdev_carrier_off(dev);
 
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+  /* Drop the packets still on the delay line */
+
+  work_cancel(LPWORK, &priv->lo_dwork);
+  for (; priv->lo_dcount > 0; priv->lo_dcount--)
+    {
+      iob_free_chain(priv->lo_dpkt[priv->lo_dhead]);
+      priv->lo_dhead = (priv->lo_dhead + 1) %
+                       CONFIG_NET_LOOPBACK_DELAY_QLEN;
+    }
+#endif
+
   /* Mark the device "down" */
 
   priv->lo_bifup = false;
   return OK;
 }
 
+/****************************************************************************
+ * Name: lo_input
+ *
+ * Description:
+ *   Relay a packet sent through the loopback device back to the network,
+ *   as devif_loopback() does.  A reply may be left in the device buffer.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef LO_IMPAIR
+static void lo_input(FAR struct net_driver_s *dev)
+{
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* A checksum left to the driver needs no completion on the way to
+   * ourself, the data can't have been corrupted.
+   */
+
+  if ((dev->d_iob->io_offload & IOB_OFFLOAD_CSUM_PARTIAL) != 0)
+    {
+      dev->d_iob->io_offload = IOB_OFFLOAD_CSUM_VALID;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      NETDEV_RXIPV4(dev);
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      NETDEV_RXIPV6(dev);
+      ipv6_input(dev);
+    }
+  else
+#endif
+    {
+      nwarn("WARNING: Unrecognized IP version\n");
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: lo_transmit
+ *
+ * Description:
+ *   Send the packet in the device buffer, and the replies to it, through
+ *   the emulated link: drop it with a probability of
+ *   CONFIG_NET_LOOPBACK_LOSS per mille, then put it on the delay line, or
+ *   relay it back at once without delay.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void lo_transmit(FAR struct lo_driver_s *priv)
+{
+  FAR struct net_driver_s *dev = &priv->lo_dev;
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+  uint16_t slot;
+#endif
+
+  while (dev->d_len > 0)
+    {
+      NETDEV_TXPACKETS(dev);
+
+#if CONFIG_NET_LOOPBACK_LOSS > 0
+      /* xorshift32, repeatable from boot to boot */
+
+      priv->lo_seed ^= priv->lo_seed << 13;
+      priv->lo_seed ^= priv->lo_seed >> 17;
+      priv->lo_seed ^= priv->lo_seed << 5;
+
+      if (priv->lo_seed % 1000 < CONFIG_NET_LOOPBACK_LOSS)
+        {
+          NETDEV_TXDONE(dev);
+          NETDEV_RXDROPPED(dev);
+          dev->d_len = 0;
+          break;
+        }
+#endif
+
+      NETDEV_TXDONE(dev);
+
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+      /* Take the buffer away from the device, it is delivered by
+       * lo_delay_work() once it is due.  A full delay line drops it.
+       */
+
+      if (priv->lo_dcount >= CONFIG_NET_LOOPBACK_DELAY_QLEN)
+        {
+          NETDEV_RXDROPPED(dev);
+          dev->d_len = 0;
+          break;
+        }
+
+      iob_update_pktlen(dev->d_iob, dev->d_len, false);
+
+      slot = (priv->lo_dhead + priv->lo_dcount++) %
+             CONFIG_NET_LOOPBACK_DELAY_QLEN;
+      priv->lo_dpkt[slot] = dev->d_iob;
+      priv->lo_ddue[slot] = clock_systime_ticks() + LO_DELAY_TICKS;
+      netdev_iob_clear(dev);
+
+      /* The delay is constant, the head of the line is always due
+       * first.
+       */
+
+      if (priv->lo_dcount == 1)
+        {
+          work_queue(LPWORK, &priv->lo_dwork, lo_delay_work, priv,
+                     LO_DELAY_TICKS);
+        }
+#else
+      lo_input(dev);
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: lo_txpoll
+ *
+ * Description:
+ *   The transmitter available callback of devif_poll(), used when the
+ *   link is impaired.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   One, stop the poll as devif_loopback() does: the input of the packet
+ *   may have changed the state of the connections.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int lo_txpoll(FAR struct net_driver_s *dev)
+{
+  lo_transmit((FAR struct lo_driver_s *)dev->d_private);
+  return 1;
+}
+#endif /* LO_IMPAIR */
+
+/****************************************************************************
+ * Name: lo_delay_work
+ *
+ * Description:
+ *   Deliver the packets of the delay line that are due, on the low
+ *   priority worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the NuttX driver state structure (cast to void*)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_LOOPBACK_DELAY > 0
+static void lo_delay_work(FAR void *arg)
+{
+  FAR struct lo_driver_s *priv = (FAR struct lo_driver_s *)arg;
+  FAR struct net_driver_s *dev = &priv->lo_dev;
+  clock_t now = clock_systime_ticks();
+  uint16_t slot;
+
+  net_lock();
+  while (priv->lo_dcount > 0)
+    {
+      slot = priv->lo_dhead;
+      if ((sclock_t)(priv->lo_ddue[slot] - now) > 0)
+        {
+          /* Not due yet, come back later */
+
+          work_queue(LPWORK, &priv->lo_dwork, lo_delay_work, priv,
+                     priv->lo_ddue[slot] - now);
+          break;
+        }
+
+      priv->lo_dhead = (slot + 1) % CONFIG_NET_LOOPBACK_DELAY_QLEN;
+      priv->lo_dcount--;
+      netdev_iob_replace(dev, priv->lo_dpkt[slot]);
+
+      /* Deliver it, a reply goes through the delay line again */
+
+      lo_input(dev);
+      lo_transmit(priv);
+      netdev_iob_release(dev);
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Name: lo_txavail_work
  *
@@ -197,11 +473,17 @@ static void lo_txavail_work(FAR void *arg)
   net_lock();
   if (priv->lo_bifup)
     {
+#ifdef LO_IMPAIR
+      /* Send the packets through the emulated link */
+
+      while (devif_poll(&priv->lo_dev, lo_txpoll));
+#else
       /* Reuse the devif_loopback() logic, Polling all pending events until
        * return stop
        */
 
       while (devif_poll(&priv->lo_dev, NULL));
+#endif
     }
 
   net_unlock();
@@ -328,6 +610,9 @@ int localhost_initialize(void)
   /* Initialize the driver structure */
 
   memset(priv, 0, sizeof(struct lo_driver_s));
+#if CONFIG_NET_LOOPBACK_LOSS > 0
+  priv->lo_seed = 2463534242u;
+#endif
   priv->lo_dev.d_ifup    = lo_ifup;      /* I/F up (new IP address) callback */
   priv->lo_dev.d_ifdown  = lo_ifdown;    /* I/F down callback */
   priv->lo_dev.d_txavail = lo_txavail;   /* New TX data callback */
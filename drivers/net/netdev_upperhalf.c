@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+
 #include <debug.h>
 #include <errno.h>
 #include <stdbool.h>
@@ -35,7 +37,9 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/mutex.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
@@ -56,12 +60,30 @@
 #  define NETDEV_WORK LPWORK
 #endif
 
-#ifdef CONFIG_NETDEV_RSS
+#if defined(CONFIG_NETDEV_RSS) || defined(CONFIG_NETDEV_MULTIQUEUE)
 #  define NETDEV_THREAD_COUNT CONFIG_SMP_NCPUS
 #else
 #  define NETDEV_THREAD_COUNT 1
 #endif
 
+/* The largest frame that may be handed to the lower half: TCP segments
+ * marked for TSO may exceed the MTU.
+ */
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define NETDEV_TXMAXSIZE(dev, pkt) \
+     ((netpkt_offload(pkt) & IOB_OFFLOAD_GSO) != 0 ? \
+      NET_LL_HDRLEN(dev) + (dev)->d_gsomax : NETDEV_PKTSIZE(dev))
+#else
+#  define NETDEV_TXMAXSIZE(dev, pkt) NETDEV_PKTSIZE(dev)
+#endif
+
+/* Maximum number of packets drained from the lower half per network lock
+ * round trip.
+ */
+
+#define NETDEV_RX_BATCH 8
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -72,6 +94,21 @@ struct netdev_upperhalf_s
 {
   FAR struct netdev_lowerhalf_s *lower;
 
+  /* Serializes all calls into the lower half.  Lock ordering: the network
+   * lock, if needed, must be taken before this one.
+   */
+
+  mutex_t lock;
+
+  /* Serializes the transmit_queue/receive_queue calls of each queue of a
+   * multi-queue lower half, instead of the lock above.  The other calls
+   * take the lock above and then all of these (see netdev_upper_lock()).
+   */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  mutex_t qlock[NETDEV_THREAD_COUNT];
+#endif
+
   /* Deferring poll work to work queue or thread */
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
@@ -127,6 +164,186 @@ static bool quota_is_valid(FAR struct netdev_lowerhalf_s *lower)
   return true;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_txqueue
+ *
+ * Description:
+ *   Select the queue of a multi-queue lower half to send a packet on, from
+ *   a hash of its addresses and ports: all the packets of a flow go
+ *   through the same queue and stay in order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netdev_upper_txqueue(FAR struct netdev_lowerhalf_s *lower,
+                                FAR netpkt_t *pkt)
+{
+  FAR const uint8_t *ip = IOB_DATA(pkt);
+  FAR const uint8_t *ports = NULL;
+  uint32_t hash = 0;
+  int i;
+
+  if (lower->nqueues <= 1 || pkt->io_len < IPv4_HDRLEN)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR const struct ipv4_hdr_s *ipv4 = (FAR const struct ipv4_hdr_s *)ip;
+
+      hash = net_ip4addr_conv32(ipv4->srcipaddr) ^
+             net_ip4addr_conv32(ipv4->destipaddr);
+
+      /* Fragments hash on the addresses only, so that all the fragments
+       * of a datagram take the same queue.
+       */
+
+      if ((ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP) &&
+          (ipv4->ipoffset[0] & 0x3f) == 0 && ipv4->ipoffset[1] == 0)
+        {
+          ports = ip + ((ipv4->vhl & IPv4_HLMASK) << 2);
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION &&
+      pkt->io_len >= IPv6_HDRLEN)
+    {
+      FAR const struct ipv6_hdr_s *ipv6 = (FAR const struct ipv6_hdr_s *)ip;
+
+      for (i = 0; i < 8; i++)
+        {
+          hash ^= ((uint32_t)ipv6->srcipaddr[i] << 16) ^
+                  ipv6->destipaddr[i];
+        }
+
+      if (ipv6->proto == IP_PROTO_TCP || ipv6->proto == IP_PROTO_UDP)
+        {
+          ports = ip + IPv6_HDRLEN;
+        }
+    }
+#endif
+
+  if (ports != NULL && ports + 4 <= ip + pkt->io_len)
+    {
+      for (i = 0; i < 4; i++)
+        {
+          hash ^= (uint32_t)ports[i] << (i * 8);
+        }
+    }
+
+  /* Mix the bits before reducing to the number of queues */
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+
+  return hash % lower->nqueues;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_qlock
+ *
+ * Description:
+ *   Get the lock serializing the transmit and receive calls of a queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static FAR mutex_t *netdev_upper_qlock(FAR struct netdev_upperhalf_s *upper,
+                                       int queue)
+{
+  return upper->lower->nqueues > 1 ? &upper->qlock[queue] : &upper->lock;
+}
+#else
+#  define netdev_upper_qlock(upper, queue) (&(upper)->lock)
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_lock/netdev_upper_unlock
+ *
+ * Description:
+ *   Take or release the upper half lock and the locks of all of the queues,
+ *   for the calls into the lower half that are not bound to one queue and
+ *   may race with the transmit and receive calls of any queue.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_lock(FAR struct netdev_upperhalf_s *upper)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int i;
+#endif
+
+  nxmutex_lock(&upper->lock);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (upper->lower->nqueues > 1)
+    {
+      for (i = 0; i < upper->lower->nqueues; i++)
+        {
+          nxmutex_lock(&upper->qlock[i]);
+        }
+    }
+#endif
+}
+
+static void netdev_upper_unlock(FAR struct netdev_upperhalf_s *upper)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int i;
+
+  if (upper->lower->nqueues > 1)
+    {
+      for (i = upper->lower->nqueues - 1; i >= 0; i--)
+        {
+          nxmutex_unlock(&upper->qlock[i]);
+        }
+    }
+#endif
+
+  nxmutex_unlock(&upper->lock);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_transmit/netdev_upper_receive
+ *
+ * Description:
+ *   Call the transmit or receive operation of the lower half for a queue.
+ *   The caller holds the lock of the queue.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_transmit(FAR struct netdev_lowerhalf_s *lower,
+                                 FAR netpkt_t *pkt, int queue)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      return lower->ops->transmit_queue(lower, pkt, queue);
+    }
+#endif
+
+  return lower->ops->transmit(lower, pkt);
+}
+
+static FAR netpkt_t *netdev_upper_receive(FAR struct netdev_lowerhalf_s
+                                          *lower, int queue)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      return lower->ops->receive_queue(lower, queue);
+    }
+#endif
+
+  return lower->ops->receive(lower);
+}
+
 /****************************************************************************
  * Name: netpkt_get
  *
@@ -147,9 +364,26 @@ static FAR netpkt_t *netpkt_get(FAR struct net_driver_s *dev,
   DEBUGASSERT(dev && dev->d_iob);
 
   upper = (FAR struct netdev_upperhalf_s *)dev->d_private;
-  pkt = dev->d_iob;
 
-  netdev_iob_clear(dev);
+#ifdef CONFIG_IOB_CLASSES
+  /* A small frame, like a pure ACK, waits for the completion of the
+   * transmission in a buffer of its size, and the device buffer is freed
+   * at once.  The device buffer is never kept: the next frame may not go
+   * through devif_poll() to be reset.
+   */
+
+  pkt = type == NETPKT_TX ? iob_tryshrink(dev->d_iob, false) : NULL;
+  if (pkt != NULL)
+    {
+      netdev_iob_release(dev);
+      netdev_iob_clear(dev);
+    }
+  else
+#endif
+    {
+      pkt = dev->d_iob;
+      netdev_iob_clear(dev);
+    }
 
   /* Do not limit quota here (simply relay iob instead of dropping), most
    * cases will be limited by netdev_upper_can_tx and seldom reaches here.
@@ -207,6 +441,9 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
   /* Allocate the upper-half data structure */
 
   FAR struct netdev_upperhalf_s *upper;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int i;
+#endif
 
   DEBUGASSERT(dev != NULL && dev->netdev.d_private == NULL);
 
@@ -217,6 +454,14 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
       return NULL;
     }
 
+  nxmutex_init(&upper->lock);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  for (i = 0; i < NETDEV_THREAD_COUNT; i++)
+    {
+      nxmutex_init(&upper->qlock[i]);
+    }
+#endif
+
   upper->lower = dev;
   dev->netdev.d_private = upper;
 
@@ -241,7 +486,9 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
 
   if (quota <= 0 && lower->ops->reclaim)
     {
+      netdev_upper_lock(upper);
       lower->ops->reclaim(lower);
+      netdev_upper_unlock(upper);
       quota = netdev_lower_quota_load(lower, NETPKT_TX);
     }
 
@@ -278,6 +525,7 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR netpkt_t                  *pkt;
+  int                            queue = 0;
   int                            ret;
 
   DEBUGASSERT(dev->d_len > 0);
@@ -292,14 +540,20 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_TXMAXSIZE(dev, pkt))
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
   else
     {
-      ret = lower->ops->transmit(lower, pkt);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      queue = netdev_upper_txqueue(lower, pkt);
+#endif
+
+      nxmutex_lock(netdev_upper_qlock(upper, queue));
+      ret = netdev_upper_transmit(lower, pkt, queue);
+      nxmutex_unlock(netdev_upper_qlock(upper, queue));
     }
 
   if (ret != OK)
@@ -584,80 +838,134 @@ static void ip_input(FAR struct net_driver_s *dev)
 #endif
 
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Function: netdev_upper_input
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Pass a packet received from the device into the IP stack and queue
+ *   replies for sending if necessary.
  *
  * Input Parameters:
- *   upper - Reference to the upper half driver structure
+ *   dev - Reference to the NuttX driver state structure
+ *   pkt - The received packet
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static void netdev_upper_input(FAR struct net_driver_s *dev,
+                               FAR netpkt_t *pkt)
 {
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR struct net_driver_s       *dev   = &lower->netdev;
-  FAR netpkt_t                  *pkt;
-
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  if (!IFF_IS_UP(dev->d_flags))
     {
-      if (!IFF_IS_UP(dev->d_flags))
-        {
-          /* Interface down, drop frame */
+      /* Interface down, drop frame */
 
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          continue;
-        }
+      NETDEV_RXDROPPED(dev);
+      netpkt_free(upper->lower, pkt, NETPKT_RX);
+      return;
+    }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
 
 #ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+  /* When packet sockets are enabled, feed the frame into the tap */
 
-      pkt_input(dev);
+  pkt_input(dev);
 #endif
 
-      switch (dev->d_lltype)
-        {
+  switch (dev->d_lltype)
+    {
 #ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
+    case NET_LL_LOOPBACK:
 #endif
 #ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
+    case NET_LL_ETHERNET:
 #endif
 #ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
+    case NET_LL_IEEE80211:
 #endif
 #if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
     defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
+      eth_input(dev);
+      break;
 #endif
 #ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
 #endif
 #ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_work
+ *
+ * Description:
+ *   Try to receive packets from device and pass packets into IP
+ *   stack and send packets which is from IP stack if necessary.
+ *
+ *   Packets are drained from the lower half in batches holding only the
+ *   device lock, the network lock is taken just for the protocol input.
+ *   This keeps the hardware serviced while the network is busy elsewhere.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   queue - The queue to receive from
+ *
+ * Assumptions:
+ *   Called with the network unlocked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     int queue)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR netpkt_t                  *pkts[NETDEV_RX_BATCH];
+  int                            npkts;
+  int                            i;
+
+  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+
+  do
+    {
+      nxmutex_lock(netdev_upper_qlock(upper, queue));
+      for (npkts = 0; npkts < NETDEV_RX_BATCH; npkts++)
+        {
+          pkts[npkts] = netdev_upper_receive(lower, queue);
+          if (pkts[npkts] == NULL)
+            {
+              break;
+            }
+        }
+
+      nxmutex_unlock(netdev_upper_qlock(upper, queue));
+
+      if (npkts > 0)
+        {
+          net_lock();
+          for (i = 0; i < npkts; i++)
+            {
+              netdev_upper_input(dev, pkts[i]);
+            }
+
+          net_unlock();
         }
     }
+  while (npkts == NETDEV_RX_BATCH);
 }
 
 /****************************************************************************
@@ -677,8 +985,9 @@ static void netdev_upper_work(FAR void *arg)
 
   /* RX may release quota and driver buffer, so do RX first. */
 
+  netdev_upper_rxpoll_work(upper, 0);
+
   net_lock();
-  netdev_upper_rxpoll_work(upper);
   netdev_upper_txavail_work(upper);
   net_unlock();
 }
@@ -718,7 +1027,7 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
     (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
   int cpu = atoi(argv[2]);
 
-#ifdef CONFIG_NETDEV_RSS
+#if defined(CONFIG_NETDEV_RSS) || defined(CONFIG_NETDEV_MULTIQUEUE)
   cpu_set_t cpuset;
 
   CPU_ZERO(&cpuset);
@@ -726,9 +1035,33 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
   sched_setaffinity(upper->tid[cpu], sizeof(cpu_set_t), &cpuset);
 #endif
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* The thread of each CPU services the queue with the same number */
+
+  if (cpu < upper->lower->nqueues && upper->lower->ops->affinity != NULL)
+    {
+      upper->lower->ops->affinity(upper->lower, cpu, cpu);
+    }
+#endif
+
   while (netdev_upper_wait(&upper->sem[cpu]) == OK &&
          upper->tid[cpu] != INVALID_PROCESS_ID)
     {
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      if (upper->lower->nqueues > 1)
+        {
+          if (cpu < upper->lower->nqueues)
+            {
+              netdev_upper_rxpoll_work(upper, cpu);
+            }
+
+          net_lock();
+          netdev_upper_txavail_work(upper);
+          net_unlock();
+          continue;
+        }
+#endif
+
       netdev_upper_work(upper);
     }
 
@@ -749,12 +1082,10 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
  *
  ****************************************************************************/
 
-static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
-{
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-
 #ifdef CONFIG_NETDEV_WORK_THREAD
-  int cpu = this_cpu();
+static inline void netdev_upper_post(FAR struct netdev_upperhalf_s *upper,
+                                     int cpu)
+{
   int semcount;
 
   if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
@@ -762,6 +1093,15 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
     {
       nxsem_post(&upper->sem[cpu]);
     }
+}
+#endif
+
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+#ifdef CONFIG_NETDEV_WORK_THREAD
+  netdev_upper_post(upper, this_cpu());
 #else
   if (work_available(&upper->work))
     {
@@ -1043,6 +1383,7 @@ int netdev_upper_wireless_ioctl(FAR struct netdev_lowerhalf_s *lower,
 static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
   int i;
@@ -1082,7 +1423,10 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 
   if (upper->lower->ops->ifup)
     {
-      return upper->lower->ops->ifup(upper->lower);
+      netdev_upper_lock(upper);
+      ret = upper->lower->ops->ifup(upper->lower);
+      netdev_upper_unlock(upper);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1091,6 +1435,7 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
 #ifndef CONFIG_NETDEV_WORK_THREAD
   work_cancel(NETDEV_WORK, &upper->work);
@@ -1098,7 +1443,10 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 
   if (upper->lower->ops->ifdown)
     {
-      return upper->lower->ops->ifdown(upper->lower);
+      netdev_upper_lock(upper);
+      ret = upper->lower->ops->ifdown(upper->lower);
+      netdev_upper_unlock(upper);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1109,10 +1457,14 @@ static int netdev_upper_addmac(FAR struct net_driver_s *dev,
                                FAR const uint8_t *mac)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
   if (upper->lower->ops->addmac)
     {
-      return upper->lower->ops->addmac(upper->lower, mac);
+      netdev_upper_lock(upper);
+      ret = upper->lower->ops->addmac(upper->lower, mac);
+      netdev_upper_unlock(upper);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1124,10 +1476,14 @@ static int netdev_upper_rmmac(FAR struct net_driver_s *dev,
                               FAR const uint8_t *mac)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
   if (upper->lower->ops->rmmac)
     {
-      return upper->lower->ops->rmmac(upper->lower, mac);
+      netdev_upper_lock(upper);
+      ret = upper->lower->ops->rmmac(upper->lower, mac);
+      netdev_upper_unlock(upper);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1140,24 +1496,27 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int ret = -ENOTTY;
+
+  /* The wireless handlers may block for a long time, e.g. while scanning
+   * or associating, so they are not serialized with the RX and TX paths.
+   */
 
 #ifdef CONFIG_NETDEV_WIRELESS_HANDLER
   if (lower->iw_ops)
     {
-      int ret = netdev_upper_wireless_ioctl(lower, cmd, arg);
-      if (ret != -ENOTTY)
-        {
-          return ret;
-        }
+      ret = netdev_upper_wireless_ioctl(lower, cmd, arg);
     }
 #endif
 
-  if (lower->ops->ioctl)
+  if (ret == -ENOTTY && lower->ops->ioctl)
     {
-      return lower->ops->ioctl(lower, cmd, arg);
+      netdev_upper_lock(upper);
+      ret = lower->ops->ioctl(lower, cmd, arg);
+      netdev_upper_unlock(upper);
     }
 
-  return -ENOTTY;
+  return ret;
 }
 #endif
 
@@ -1187,12 +1546,31 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct netdev_upperhalf_s *upper;
   int ret;
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_WORK_THREAD) || defined(CONFIG_NETDEV_MULTIQUEUE)
   int i;
 #endif
 
-  if (dev == NULL || quota_is_valid(dev) == false || dev->ops == NULL ||
-      dev->ops->transmit == NULL || dev->ops->receive == NULL)
+  if (dev == NULL || quota_is_valid(dev) == false || dev->ops == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->nqueues > 1)
+    {
+      if (dev->ops->transmit_queue == NULL ||
+          dev->ops->receive_queue == NULL)
+        {
+          return -EINVAL;
+        }
+
+      /* There is one work thread per CPU to service the queues */
+
+      dev->nqueues = MIN(dev->nqueues, NETDEV_THREAD_COUNT);
+    }
+  else
+#endif
+  if (dev->ops->transmit == NULL || dev->ops->receive == NULL)
     {
       return -EINVAL;
     }
@@ -1217,6 +1595,14 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
     {
+      nxmutex_destroy(&upper->lock);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      for (i = 0; i < NETDEV_THREAD_COUNT; i++)
+        {
+          nxmutex_destroy(&upper->qlock[i]);
+        }
+#endif
+
       kmm_free(upper);
       dev->netdev.d_private = NULL;
     }
@@ -1288,6 +1674,14 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
   iob_free_queue(&upper->txq);
 #endif
 
+  nxmutex_destroy(&upper->lock);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  for (i = 0; i < NETDEV_THREAD_COUNT; i++)
+    {
+      nxmutex_destroy(&upper->qlock[i]);
+    }
+#endif
+
   kmm_free(upper);
   dev->netdev.d_private = NULL;
 
@@ -1365,6 +1759,40 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue/netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read or a
+ *   TX packet is sent on one queue of a multi-queue driver.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue number
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  DEBUGASSERT(queue >= 0 && queue < NETDEV_THREAD_COUNT);
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  netdev_upper_post(dev->netdev.d_private, queue);
+#endif
+}
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue)
+{
+  DEBUGASSERT(queue >= 0 && queue < NETDEV_THREAD_COUNT);
+  NETDEV_TXDONE(&dev->netdev);
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  netdev_upper_post(dev->netdev.d_private, queue);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -24,6 +24,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
 #include <debug.h>
 #include <errno.h>
 #include <stdint.h>
@@ -35,6 +36,7 @@
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
+#include <nuttx/signal.h>
 
 #include "virtio-net.h"
 
@@ -44,7 +46,22 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_HOST_TSO4  11
+#define VIRTIO_NET_F_HOST_TSO6  12
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
+
+/* Virtio net header flags and GSO types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_F_DATA_VALID 2
+
+#define VIRTIO_NET_HDR_GSO_NONE     0
+#define VIRTIO_NET_HDR_GSO_TCPV4    1
+#define VIRTIO_NET_HDR_GSO_TCPV6    4
 
 /* Virtio net header size and packet buffer size */
 
@@ -52,17 +69,83 @@
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* Virtio net control commands */
+
+#define VIRTIO_NET_CTRL_MQ            4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+
+#define VIRTIO_NET_OK         0
+
+/* How long to wait for the device to complete a control command */
+
+#define VIRTIO_NET_CTRL_TIMEOUT_MS 1000
+
+/* Virtio net virtqueue index and number, the RX and TX virtqueues of each
+ * queue pair are interleaved, followed by the control virtqueue.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
-#define VIRTIO_NET_NUM        2
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define VIRTIO_NET_MAX_PAIRS CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_NET_MAX_PAIRS 1
+#endif
+
+#define VIRTIO_NET_RXQ(q)     (2 * (q) + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(q)     (2 * (q) + VIRTIO_NET_TX)
+#define VIRTIO_NET_NUM        (2 * VIRTIO_NET_MAX_PAIRS)
 
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* TCP segments sent with TSO may span more I/O buffers than a frame, the
+ * largest one is limited by the size of the iov array on the stack.
+ */
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define VIRTIO_NET_TX_NIOB  MAX(VIRTIO_NET_MAX_NIOB, 16)
+#  define VIRTIO_NET_GSO_MAXSIZE \
+     MIN(VIRTIO_NET_TX_NIOB * CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE, \
+         UINT16_MAX)
+#else
+#  define VIRTIO_NET_TX_NIOB  VIRTIO_NET_MAX_NIOB
+#endif
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define VIRTIO_NET_FEATURES \
+     ((1UL << VIRTIO_NET_F_CSUM) | (1UL << VIRTIO_NET_F_GUEST_CSUM) | \
+      (1UL << VIRTIO_NET_F_HOST_TSO4) | (1UL << VIRTIO_NET_F_HOST_TSO6))
+#else
+#  define VIRTIO_NET_FEATURES 0
+#endif
+
+/* TSO is per device, so the device must take the segments of all the IP
+ * versions in use.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define VIRTIO_NET_HAS_TSO(vdev) \
+     (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4) && \
+      virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6))
+#elif defined(CONFIG_NET_IPv4)
+#  define VIRTIO_NET_HAS_TSO(vdev) \
+     virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4)
+#else
+#  define VIRTIO_NET_HAS_TSO(vdev) \
+     virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6)
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define VIRTIO_NET_MQ_FEATURES \
+     ((1UL << VIRTIO_NET_F_CTRL_VQ) | (1UL << VIRTIO_NET_F_MQ))
+#else
+#  define VIRTIO_NET_MQ_FEATURES 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -81,6 +164,18 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t csum_offset;
 } end_packed_struct;
 
+/* Virtio net control virtqueue command, the class and command are read by
+ * the device, the ack is written back.
+ */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;                            /* VIRTIO_NET_CTRL_MQ */
+  uint8_t  ack;
+} end_packed_struct;
+
 /* The definition of the struct virtio_net_config refers to the link
  * https://docs.oasis-open.org/virtio/virtio/v1.2/cs01/
  * virtio-v1.2-cs01.html#x1-2230004.
@@ -118,6 +213,10 @@ struct virtio_net_priv_s
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+  int                       txbufnum;  /* TX Buffer number */
+  int                       npairs;    /* Queue pairs in use */
+  int                       rxnum[VIRTIO_NET_MAX_PAIRS]; /* RX buffers
+                                                          * in each queue */
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -154,6 +253,10 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt);
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, int queue);
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int queue);
 #ifdef CONFIG_NET_MCASTGROUP
 static int virtio_net_addmac(FAR struct netdev_lowerhalf_s *dev,
                              FAR const uint8_t *mac);
@@ -194,7 +297,12 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  virtio_net_send_queue,
+  virtio_net_recv_queue,
+  NULL                  /* The virtqueues of a device share one interrupt */
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -205,6 +313,87 @@ static uint8_t g_netdev_num = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_net_txoffload
+ *
+ * Description:
+ *   Fill the virtio net header of a packet to transmit from the checksum
+ *   and segmentation requests of the network stack.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void virtio_net_txoffload(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt,
+                                 FAR struct virtio_net_hdr_s *vhdr)
+{
+  FAR const uint8_t *tcp;
+  uint8_t offload = netpkt_offload(pkt);
+
+  if ((offload & IOB_OFFLOAD_CSUM_PARTIAL) != 0)
+    {
+      vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+      vhdr->csum_start  = netpkt_csum_start(dev, pkt);
+      vhdr->csum_offset = netpkt_csum_offset(dev, pkt);
+    }
+
+  if ((offload & IOB_OFFLOAD_GSO) != 0)
+    {
+      /* The TCP header length is needed for hdr_len, the headers are
+       * always in the first I/O buffer.
+       */
+
+      tcp = netpkt_getdata(dev, pkt) + vhdr->csum_start;
+
+      vhdr->gso_type = (offload & IOB_OFFLOAD_GSO_TCPV4) != 0 ?
+                       VIRTIO_NET_HDR_GSO_TCPV4 : VIRTIO_NET_HDR_GSO_TCPV6;
+      vhdr->gso_size = netpkt_gso_size(pkt);
+      vhdr->hdr_len  = vhdr->csum_start + ((tcp[12] >> 4) << 2);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: virtio_net_rxcsum
+ *
+ * Description:
+ *   Complete the partial checksum of a received packet: the checksum field
+ *   holds the pseudo-header sum, add the sum of the data from csum_start to
+ *   the end of the packet.
+ *
+ * Returned Value:
+ *   True if the checksum was completed, false if the offsets given by the
+ *   device are out of the packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static bool virtio_net_rxcsum(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt,
+                              FAR const struct virtio_net_hdr_s *vhdr)
+{
+  unsigned int llhdrlen = NET_LL_HDRLEN(&dev->netdev);
+  unsigned int start;
+  uint16_t sum;
+
+  if (vhdr->csum_start < llhdrlen ||
+      vhdr->csum_start + vhdr->csum_offset + 2 >
+      netpkt_getdatalen(dev, pkt))
+    {
+      return false;
+    }
+
+  /* The I/O buffer data starts at the L3 header */
+
+  start = vhdr->csum_start - llhdrlen;
+  sum   = chksum_iob(0, pkt, start);
+  sum   = ~((sum == 0) ? 0xffff : HTONS(sum));
+
+  return iob_trycopyin(pkt, (FAR const uint8_t *)&sum, sizeof(sum),
+                       start + vhdr->csum_offset, false) >= 0;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_addbuffer
  ****************************************************************************/
@@ -215,14 +404,14 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
   FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  struct virtqueue_buf vb[VIRTIO_NET_TX_NIOB + 1];
+  struct iovec iov[VIRTIO_NET_TX_NIOB];
   int iov_cnt;
   int i;
 
   /* Convert netpkt to virtqueue_buf */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_TX_NIOB);
 
   /* Alloc cookie and net header from transport layer */
 
@@ -232,6 +421,13 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
   memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
   hdr->pkt = pkt;
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (vq_id % 2 == VIRTIO_NET_TX)
+    {
+      virtio_net_txoffload(dev, pkt, &hdr->vhdr);
+    }
+#endif
+
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
@@ -241,7 +437,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       vb[0].buf = &hdr->vhdr;
       vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
 
-#if VIRTIO_NET_MAX_NIOB > 1
+#if VIRTIO_NET_TX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
@@ -266,7 +462,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (vq_id % 2 == VIRTIO_NET_RX)
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -280,16 +476,23 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 
 /****************************************************************************
  * Name: virtio_net_rxfill
+ *
+ * Description:
+ *   Give RX buffers to the RX virtqueue of a queue pair.  The RX quota is
+ *   shared by the queue pairs, each one holds its part of it at most.
+ *
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev, int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(queue)].vq;
   FAR netpkt_t *pkt;
+  int bufnum = MAX(priv->bufnum / priv->npairs, 1);
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  for (i = 0; priv->rxnum[queue] < bufnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -312,12 +515,13 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RXQ(queue));
+      priv->rxnum[queue]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RXQ(queue)]);
     }
 }
 
@@ -325,10 +529,12 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
  * Name: virtio_net_txfree
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txfree_queue(FAR struct netdev_lowerhalf_s *dev,
+                                    int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(queue)].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
@@ -336,7 +542,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
       /* Get buffer from tx virtqueue */
 
       hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+                                      &priv->lock[VIRTIO_NET_TXQ(queue)]);
       if (hdr == NULL)
         {
           break;
@@ -347,6 +553,17 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtio_net_txfree_queue(dev, i);
+    }
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -354,6 +571,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -370,9 +588,12 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq,
+                               &priv->lock[VIRTIO_NET_RXQ(i)]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -395,7 +616,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < 2 * priv->npairs; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -415,18 +636,28 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_send_queue
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(queue)].vq;
+  unsigned int maxlen = VIRTIO_NET_BUFSIZE;
+  int ret;
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if ((netpkt_offload(pkt) & IOB_OFFLOAD_GSO) != 0)
+    {
+      maxlen = ETH_HDRLEN + VIRTIO_NET_GSO_MAXSIZE;
+    }
+#endif
 
   /* Check the send length */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  if (netpkt_getdatalen(dev, pkt) > maxlen)
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
@@ -434,65 +665,113 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  ret = virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TXQ(queue));
+  if (ret < 0)
+    {
+      vrterr("virtio_net_addbuffer failed, ret=%d\n", ret);
+      return ret;
+    }
+
+  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TXQ(queue)]);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfree_queue(dev, queue);
 
   /* If we have no buffer left, enable TX done callback. */
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TXQ(queue)]);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_send_queue(dev, pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv_queue
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(queue)].vq;
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, queue);
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
+  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RXQ(queue)]);
   hdr = virtqueue_get_buffer(vq, &len, NULL);
   if (hdr == NULL)
     {
       /* If we have no buffer left, enable RX callback. */
 
       virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RXQ(queue)], flags);
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
   else
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RXQ(queue)], flags);
     }
 
+  priv->rxnum[queue]--;
+
   /* Set the received pkt length */
 
   netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* A packet with a partial checksum comes from the other side of the
+   * virtqueue.  Complete its checksum, since it may be forwarded or seen
+   * by packet sockets.
+   */
+
+  if ((hdr->vhdr.flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) != 0)
+    {
+      if (virtio_net_rxcsum(dev, hdr->pkt, &hdr->vhdr))
+        {
+          netpkt_set_csum_valid(hdr->pkt);
+        }
+    }
+  else if ((hdr->vhdr.flags & VIRTIO_NET_HDR_F_DATA_VALID) != 0)
+    {
+      netpkt_set_csum_valid(hdr->pkt);
+    }
+#endif
   vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
   return hdr->pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recv_queue(dev, 0);
+}
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -535,7 +814,16 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 vq->vq_queue_index / 2);
+      return;
+    }
+#endif
+
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
 }
 
@@ -547,10 +835,84 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_txdone_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                vq->vq_queue_index / 2);
+      return;
+    }
+#endif
+
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_pairs
+ *
+ * Description:
+ *   Tell the device how many queue pairs are used through the control
+ *   virtqueue.  This is done once at initialization, before any traffic,
+ *   so the completion is polled for, sleeping between the polls.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int virtio_net_set_pairs(FAR struct virtio_net_priv_s *priv,
+                                FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_ctrl_s *ctrl;
+  struct virtqueue_buf vb[3];
+  int timeout = VIRTIO_NET_CTRL_TIMEOUT_MS;
+  int ret;
+
+  ctrl = virtio_zalloc_buf(priv->vdev, sizeof(*ctrl), 16);
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = priv->npairs;
+  ctrl->ack   = ~VIRTIO_NET_OK;
+
+  vb[0].buf = &ctrl->class;
+  vb[0].len = 2;
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  virtqueue_kick(vq);
+  while (virtqueue_get_buffer(vq, NULL, NULL) == NULL)
+    {
+      if (timeout-- <= 0)
+        {
+          /* The device still owns the buffer, it can not be freed */
+
+          vrterr("Control command timed out\n");
+          return -ETIMEDOUT;
+        }
+
+      nxsig_usleep(1000);
+    }
+
+  ret = ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+
+out:
+  virtio_free_buf(priv->vdev, ctrl);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -558,12 +920,18 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  uint16_t maxpairs = 1;
+  int nvqs = 2;
   int ret;
+  int i;
+
+  for (i = 0; i < VIRTIO_NET_NUM; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
   priv->vdev = vdev;
   vdev->priv = priv;
 
@@ -571,15 +939,49 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+                                  (1UL << VIRTIO_F_ANY_LAYOUT) |
+                                  VIRTIO_NET_FEATURES |
+                                  VIRTIO_NET_MQ_FEATURES, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  /* The control virtqueue follows the RX and TX virtqueues of all the
+   * queue pairs of the device, even the ones that are not used.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      maxpairs = MAX(maxpairs, 1);
+      nvqs = 2 * maxpairs + 1;
+    }
+
+  priv->npairs = MIN(maxpairs, VIRTIO_NET_MAX_PAIRS);
+
+  vqnames = kmm_malloc(nvqs * (sizeof(*vqnames) + sizeof(*callbacks)));
+  if (vqnames == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  callbacks = (FAR vq_callback *)(vqnames + nvqs);
+  for (i = 0; i < nvqs - 1; i += 2)
+    {
+      vqnames[VIRTIO_NET_RX + i]   = "virtio_net_rx";
+      vqnames[VIRTIO_NET_TX + i]   = "virtio_net_tx";
+      callbacks[VIRTIO_NET_RX + i] = virtio_net_rxready;
+      callbacks[VIRTIO_NET_TX + i] = virtio_net_txdone;
+    }
+
+  if (i < nvqs)
+    {
+      vqnames[i]   = "virtio_net_ctrl";
+      callbacks[i] = NULL;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
+  kmm_free(vqnames);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -588,6 +990,18 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      ret = virtio_net_set_pairs(priv, vdev->vrings_info[nvqs - 1].vq);
+      if (ret < 0)
+        {
+          vrtwarn("Set %d queue pairs failed, ret=%d\n", priv->npairs, ret);
+          priv->npairs = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
@@ -601,6 +1015,23 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+  /* A TCP segment sent with TSO takes up to VIRTIO_NET_TX_NIOB + 1
+   * descriptors, make sure the TX virtqueue can hold them all.
+   */
+
+  priv->txbufnum = priv->bufnum;
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4) ||
+      virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6))
+    {
+      priv->txbufnum =
+        MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
+            (VIRTIO_NET_TX_NIOB + 1), priv->bufnum);
+      priv->txbufnum = MAX(priv->txbufnum, 1);
+    }
+#endif
+
   return OK;
 }
 
@@ -641,6 +1072,39 @@ static void virtio_net_set_macaddr(FAR struct virtio_net_priv_s *priv)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_features
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void virtio_net_set_features(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct net_driver_s *dev =
+                   &((FAR struct netdev_lowerhalf_s *)&priv->lower)->netdev;
+  FAR struct virtio_device *vdev = priv->vdev;
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      dev->d_features |= NETDEV_FEATURE_TXCSUM;
+
+      /* TSO needs the device to complete the checksums as well, and all
+       * the IP versions in use since the feature is per device.
+       */
+
+      if (VIRTIO_NET_HAS_TSO(vdev))
+        {
+          dev->d_features |= NETDEV_FEATURE_TSO;
+          dev->d_gsomax    = VIRTIO_NET_GSO_MAXSIZE;
+        }
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      dev->d_features |= NETDEV_FEATURE_RXCSUM;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_probe
  ****************************************************************************/
@@ -669,8 +1133,11 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
   netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_TX] = priv->txbufnum;
   netdev->ops = &g_virtio_net_ops;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  netdev->nqueues = priv->npairs;
+#endif
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
@@ -709,6 +1176,9 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
     }
 
   virtio_net_set_macaddr(priv);
+#ifdef CONFIG_NETDEV_OFFLOAD
+  virtio_net_set_features(priv);
+#endif
 
   return ret;
 
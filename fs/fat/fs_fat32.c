@@ -744,6 +744,80 @@ out:
   return 0;
 }
 
+/****************************************************************************
+ * Name: fat_contigsectors
+ *
+ * Description:
+ *   Find how many of the next sectors of the file, starting at the current
+ *   sector, are contiguous on the media.  The run continues in the
+ *   following clusters of the chain as long as each of them is the cluster
+ *   that follows the previous one on the media.
+ *
+ * Input Parameters:
+ *   fs       - The mountpoint
+ *   ff       - The file, positioned by fat_get_sectors()
+ *   nsectors - The maximum number of sectors wanted
+ *   cluster  - Location to return the cluster that holds the last sector
+ *
+ * Returned Value:
+ *   The number of contiguous sectors, at most nsectors, or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static int fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                             FAR struct fat_file_s *ff,
+                             unsigned int nsectors, FAR uint32_t *cluster)
+{
+  unsigned int ncontig = ff->ff_sectorsincluster;
+  off_t next;
+
+  *cluster = ff->ff_currentcluster;
+  while (ncontig < nsectors)
+    {
+      next = fat_getcluster(fs, *cluster);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next != *cluster + 1)
+        {
+          break;
+        }
+
+      *cluster = next;
+      ncontig += fs->fs_fatsecperclus;
+    }
+
+  return ncontig < nsectors ? ncontig : nsectors;
+}
+
+/****************************************************************************
+ * Name: fat_advancesectors
+ *
+ * Description:
+ *   Advance the file past nsectors contiguous sectors transferred from the
+ *   current sector, the last one lying in the cluster returned by
+ *   fat_contigsectors().
+ *
+ ****************************************************************************/
+
+static void fat_advancesectors(FAR struct fat_mountpt_s *fs,
+                               FAR struct fat_file_s *ff,
+                               unsigned int nsectors, uint32_t cluster)
+{
+  uint32_t nclusters = cluster - ff->ff_currentcluster;
+
+  ff->ff_sectorsincluster  = ff->ff_sectorsincluster +
+                             nclusters * fs->fs_fatsecperclus - nsectors;
+  ff->ff_currentsector    += nsectors;
+  ff->ff_currentcluster    = cluster;
+  ff->ff_pos              += (off_t)nclusters * fs->fs_fatsecperclus *
+                             fs->fs_hwsectorsize;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_read
  ****************************************************************************/
@@ -763,6 +837,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  uint32_t cluster;
   bool force_indirect = false;
 #endif
 
@@ -869,14 +944,18 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in the clusters that follow it on the
+           * media.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_contigsectors(fs, ff, nsectors, &cluster);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              goto errout_with_lock;
             }
 
+          nsectors = ret;
+
           /* We are not sure of the state of the file buffer so
            * the safest thing to do is just invalidate it
            */
@@ -909,9 +988,8 @@ fat_read_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_advancesectors(fs, ff, nsectors, cluster);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -983,6 +1061,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  uint32_t cluster;
   bool force_indirect = false;
 #endif
 
@@ -1067,14 +1146,18 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in the clusters that follow it on the
+           * media.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_contigsectors(fs, ff, nsectors, &cluster);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              goto errout_with_lock;
             }
 
+          nsectors = ret;
+
           /* We are not sure of the state of the sector cache so the
            * safest thing to do is write back any dirty, cached sector
            * and invalidate the current cache content.
@@ -1108,10 +1191,9 @@ fat_write_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          writesize                = nsectors * fs->fs_hwsectorsize;
-          ff->ff_bflags           |= FFBUFF_MODIFIED;
+          fat_advancesectors(fs, ff, nsectors, cluster);
+          writesize      = nsectors * fs->fs_hwsectorsize;
+          ff->ff_bflags |= FFBUFF_MODIFIED;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -2358,6 +2440,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_SECTOR_CACHE
+  fat_seccachefree(fs);
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
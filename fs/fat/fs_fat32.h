@@ -862,6 +862,16 @@
  * is mounted with a fat32 filesystem.
  */
 
+#ifdef CONFIG_FAT_SECTOR_CACHE
+/* This structure describes one sector of the mountpoint sector cache */
+
+struct fat_cachesector_s
+{
+  off_t    cs_sector;              /* The sector number, -1 if unused */
+  uint32_t cs_stamp;               /* Stamp of the last access */
+};
+#endif
+
 struct fat_file_s;
 struct fat_mountpt_s
 {
@@ -891,6 +901,11 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_SECTOR_CACHE
+  uint8_t *fs_cachebuffer;         /* Sectors of the sector cache */
+  uint32_t fs_cachestamp;          /* Stamp of the last cache access */
+  struct fat_cachesector_s fs_cache[CONFIG_FAT_SECTOR_CACHE_NSECTORS];
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -1099,6 +1114,10 @@ EXTERN int    fat_ffcacheread(FAR struct fat_mountpt_s *fs,
                               FAR struct fat_file_s *ff, off_t sector);
 EXTERN int    fat_ffcacheinvalidate(FAR struct fat_mountpt_s *fs,
                                     FAR struct fat_file_s *ff);
+#ifdef CONFIG_FAT_SECTOR_CACHE
+EXTERN int    fat_seccachealloc(FAR struct fat_mountpt_s *fs);
+EXTERN void   fat_seccachefree(FAR struct fat_mountpt_s *fs);
+#endif
 
 /* FSINFO sector support */
 
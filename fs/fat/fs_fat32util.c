@@ -265,6 +265,131 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+#ifdef CONFIG_FAT_SECTOR_CACHE
+/****************************************************************************
+ * Name: fat_seccachefind
+ *
+ * Description:
+ *   Return the index of the cached copy of a sector, or -1 if the sector is
+ *   not cached.
+ *
+ ****************************************************************************/
+
+static int fat_seccachefind(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTOR_CACHE_NSECTORS; i++)
+    {
+      if (fs->fs_cache[i].cs_sector == sector)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: fat_seccacheget
+ *
+ * Description:
+ *   Copy a cached sector into the sector buffer.
+ *
+ * Returned Value:
+ *   True if the sector was cached, false otherwise.
+ *
+ ****************************************************************************/
+
+static bool fat_seccacheget(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  if (fs->fs_cachebuffer == NULL || (i = fat_seccachefind(fs, sector)) < 0)
+    {
+      return false;
+    }
+
+  memcpy(fs->fs_buffer, &fs->fs_cachebuffer[i * fs->fs_hwsectorsize],
+         fs->fs_hwsectorsize);
+  fs->fs_cache[i].cs_stamp = ++fs->fs_cachestamp;
+  return true;
+}
+
+/****************************************************************************
+ * Name: fat_seccacheput
+ *
+ * Description:
+ *   Remember the content of the sector buffer, which must be identical to
+ *   the sector on the media.  The least recently used sector is replaced
+ *   if the sector is not cached yet.
+ *
+ ****************************************************************************/
+
+static void fat_seccacheput(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  uint32_t age;
+  uint32_t maxage = 0;
+  int victim = 0;
+  int i;
+
+  if (fs->fs_cachebuffer == NULL)
+    {
+      return;
+    }
+
+  i = fat_seccachefind(fs, sector);
+  if (i < 0)
+    {
+      for (i = 0; i < CONFIG_FAT_SECTOR_CACHE_NSECTORS; i++)
+        {
+          if (fs->fs_cache[i].cs_sector < 0)
+            {
+              victim = i;
+              break;
+            }
+
+          age = fs->fs_cachestamp - fs->fs_cache[i].cs_stamp;
+          if (age >= maxage)
+            {
+              maxage = age;
+              victim = i;
+            }
+        }
+
+      i = victim;
+    }
+
+  memcpy(&fs->fs_cachebuffer[i * fs->fs_hwsectorsize], fs->fs_buffer,
+         fs->fs_hwsectorsize);
+  fs->fs_cache[i].cs_sector = sector;
+  fs->fs_cache[i].cs_stamp  = ++fs->fs_cachestamp;
+}
+
+/****************************************************************************
+ * Name: fat_seccacheinvalidate
+ *
+ * Description:
+ *   Forget the cached copies of a range of sectors that are written to.
+ *
+ ****************************************************************************/
+
+static void fat_seccacheinvalidate(FAR struct fat_mountpt_s *fs,
+                                   off_t sector, unsigned int nsectors)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTOR_CACHE_NSECTORS; i++)
+    {
+      if (fs->fs_cache[i].cs_sector >= sector &&
+          fs->fs_cache[i].cs_sector < sector + nsectors)
+        {
+          fs->fs_cache[i].cs_sector = -1;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -515,6 +640,14 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#ifdef CONFIG_FAT_SECTOR_CACHE
+  ret = fat_seccachealloc(fs);
+  if (ret < 0)
+    {
+      goto errout_with_buffer;
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -653,6 +786,9 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_SECTOR_CACHE
+  fat_seccachefree(fs);
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -754,6 +890,13 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
   if (fs && fs->fs_blkdriver)
     {
       struct inode *inode = fs->fs_blkdriver;
+
+#ifdef CONFIG_FAT_SECTOR_CACHE
+      /* The cached copies of these sectors become stale */
+
+      fat_seccacheinvalidate(fs, sector, nsectors);
+#endif
+
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
           ssize_t nsectorswritten =
@@ -1216,9 +1359,26 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
           return startsector;
         }
 
-      /* Okay.. it checks out */
+      /* Okay.. it checks out.  Keep the chain contiguous if the cluster
+       * that follows it is free.  Otherwise, resume the search where the
+       * last allocation left off instead of scanning again all of the used
+       * clusters that follow this one.
+       */
 
       startcluster = cluster;
+      if (cluster + 1 < fs->fs_nclusters + 2)
+        {
+          startsector = fat_getcluster(fs, cluster + 1);
+          if (startsector < 0)
+            {
+              return startsector;
+            }
+          else if (startsector != 0 && fs->fs_fsinextfree >= 2 &&
+                   fs->fs_fsinextfree < fs->fs_nclusters + 2)
+            {
+              startcluster = fs->fs_fsinextfree;
+            }
+        }
     }
 
   /* Loop until (1) we discover that there are not free clusters
@@ -1771,6 +1931,10 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 
   if (fs->fs_dirty)
     {
+#ifdef CONFIG_FAT_SECTOR_CACHE
+      off_t sector = fs->fs_currentsector;
+#endif
+
       /* Write the dirty sector */
 
       ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
@@ -1802,6 +1966,12 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
       /* No longer dirty */
 
       fs->fs_dirty = false;
+
+#ifdef CONFIG_FAT_SECTOR_CACHE
+      /* The sector buffer now matches the media */
+
+      fat_seccacheput(fs, sector);
+#endif
     }
 
   return OK;
@@ -1837,6 +2007,22 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
           return ret;
         }
 
+#ifdef CONFIG_FAT_SECTOR_CACHE
+      /* Then copy the specified sector from the sector cache or read it
+       * into the buffer and cache it.
+       */
+
+      if (!fat_seccacheget(fs, sector))
+        {
+          ret = fat_hwread(fs, fs->fs_buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          fat_seccacheput(fs, sector);
+        }
+#else
       /* Then read the specified sector into the cache */
 
       ret = fat_hwread(fs, fs->fs_buffer, sector, 1);
@@ -1844,6 +2030,7 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
         {
           return ret;
         }
+#endif
 
       /* Update the cached sector number */
 
@@ -1970,6 +2157,56 @@ int fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff)
   return OK;
 }
 
+#ifdef CONFIG_FAT_SECTOR_CACHE
+/****************************************************************************
+ * Name: fat_seccachealloc
+ *
+ * Description:
+ *   Allocate the sector cache of the mountpoint.  The hardware sector size
+ *   must be known.
+ *
+ ****************************************************************************/
+
+int fat_seccachealloc(struct fat_mountpt_s *fs)
+{
+  int i;
+
+  fs->fs_cachebuffer = (FAR uint8_t *)
+    fat_io_alloc(CONFIG_FAT_SECTOR_CACHE_NSECTORS * fs->fs_hwsectorsize);
+  if (fs->fs_cachebuffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_FAT_SECTOR_CACHE_NSECTORS; i++)
+    {
+      fs->fs_cache[i].cs_sector = -1;
+      fs->fs_cache[i].cs_stamp  = 0;
+    }
+
+  fs->fs_cachestamp = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_seccachefree
+ *
+ * Description:
+ *   Free the sector cache of the mountpoint
+ *
+ ****************************************************************************/
+
+void fat_seccachefree(struct fat_mountpt_s *fs)
+{
+  if (fs->fs_cachebuffer != NULL)
+    {
+      fat_io_free(fs->fs_cachebuffer,
+                  CONFIG_FAT_SECTOR_CACHE_NSECTORS * fs->fs_hwsectorsize);
+      fs->fs_cachebuffer = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_updatefsinfo
  *
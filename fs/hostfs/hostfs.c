@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/mman.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -55,6 +56,12 @@
 
 #define HOSTFS_RETRY_DELAY_MS       10
 
+/* The host files can be mapped directly by the simulator on POSIX hosts */
+
+#if defined(CONFIG_ARCH_SIM) && !defined(CONFIG_HOST_WINDOWS)
+#  define HOSTFS_HAVE_MMAP 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -80,6 +87,10 @@ static off_t   hostfs_seek(FAR struct file *filep, off_t offset,
                            int whence);
 static int     hostfs_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef HOSTFS_HAVE_MMAP
+static int     hostfs_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 
 static int     hostfs_sync(FAR struct file *filep);
 static int     hostfs_dup(FAR const struct file *oldp,
@@ -147,7 +158,11 @@ const struct mountpt_operations g_hostfs_operations =
   hostfs_write,         /* write */
   hostfs_seek,          /* seek */
   hostfs_ioctl,         /* ioctl */
+#ifdef HOSTFS_HAVE_MMAP
+  hostfs_mmap,          /* mmap */
+#else
   NULL,                 /* mmap */
+#endif
   hostfs_ftruncate,     /* ftruncate */
   NULL,                 /* poll */
   NULL,                 /* readv */
@@ -636,6 +651,101 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: hostfs_unmap
+ ****************************************************************************/
+
+#ifdef HOSTFS_HAVE_MMAP
+static int hostfs_unmap(FAR struct task_group_s *group,
+                        FAR struct mm_map_entry_s *entry,
+                        FAR void *start, size_t length)
+{
+  off_t offset;
+  int ret;
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  /* Are we unmapping the entire region (offset == 0)? */
+
+  if (offset == 0)
+    {
+      /* The length of the host mapping is kept in priv, entry->length
+       * may have been shrunk by a partial unmap.
+       */
+
+      ret = host_munmap(entry->vaddr, (size_t)(uintptr_t)entry->priv.p);
+      if (ret >= 0)
+        {
+          ret = mm_map_remove(get_group_mm(group), entry);
+        }
+    }
+
+  /* No.. The host mapping is kept whole until it is unmapped entirely */
+
+  else
+    {
+      entry->length = offset;
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_mmap
+ *
+ * Description:
+ *   Map the host file directly into memory, instead of letting the region
+ *   be copied to RAM.  The shared mappings of a file are then coherent with
+ *   each other and with the file itself.
+ *
+ ****************************************************************************/
+
+static int hostfs_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct hostfs_ofile_s *hf;
+  int ret;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  hf = filep->f_priv;
+
+  ret = nxmutex_lock(&g_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  map->vaddr = host_mmap(hf->fd, map->offset, map->length,
+                         (map->prot & PROT_WRITE) != 0,
+                         (map->flags & MAP_SHARED) != 0);
+  nxmutex_unlock(&g_lock);
+
+  if (map->vaddr == NULL)
+    {
+      /* Let the region be copied to RAM then */
+
+      return -ENOTTY;
+    }
+
+  map->priv.p  = (FAR void *)(uintptr_t)map->length;
+  map->munmap  = hostfs_unmap;
+  ret = mm_map_add(get_current_mm(), map);
+  if (ret < 0)
+    {
+      host_munmap(map->vaddr, map->length);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_sync
  *
@@ -0,0 +1,235 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/spinlock.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_CACHE_MASK   (CONFIG_FS_INODE_CACHE_SIZE - 1)
+
+#if (CONFIG_FS_INODE_CACHE_SIZE & INODE_CACHE_MASK) != 0
+#  error CONFIG_FS_INODE_CACHE_SIZE must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The result of the search of one path.  The remaining path and the
+ * relative path are kept as offsets into the path.  The entry is only
+ * valid while its generation is the current one.
+ */
+
+struct inode_cache_s
+{
+  FAR struct inode *node;
+  FAR struct inode *peer;
+  FAR struct inode *parent;
+  uint32_t          gen;
+  int16_t           result;
+  uint16_t          pathoff;
+  int16_t           reloff;   /* -1: relpath is NULL */
+  char              path[CONFIG_FS_INODE_CACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_SIZE];
+static spinlock_t g_inode_cache_lock = SP_UNLOCKED;
+
+/* The entries are zeroed, so that generation 0 is never valid */
+
+static uint32_t g_inode_cache_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_slot
+ *
+ * Description:
+ *   Return the entry of the cache where a path is stored and the length of
+ *   the path.
+ *
+ ****************************************************************************/
+
+static FAR struct inode_cache_s *inode_cache_slot(FAR const char *path,
+                                                  FAR size_t *len)
+{
+  FAR const char *ptr = path;
+  uint32_t hash = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      hash = (hash ^ (uint8_t)*ptr++) * 16777619u;
+    }
+
+  *len = ptr - path;
+  return &g_inode_cache[(hash ^ (hash >> 16)) & INODE_CACHE_MASK];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the result of a previous search of desc->path in the path
+ *   cache.  On a hit, the search descriptor is filled in as inode_search()
+ *   would.
+ *
+ * Returned Value:
+ *   True if the path was cached, with the result of its search in
+ *   'result'; false otherwise.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode_search_s *desc, FAR int *result)
+{
+  FAR const char *path = desc->path;
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  bool hit = false;
+  size_t len;
+
+  entry = inode_cache_slot(path, &len);
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN)
+    {
+      return false;
+    }
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  if (entry->gen == g_inode_cache_gen &&
+      memcmp(entry->path, path, len + 1) == 0)
+    {
+      desc->path    = path + entry->pathoff;
+      desc->node    = entry->node;
+      desc->peer    = entry->peer;
+      desc->parent  = entry->parent;
+      desc->relpath = entry->reloff < 0 ? NULL : path + entry->reloff;
+      *result       = entry->result;
+      hit           = true;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result of the search of 'path' held in the search
+ *   descriptor.  Results that do not only depend on the path and on the
+ *   inode tree (those returning paths outside of 'path') are not cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc, int result)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  size_t len;
+
+  entry = inode_cache_slot(path, &len);
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN ||
+      desc->path < path || desc->path > path + len ||
+      (desc->relpath != NULL &&
+       (desc->relpath < path || desc->relpath > path + len)))
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  memcpy(entry->path, path, len + 1);
+  entry->node    = desc->node;
+  entry->peer    = desc->peer;
+  entry->parent  = desc->parent;
+  entry->result  = result;
+  entry->pathoff = desc->path - path;
+  entry->reloff  = desc->relpath == NULL ? -1 : desc->relpath - path;
+  entry->gen     = g_inode_cache_gen;
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_flush
+ *
+ * Description:
+ *   Invalidate all of the cached paths.  This must be called whenever the
+ *   inode tree or the type of an inode in the tree changes.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing
+ *
+ ****************************************************************************/
+
+void inode_cache_flush(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  if (++g_inode_cache_gen == 0)
+    {
+      /* The generations wrapped, forget the stale entries for good */
+
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_cache_gen = 1;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
@@ -129,6 +129,8 @@ static void inode_insert(FAR struct inode *inode,
       inode->i_parent = parent;
       parent->i_child = inode;
     }
+
+  inode_cache_flush();
 }
 
 /****************************************************************************
@@ -146,6 +148,7 @@ static void inode_insert(FAR struct inode *inode,
 void inode_root_reserve(void)
 {
   g_root_inode = inode_alloc("", 0777);
+  inode_cache_flush();
 }
 
 /****************************************************************************
@@ -48,6 +48,9 @@ static int _inode_linktarget(FAR struct inode *inode,
                              FAR struct inode_search_s *desc);
 #endif
 static int _inode_search(FAR struct inode_search_s *desc);
+#ifdef CONFIG_FS_INODE_CACHE
+static int _inode_cachesearch(FAR struct inode_search_s *desc);
+#endif
 static FAR const char *_inode_getcwd(void);
 
 /****************************************************************************
@@ -415,6 +418,41 @@ static int _inode_search(FAR struct inode_search_s *desc)
   return ret;
 }
 
+/****************************************************************************
+ * Name: _inode_cachesearch
+ *
+ * Description:
+ *   Perform _inode_search(), using and updating the path lookup cache.
+ *   Searches that go through a soft link in a relative path are not
+ *   cached, the original path buffer having been released.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+static int _inode_cachesearch(FAR struct inode_search_s *desc)
+{
+  FAR const char *path = desc->path;
+  FAR char *buffer = desc->buffer;
+  int ret;
+
+  if (inode_cache_lookup(desc, &ret))
+    {
+      return ret;
+    }
+
+  ret = _inode_search(desc);
+  if ((ret == OK || ret == -ENOENT) && desc->buffer == buffer)
+    {
+      inode_cache_add(path, desc, ret);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: _inode_getcwd
  *
@@ -491,7 +529,11 @@ int inode_search(FAR struct inode_search_s *desc)
       desc->path = desc->buffer;
     }
 
+#ifdef CONFIG_FS_INODE_CACHE
+  ret = _inode_cachesearch(desc);
+#else
   ret = _inode_search(desc);
+#endif
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
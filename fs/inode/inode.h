@@ -237,6 +237,63 @@ void inode_runlock(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the result of a previous search of desc->path in the path
+ *   cache.  On a hit, the search descriptor is filled in as inode_search()
+ *   would.
+ *
+ * Returned Value:
+ *   True if the path was cached, with the result of its search in
+ *   'result'; false otherwise.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode_search_s *desc, FAR int *result);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result of the search of 'path' held in the search
+ *   descriptor.  Results that do not only depend on the path and on the
+ *   inode tree (those returning paths outside of 'path') are not cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc, int result);
+#endif
+
+/****************************************************************************
+ * Name: inode_cache_flush
+ *
+ * Description:
+ *   Invalidate all of the cached paths.  This must be called whenever the
+ *   inode tree or the type of an inode in the tree changes.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+void inode_cache_flush(void);
+#else
+#  define inode_cache_flush()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
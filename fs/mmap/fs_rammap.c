@@ -27,6 +27,8 @@
 #include <nuttx/config.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <assert.h>
 #include <debug.h>
@@ -37,6 +39,9 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/lib/lib.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
 #include <nuttx/sched.h>
 
 #include "fs_rammap.h"
@@ -44,13 +49,304 @@
 #include "fs_heap.h"
 
 /****************************************************************************
- * Public Data
+ * Pre-processor Definitions
  ****************************************************************************/
 
+/* The copies of the shared mappings can only be shared when all of the
+ * processes see the same heap.
+ */
+
+#ifndef CONFIG_BUILD_KERNEL
+#  define RAMMAP_SHARED 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef RAMMAP_SHARED
+/* The identity of a mapped file.  The path alone would match a file that
+ * was unlinked and created again, and a copy made before the file was
+ * written, so the serial number, size and modification time reported by
+ * fstat() must match too.
+ */
+
+struct rammap_file_s
+{
+  FAR struct inode  *inode;   /* Inode of the file or of its mountpoint */
+  FAR char          *path;    /* Path of the file */
+  ino_t              ino;     /* File serial number */
+  off_t              size;    /* File size */
+  struct timespec    mtime;   /* Time of last modification */
+};
+
+/* The RAM copy of a region of a file that is shared by all of the shared
+ * mappings of this region.
+ */
+
+struct rammap_region_s
+{
+  FAR struct rammap_region_s *flink;
+  struct rammap_file_s file;  /* The mapped file */
+  off_t              offset;  /* Offset of the region in the file */
+  size_t             length;  /* Length of the region */
+  FAR void          *vaddr;   /* The RAM copy of the region */
+  enum mm_map_type_e type;    /* The heap holding the copy */
+  unsigned int       crefs;   /* Number of mappings of the region */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef RAMMAP_SHARED
+static sq_queue_t g_rammap_regions;
+static mutex_t g_rammap_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rammap_share
+ *
+ * Description:
+ *   Look for the RAM copy of the region of a shared mapping that another
+ *   shared mapping holds already, and reference it.
+ *
+ * Returned Value:
+ *   True if the region was found (entry->vaddr is then set), false
+ *   otherwise.  In the latter case, the identity of the file is returned
+ *   in 'file' with a copy of its path, if the file can be identified, to
+ *   register the new region.
+ *
+ ****************************************************************************/
+
+#ifdef RAMMAP_SHARED
+static bool rammap_share(FAR struct file *filep,
+                         FAR struct mm_map_entry_s *entry,
+                         enum mm_map_type_e type,
+                         FAR struct rammap_file_s *file)
+{
+  FAR struct rammap_region_s *region;
+  FAR char *pathbuf;
+  struct stat st;
+  bool found = false;
+
+  file->path = NULL;
+  if ((entry->flags & MAP_SHARED) == 0 || file_fstat(filep, &st) < 0)
+    {
+      return false;
+    }
+
+  file->inode = filep->f_inode;
+  file->ino   = st.st_ino;
+  file->size  = st.st_size;
+  file->mtime = st.st_mtim;
+
+  pathbuf = lib_get_pathbuffer();
+  if (pathbuf == NULL)
+    {
+      return false;
+    }
+
+  if (file_ioctl(filep, FIOC_FILEPATH, (unsigned long)pathbuf) < 0)
+    {
+      lib_put_pathbuffer(pathbuf);
+      return false;
+    }
+
+  nxmutex_lock(&g_rammap_lock);
+
+  for (region = (FAR struct rammap_region_s *)g_rammap_regions.head;
+       region != NULL; region = region->flink)
+    {
+      if (region->type == type && region->offset == entry->offset &&
+          region->length >= entry->length &&
+          region->file.inode == file->inode &&
+          region->file.ino == file->ino &&
+          region->file.size == file->size &&
+          region->file.mtime.tv_sec == file->mtime.tv_sec &&
+          region->file.mtime.tv_nsec == file->mtime.tv_nsec &&
+          strcmp(region->file.path, pathbuf) == 0)
+        {
+          region->crefs++;
+          entry->vaddr = region->vaddr;
+          found = true;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_rammap_lock);
+
+  if (!found)
+    {
+      file->path = fs_heap_strdup(pathbuf);
+    }
+
+  lib_put_pathbuffer(pathbuf);
+  return found;
+}
+
+/****************************************************************************
+ * Name: rammap_addregion
+ *
+ * Description:
+ *   Register the RAM copy of the region of a new shared mapping, so that
+ *   the next shared mappings of the region use it too.  The path of the
+ *   file is given to the region.
+ *
+ ****************************************************************************/
+
+static void rammap_addregion(FAR struct rammap_file_s *file,
+                             FAR struct mm_map_entry_s *entry,
+                             enum mm_map_type_e type)
+{
+  FAR struct rammap_region_s *region;
+
+  region = fs_heap_malloc(sizeof(struct rammap_region_s));
+  if (region == NULL)
+    {
+      /* The mapping is just not shared then */
+
+      fs_heap_free(file->path);
+      return;
+    }
+
+  region->file   = *file;
+  region->offset = entry->offset;
+  region->length = entry->length;
+  region->vaddr  = entry->vaddr;
+  region->type   = type;
+  region->crefs  = 1;
+
+  nxmutex_lock(&g_rammap_lock);
+  sq_addlast((FAR sq_entry_t *)region, &g_rammap_regions);
+  nxmutex_unlock(&g_rammap_lock);
+}
+
+/****************************************************************************
+ * Name: rammap_unshare
+ *
+ * Description:
+ *   Release the reference of a mapping on its RAM copy, if the copy is
+ *   shared.
+ *
+ * Returned Value:
+ *   True if the copy is still used by other mappings, false if it can be
+ *   freed.
+ *
+ ****************************************************************************/
+
+static bool rammap_unshare(FAR struct mm_map_entry_s *entry)
+{
+  FAR struct rammap_region_s *region;
+  bool used = false;
+
+  nxmutex_lock(&g_rammap_lock);
+
+  for (region = (FAR struct rammap_region_s *)g_rammap_regions.head;
+       region != NULL; region = region->flink)
+    {
+      if (region->vaddr == entry->vaddr)
+        {
+          if (--region->crefs > 0)
+            {
+              used = true;
+            }
+          else
+            {
+              sq_rem((FAR sq_entry_t *)region, &g_rammap_regions);
+              fs_heap_free(region->file.path);
+              fs_heap_free(region);
+            }
+
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_rammap_lock);
+  return used;
+}
+
+/****************************************************************************
+ * Name: rammap_truncate
+ *
+ * Description:
+ *   Prepare the RAM copy of a mapping to be shrunk to 'length' bytes.
+ *
+ * Returned Value:
+ *   True if the copy is used by other mappings and must be left as it is,
+ *   false if it can be shrunk.
+ *
+ ****************************************************************************/
+
+static bool rammap_truncate(FAR struct mm_map_entry_s *entry,
+                            size_t length)
+{
+  FAR struct rammap_region_s *region;
+  bool shared = false;
+
+  nxmutex_lock(&g_rammap_lock);
+
+  for (region = (FAR struct rammap_region_s *)g_rammap_regions.head;
+       region != NULL; region = region->flink)
+    {
+      if (region->vaddr == entry->vaddr)
+        {
+          shared = region->crefs > 1;
+          if (!shared)
+            {
+              region->length = length;
+            }
+
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_rammap_lock);
+  return shared;
+}
+
+/****************************************************************************
+ * Name: rammap_restamp
+ *
+ * Description:
+ *   Record the new size and modification time of a file after a mapping
+ *   wrote its RAM copy back, so that the copy is still shared.
+ *
+ ****************************************************************************/
+
+static void rammap_restamp(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *entry)
+{
+  FAR struct rammap_region_s *region;
+  struct stat st;
+
+  if (file_fstat(filep, &st) < 0)
+    {
+      return;
+    }
+
+  nxmutex_lock(&g_rammap_lock);
+
+  for (region = (FAR struct rammap_region_s *)g_rammap_regions.head;
+       region != NULL; region = region->flink)
+    {
+      if (region->vaddr == entry->vaddr)
+        {
+          region->file.size  = st.st_size;
+          region->file.mtime = st.st_mtim;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_rammap_lock);
+}
+#endif
+
 /****************************************************************************
  * Name: msync_rammap
  ****************************************************************************/
@@ -121,6 +417,13 @@ static int msync_rammap(FAR struct mm_map_entry_s *entry, FAR void *start,
       return fpos;
     }
 
+#ifdef RAMMAP_SHARED
+  if (nwrite >= 0)
+    {
+      rammap_restamp(filep, entry);
+    }
+#endif
+
   return nwrite >= 0 ? 0 : nwrite;
 }
 
@@ -164,7 +467,14 @@ static int unmap_rammap(FAR struct task_group_s *group,
 
   if (length >= entry->length)
     {
-      /* Free the region */
+      /* Free the region, unless other shared mappings still use it */
+
+#ifdef RAMMAP_SHARED
+      if (type != MAP_XIP && rammap_unshare(entry))
+        {
+          type = MAP_XIP;
+        }
+#endif
 
       if (type == MAP_KERNEL)
         {
@@ -188,18 +498,30 @@ static int unmap_rammap(FAR struct task_group_s *group,
 
   else
     {
+      /* Keep the first 'offset' bytes.  A copy that other shared mappings
+       * use is left as it is.
+       */
+
+#ifdef RAMMAP_SHARED
+      if (type != MAP_XIP && rammap_truncate(entry, offset))
+        {
+          type = MAP_XIP;
+        }
+#endif
+
+      newaddr = entry->vaddr;
       if (type == MAP_KERNEL)
         {
-          newaddr = fs_heap_realloc(entry->vaddr, length);
+          newaddr = fs_heap_realloc(entry->vaddr, offset);
         }
       else if (type == MAP_USER)
         {
-          newaddr = kumm_realloc(entry->vaddr, length);
+          newaddr = kumm_realloc(entry->vaddr, offset);
         }
 
       DEBUGASSERT(newaddr == entry->vaddr);
       entry->vaddr = newaddr;
-      entry->length = length;
+      entry->length = offset;
     }
 
   return ret;
@@ -242,34 +564,45 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
   off_t fpos;
   int ret;
   size_t length = entry->length;
+#ifdef RAMMAP_SHARED
+  struct rammap_file_s file;
+
+  file.path = NULL;
+#endif
 
   ret = file_ioctl(filep, BIOC_XIPBASE, (unsigned long)&entry->vaddr);
   if (ret == OK)
     {
+      /* The media is directly accessible at the base address */
+
+      entry->vaddr = (FAR uint8_t *)entry->vaddr + entry->offset;
       type = MAP_XIP;
       goto out;
     }
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+#ifdef RAMMAP_SHARED
+  /* A shared mapping of a file region that another shared mapping holds
+   * already uses the same copy of the region.
    */
 
-  /* Allocate a region of memory of the specified size */
+  if (rammap_share(filep, entry, type, &file))
+    {
+      goto out;
+    }
+#endif
+
+  /* Allocate a region of memory of the specified size.  Private mappings
+   * always get their own copy.
+   */
 
   rdbuffer = type == MAP_KERNEL ? fs_heap_malloc(length)
                                 : kumm_malloc(length);
   if (!rdbuffer)
     {
       ferr("ERROR: Region allocation failed, length: %zu\n", length);
+#ifdef RAMMAP_SHARED
+      fs_heap_free(file.path);
+#endif
       return -ENOMEM;
     }
 
@@ -329,6 +662,16 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
 
   memset(rdbuffer, 0, length);
 
+#ifdef RAMMAP_SHARED
+  /* Let the next shared mappings of the region use this copy */
+
+  if (file.path != NULL)
+    {
+      rammap_addregion(&file, entry, type);
+      file.path = NULL;
+    }
+#endif
+
   /* Add the buffer to the list of regions */
 
 out:
@@ -340,12 +683,21 @@ out:
   ret = mm_map_add(get_current_mm(), entry);
   if (ret < 0)
     {
+      fs_putfilep(filep);
       goto errout_with_region;
     }
 
   return OK;
 
 errout_with_region:
+#ifdef RAMMAP_SHARED
+  fs_heap_free(file.path);
+  if (type != MAP_XIP && rammap_unshare(entry))
+    {
+      return ret;
+    }
+#endif
+
   if (type == MAP_KERNEL)
     {
       fs_heap_free(entry->vaddr);
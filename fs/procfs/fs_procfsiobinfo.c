@@ -183,6 +183,10 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct iobinfo_file_s *iobfile;
   FAR struct iob_stats_s stats;
+#ifdef CONFIG_IOB_CLASSES
+  struct iob_class_stats_s cstats;
+  int i;
+#endif
   size_t linesize;
   size_t copysize;
   size_t totalsize;
@@ -223,6 +227,38 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#ifdef CONFIG_IOB_CLASSES
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  /* Then the headers and the usage statistics of the size classes */
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s%10s%10s%10s\n",
+                               "bufsize", "ntotal", "nfree", "nalloc",
+                               "nmiss");
+
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  for (i = 0; iob_getclassstats(i, &cstats) >= 0; i++)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                                   "%10u%10d%10d%10lu%10lu\n",
+                                   cstats.bufsize, cstats.ntotal,
+                                   cstats.nfree, cstats.nalloc,
+                                   cstats.nmiss);
+
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
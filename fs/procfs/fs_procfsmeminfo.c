@@ -106,6 +106,10 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
                              size_t buflen);
 #endif
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMFRAG
+static ssize_t memfrag_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+#endif
 static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static int     meminfo_dup(FAR const struct file *oldp,
@@ -153,6 +157,23 @@ const struct procfs_operations g_memdump_operations =
 };
 #endif
 
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMFRAG
+const struct procfs_operations g_memfrag_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  memfrag_read,   /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
 static FAR struct procfs_meminfo_entry_s *g_procfs_meminfo = NULL;
 
 /****************************************************************************
@@ -645,6 +666,111 @@ dump:
 }
 #endif
 
+/****************************************************************************
+ * Name: memfrag_read
+ *
+ * Description:
+ *   Show the free chunk histogram of each heap, together with a
+ *   fragmentation index: the share of the free memory that is not part of
+ *   the largest free chunk.  0% means that all free memory is contiguous.
+ *   The histogram is only allocated while reading, rather than with every
+ *   open meminfo file.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMFRAG
+static ssize_t memfrag_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+  FAR struct meminfo_file_s *procfile;
+  FAR struct mm_fraginfo_s *frag;
+  unsigned long sfree;
+  unsigned long index;
+  size_t linesize;
+  size_t copysize = 0;
+  size_t totalsize = 0;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  frag = fs_heap_malloc(sizeof(struct mm_fraginfo_s));
+  if (frag == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL && buflen > 0;
+       entry = entry->next)
+    {
+      /* Return the delayed frees first, see meminfo_read() */
+
+      mm_free_delaylist(entry->heap);
+      mm_fraginfo(entry->heap, frag);
+
+      sfree = 0;
+      for (i = 0; i < MM_FRAG_NBUCKETS; i++)
+        {
+          sfree += frag->sfree[i];
+        }
+
+      index = 0;
+      if (sfree > 0)
+        {
+          index = 100 - (unsigned long)
+                  ((uint64_t)frag->mxfree * 100 / sfree);
+        }
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%s: free %lu largest %lu frag %lu%%\n"
+                                   "%11s%11s%11s\n",
+                                   entry->name, sfree,
+                                   (unsigned long)frag->mxfree,
+                                   index, "size", "nfree", "total");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      for (i = 0; i < MM_FRAG_NBUCKETS && buflen > 0; i++)
+        {
+          if (frag->nfree[i] == 0)
+            {
+              continue;
+            }
+
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%11lu%11lu%11lu\n",
+                                       1ul << i,
+                                       (unsigned long)frag->nfree[i],
+                                       (unsigned long)frag->sfree[i]);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+          buffer    += copysize;
+          buflen    -= copysize;
+        }
+    }
+
+  fs_heap_free(frag);
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: meminfo_dup
  *
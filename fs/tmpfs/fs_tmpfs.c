@@ -96,6 +96,7 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_free_filedata(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -272,6 +273,24 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  /* Growing the file only moves its end:  the new part is a hole that
+   * reads as zero until it is written.  Shrinking it frees the pages
+   * beyond the new end.
+   */
+
+  if (newsize < tfo->tfo_size)
+    {
+      tmpfs_page_truncate(tfo, newsize);
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
@@ -345,6 +364,20 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   tfo->tfo_data  = newdata;
   return OK;
 }
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_free_filedata
+ ****************************************************************************/
+
+static void tmpfs_free_filedata(FAR struct tmpfs_file_s *tfo)
+{
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_page_truncate(tfo, 0);
+#else
+  fs_heap_free(tfo->tfo_data);
+#endif
+}
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -383,7 +416,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
       fs_heap_free(tfo);
     }
 
@@ -582,7 +615,12 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tfo->tfo_height = 0;
+  tfo->tfo_pages  = NULL;
+#else
   tfo->tfo_data   = NULL;
+#endif
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1181,7 +1219,10 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1257,7 +1298,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1578,6 +1619,10 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_page_read(tfo, (FAR uint8_t *)buffer, startpos, nread);
+  filep->f_pos += nread;
+#else
   if (tfo->tfo_data != NULL)
     {
       memcpy(buffer, &tfo->tfo_data[startpos], nread);
@@ -1587,6 +1632,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
     }
+#endif
 
   /* Release the lock on the file */
 
@@ -1634,6 +1680,25 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
       startpos = filep->f_pos;
     }
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  /* Copy data from the user buffer to the pages written, then move the end
+   * of the file past the data written.
+   */
+
+  nwritten = tmpfs_page_write(tfo, (FAR const uint8_t *)buffer,
+                              startpos, buflen);
+  if (nwritten < 0)
+    {
+      ret = nwritten;
+      goto errout_with_lock;
+    }
+
+  endpos = startpos + nwritten;
+  if (endpos > tfo->tfo_size)
+    {
+      tfo->tfo_size = endpos;
+    }
+#else
   nwritten = buflen;
   endpos   = startpos + buflen;
 
@@ -1658,6 +1723,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
     }
+#endif
 
   filep->f_pos = endpos;
 
@@ -1780,7 +1846,32 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
+#ifdef CONFIG_FS_TMPFS_PAGED
+      FAR uint8_t *page;
+
+      /* Only a range within a single page is contiguous in memory.  Let
+       * the other ones be mapped by copying them.
+       */
+
+      if (map->offset / TMPFS_PAGE_SIZE !=
+          (map->offset + map->length - 1) / TMPFS_PAGE_SIZE)
+        {
+          return -ENOTTY;
+        }
+
+      tmpfs_lock_file(tfo);
+      page = tmpfs_page_find(tfo, map->offset / TMPFS_PAGE_SIZE, true);
+      tmpfs_unlock_file(tfo);
+
+      if (page == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      map->vaddr = page + (map->offset & (TMPFS_PAGE_SIZE - 1));
+#else
       map->vaddr = tfo->tfo_data + map->offset;
+#endif
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
@@ -1834,7 +1925,32 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+      FAR uint8_t *page = NULL;
+
+      /* Only a file held in a single page is contiguous in memory */
+
+      if (tfo->tfo_size > TMPFS_PAGE_SIZE)
+        {
+          return -ENOTTY;
+        }
+
+      if (tfo->tfo_size > 0)
+        {
+          tmpfs_lock_file(tfo);
+          page = tmpfs_page_find(tfo, 0, true);
+          tmpfs_unlock_file(tfo);
+
+          if (page == NULL)
+            {
+              return -ENOMEM;
+            }
+        }
+
+      *ptr = (uintptr_t)page;
+#else
       *ptr = (uintptr_t)tfo->tfo_data;
+#endif
       return OK;
     }
 
@@ -1968,6 +2084,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
+#ifndef CONFIG_FS_TMPFS_PAGED
       /* If the size has increased, then we need to zero the newly added
        * memory.
        */
@@ -1976,6 +2093,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2418,7 +2536,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
       fs_heap_free(tfo);
     }
 
@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/fs/fs.h>
@@ -42,6 +43,12 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+/* The size of the pages holding the file data */
+
+#  define TMPFS_PAGE_SIZE   CONFIG_FS_TMPFS_PAGE_SIZE
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -128,7 +135,12 @@ struct tmpfs_file_s
 
   uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
   size_t        tfo_size;  /* Valid file size */
+#ifdef CONFIG_FS_TMPFS_PAGED
+  uint8_t       tfo_height; /* Height of the radix tree of pages */
+  FAR void     *tfo_pages; /* Root of the radix tree of pages */
+#else
   FAR uint8_t  *tfo_data;  /* File data starts here */
+#endif
 };
 
 /* This structure represents one instance of a TMPFS file system */
@@ -177,6 +189,21 @@ EXTERN const struct mountpt_operations g_tmpfs_operations;
  * Public Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+/* Page storage of the file data (fs_tmpfspage.c).  The caller holds the
+ * file lock.
+ */
+
+FAR uint8_t *tmpfs_page_find(FAR struct tmpfs_file_s *tfo, size_t pgno,
+                             bool alloc);
+void tmpfs_page_truncate(FAR struct tmpfs_file_s *tfo, size_t size);
+void tmpfs_page_read(FAR struct tmpfs_file_s *tfo, FAR uint8_t *buffer,
+                     size_t pos, size_t len);
+ssize_t tmpfs_page_write(FAR struct tmpfs_file_s *tfo,
+                         FAR const uint8_t *buffer, size_t pos,
+                         size_t len);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,360 @@
+/****************************************************************************
+ * fs/tmpfs/fs_tmpfspage.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include "fs_tmpfs.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (TMPFS_PAGE_SIZE & (TMPFS_PAGE_SIZE - 1)) != 0
+#  error CONFIG_FS_TMPFS_PAGE_SIZE must be a power of two
+#endif
+
+#if TMPFS_PAGE_SIZE < 64
+#  error CONFIG_FS_TMPFS_PAGE_SIZE must be at least 64
+#endif
+
+/* Each node of the radix tree indexes TMPFS_RADIX_SLOTS pages or nodes of
+ * the level below.  A tree of height 0 is a single page.
+ */
+
+#define TMPFS_RADIX_SHIFT   4
+#define TMPFS_RADIX_SLOTS   (1 << TMPFS_RADIX_SHIFT)
+#define TMPFS_RADIX_MASK    (TMPFS_RADIX_SLOTS - 1)
+
+/* The number of pages covered by a tree of the given height */
+
+#define TMPFS_RADIX_SPAN(h) ((size_t)1 << (TMPFS_RADIX_SHIFT * (h)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tmpfs_radix_s
+{
+  FAR void *tr_slots[TMPFS_RADIX_SLOTS];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tmpfs_page_prune
+ *
+ * Description:
+ *   Free the pages numbered 'first' and above in the sub-tree of the given
+ *   height in 'slot', which covers the pages from 'base'.  The nodes left
+ *   without any page are freed too.
+ *
+ ****************************************************************************/
+
+static void tmpfs_page_prune(FAR struct tmpfs_file_s *tfo, FAR void **slot,
+                             unsigned int height, size_t base, size_t first)
+{
+  FAR struct tmpfs_radix_s *node;
+  size_t span;
+  int i;
+
+  if (*slot == NULL || (base < first && first - base >=
+                        TMPFS_RADIX_SPAN(height)))
+    {
+      return;
+    }
+
+  if (height == 0)
+    {
+      fs_heap_free(*slot);
+      tfo->tfo_alloc -= TMPFS_PAGE_SIZE;
+      *slot = NULL;
+      return;
+    }
+
+  node = *slot;
+  span = TMPFS_RADIX_SPAN(height - 1);
+
+  for (i = 0; i < TMPFS_RADIX_SLOTS; i++)
+    {
+      tmpfs_page_prune(tfo, &node->tr_slots[i], height - 1,
+                       base + i * span, first);
+    }
+
+  if (base >= first)
+    {
+      fs_heap_free(node);
+      tfo->tfo_alloc -= sizeof(struct tmpfs_radix_s);
+      *slot = NULL;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tmpfs_page_find
+ *
+ * Description:
+ *   Return the page of the file with the given number.  If the page is not
+ *   allocated yet (a hole), a zeroed page is allocated if 'alloc' is true
+ *   and NULL is returned otherwise.
+ *
+ * Returned Value:
+ *   The page or NULL if it is not allocated and 'alloc' is false, or if
+ *   the memory is exhausted.
+ *
+ ****************************************************************************/
+
+FAR uint8_t *tmpfs_page_find(FAR struct tmpfs_file_s *tfo, size_t pgno,
+                             bool alloc)
+{
+  FAR struct tmpfs_radix_s *node;
+  FAR void **slot;
+  unsigned int height;
+
+  /* Grow the tree until it covers the page */
+
+  while (pgno >= TMPFS_RADIX_SPAN(tfo->tfo_height))
+    {
+      if (!alloc)
+        {
+          return NULL;
+        }
+
+      if (tfo->tfo_pages != NULL)
+        {
+          node = fs_heap_zalloc(sizeof(struct tmpfs_radix_s));
+          if (node == NULL)
+            {
+              return NULL;
+            }
+
+          node->tr_slots[0] = tfo->tfo_pages;
+          tfo->tfo_pages    = node;
+          tfo->tfo_alloc   += sizeof(struct tmpfs_radix_s);
+        }
+
+      tfo->tfo_height++;
+    }
+
+  /* Then walk down to the page, allocating the missing nodes */
+
+  slot = &tfo->tfo_pages;
+  for (height = tfo->tfo_height; height > 0; height--)
+    {
+      if (*slot == NULL)
+        {
+          if (!alloc)
+            {
+              return NULL;
+            }
+
+          *slot = fs_heap_zalloc(sizeof(struct tmpfs_radix_s));
+          if (*slot == NULL)
+            {
+              return NULL;
+            }
+
+          tfo->tfo_alloc += sizeof(struct tmpfs_radix_s);
+        }
+
+      node = *slot;
+      slot = &node->tr_slots[(pgno >> (TMPFS_RADIX_SHIFT * (height - 1))) &
+                             TMPFS_RADIX_MASK];
+    }
+
+  if (*slot == NULL && alloc)
+    {
+      *slot = fs_heap_zalloc(TMPFS_PAGE_SIZE);
+      if (*slot != NULL)
+        {
+          tfo->tfo_alloc += TMPFS_PAGE_SIZE;
+        }
+    }
+
+  return *slot;
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_truncate
+ *
+ * Description:
+ *   Free the pages that lie entirely beyond 'size' bytes and zero the rest
+ *   of the page holding the end of the file, so that the bytes beyond the
+ *   end of the file always read as zero.  The file size is not changed.
+ *
+ ****************************************************************************/
+
+void tmpfs_page_truncate(FAR struct tmpfs_file_s *tfo, size_t size)
+{
+  FAR struct tmpfs_radix_s *node;
+  FAR uint8_t *page;
+  size_t offset;
+  int i;
+
+  tmpfs_page_prune(tfo, &tfo->tfo_pages, tfo->tfo_height, 0,
+                   (size + TMPFS_PAGE_SIZE - 1) / TMPFS_PAGE_SIZE);
+
+  /* Lower the tree while only its first slot is used */
+
+  while (tfo->tfo_height > 0)
+    {
+      node = tfo->tfo_pages;
+      if (node != NULL)
+        {
+          for (i = 1; i < TMPFS_RADIX_SLOTS; i++)
+            {
+              if (node->tr_slots[i] != NULL)
+                {
+                  break;
+                }
+            }
+
+          if (i < TMPFS_RADIX_SLOTS)
+            {
+              break;
+            }
+
+          tfo->tfo_pages  = node->tr_slots[0];
+          tfo->tfo_alloc -= sizeof(struct tmpfs_radix_s);
+          fs_heap_free(node);
+        }
+
+      tfo->tfo_height--;
+    }
+
+  offset = size & (TMPFS_PAGE_SIZE - 1);
+  if (offset != 0)
+    {
+      page = tmpfs_page_find(tfo, size / TMPFS_PAGE_SIZE, false);
+      if (page != NULL)
+        {
+          memset(page + offset, 0, TMPFS_PAGE_SIZE - offset);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_read
+ *
+ * Description:
+ *   Copy file data to a buffer.  The holes of the file read as zero.
+ *
+ ****************************************************************************/
+
+void tmpfs_page_read(FAR struct tmpfs_file_s *tfo, FAR uint8_t *buffer,
+                     size_t pos, size_t len)
+{
+  FAR uint8_t *page;
+  size_t offset;
+  size_t nbytes;
+
+  while (len > 0)
+    {
+      offset = pos & (TMPFS_PAGE_SIZE - 1);
+      nbytes = TMPFS_PAGE_SIZE - offset;
+      if (nbytes > len)
+        {
+          nbytes = len;
+        }
+
+      page = tmpfs_page_find(tfo, pos / TMPFS_PAGE_SIZE, false);
+      if (page != NULL)
+        {
+          memcpy(buffer, page + offset, nbytes);
+        }
+      else
+        {
+          memset(buffer, 0, nbytes);
+        }
+
+      buffer += nbytes;
+      pos    += nbytes;
+      len    -= nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_write
+ *
+ * Description:
+ *   Copy data from a buffer to the file, allocating the pages written as
+ *   needed.  The file size is not changed.
+ *
+ * Returned Value:
+ *   The number of bytes written, which is less than 'len' if the memory
+ *   was exhausted, or -ENOMEM if nothing could be written.
+ *
+ ****************************************************************************/
+
+ssize_t tmpfs_page_write(FAR struct tmpfs_file_s *tfo,
+                         FAR const uint8_t *buffer, size_t pos,
+                         size_t len)
+{
+  FAR uint8_t *page;
+  size_t nwritten = 0;
+  size_t offset;
+  size_t nbytes;
+
+  while (nwritten < len)
+    {
+      page = tmpfs_page_find(tfo, pos / TMPFS_PAGE_SIZE, true);
+      if (page == NULL)
+        {
+          return nwritten > 0 ? (ssize_t)nwritten : -ENOMEM;
+        }
+
+      offset = pos & (TMPFS_PAGE_SIZE - 1);
+      nbytes = TMPFS_PAGE_SIZE - offset;
+      if (nbytes > len - nwritten)
+        {
+          nbytes = len - nwritten;
+        }
+
+      memcpy(page + offset, buffer, nbytes);
+
+      buffer   += nbytes;
+      pos      += nbytes;
+      nwritten += nbytes;
+    }
+
+  return nwritten;
+}
+
+#endif /* CONFIG_FS_TMPFS_PAGED */
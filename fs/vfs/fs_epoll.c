@@ -36,12 +36,14 @@
 #include <debug.h>
 
 #include <nuttx/nuttx.h>
+#include <nuttx/atomic.h>
 #include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -53,6 +55,7 @@
 struct epoll_node_s
 {
   struct list_node         node;
+  struct list_node         rnode;    /* Node in the ready list */
   epoll_data_t             data;
   bool                     notified;
   struct pollfd            pfd;
@@ -67,6 +70,14 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
+  spinlock_t            rlock;    /* Protects the ready list, which is also
+                                   * accessed from the poll callback.
+                                   */
+  struct list_node      ready;    /* The ready list, store all the setuped
+                                   * epoll node notified since the last
+                                   * epoll_wait, so epoll_wait costs no more
+                                   * than the number of ready fds.
+                                   */
   struct list_node      setup;    /* The setup list, store all the setuped
                                    * epoll node.
                                    */
@@ -237,12 +248,14 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_lock_init(&eph->rlock);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
   list_initialize(&eph->setup);
+  list_initialize(&eph->ready);
   list_initialize(&eph->teardown);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
@@ -318,12 +331,57 @@ static int epoll_setup(FAR epoll_head_t *eph)
   return ret;
 }
 
+/****************************************************************************
+ * Name: epoll_post
+ *
+ * Description:
+ *   Wake up the epoll_wait() caller, if it is not already awakened.
+ *
+ ****************************************************************************/
+
+static void epoll_post(FAR epoll_head_t *eph)
+{
+  int semcount = 0;
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove a setuped epoll node from the ready list, if it is queued there.
+ *   Called before the node is teardown or setup again.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (list_in_list(&epn->rnode))
+    {
+      list_delete(&epn->rnode);
+      list_clear_node(&epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+}
+
 /****************************************************************************
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notifed fd and check the notified fd's event with user
- *   expected event.
+ *   Consume the ready list and check the notified fd's event with user
+ *   expected event.  Level-triggered fds are teardown and setup again by
+ *   the next epoll_wait() to check the pending poll notification, while
+ *   edge-triggered (EPOLLET) fds stay setuped and are only reported again
+ *   on a new notification.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -339,31 +397,57 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
+  bool edge;
+  bool more;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      /* Only check the notifed fd */
-
-      if (!epn->notified)
+      flags = spin_lock_irqsave(&eph->rlock);
+      if (list_is_empty(&eph->ready))
         {
-          continue;
+          spin_unlock_irqrestore(&eph->rlock, flags);
+          break;
         }
 
-      /* Teradown all the notified fd */
+      epn = list_first_entry(&eph->ready, epoll_node_t, rnode);
+      list_delete(&epn->rnode);
+      list_clear_node(&epn->rnode);
 
-      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-      list_delete(&epn->node);
+      edge = (epn->pfd.events & (EPOLLET | EPOLLONESHOT)) == EPOLLET;
+      if (edge)
+        {
+          /* Stay setuped and rearm for the next edge.  The events are
+           * consumed atomically: anything poll_notify() adds after this
+           * point is seen by epoll_default_cb() and queues the node again.
+           */
+
+          revents = atomic_exchange((FAR atomic_uint *)&epn->pfd.revents,
+                                    0);
+          epn->notified = false;
+        }
+      else
+        {
+          revents = atomic_load((FAR atomic_uint *)&epn->pfd.revents);
+        }
+
+      spin_unlock_irqrestore(&eph->rlock, flags);
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if (!edge)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
+          /* Teardown the notified fd, the notified flag stays set so that
+           * the node is not queued again before it is setup again.
+           */
+
+          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+          list_delete(&epn->node);
+
+          if (revents != 0 && (epn->pfd.events & EPOLLONESHOT) != 0)
             {
               list_add_tail(&eph->oneshot, &epn->node);
             }
@@ -372,12 +456,27 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
               list_add_tail(&eph->teardown, &epn->node);
             }
         }
-      else
+
+      if (revents != 0)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          evs[i].data     = epn->data;
+          evs[i++].events = revents;
         }
     }
 
+  /* Make sure that the next epoll_wait() does not block if there are more
+   * ready fds than fitted into the events array.
+   */
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  more  = !list_is_empty(&eph->ready);
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  if (more)
+    {
+      epoll_post(eph);
+    }
+
   nxmutex_unlock(&eph->lock);
   return i;
 }
@@ -387,7 +486,7 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
  *
  * Description:
  *   The default epoll callback function, this function do the final step of
- *   poll notification.
+ *   poll notification.  It queues the epoll node to the ready list.
  *
  * Input Parameters:
  *   fds - The fds
@@ -400,16 +499,32 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
-  int semcount = 0;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+  bool queued = false;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  /* Check revents under rlock, epoll_teardown() consumes the events of an
+   * edge-triggered node under the same lock.
+   */
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (!epn->notified &&
+      atomic_load((FAR atomic_uint *)&fds->revents) != 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
-      if (semcount < 1)
-        {
-          nxsem_post(&epn->eph->sem);
-        }
+      epn->notified = true;
+      list_add_tail(&eph->ready, &epn->rnode);
+      queued = true;
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  /* Post outside of the spinlock, nxsem_post() enters the critical
+   * section.
+   */
+
+  if (queued)
+    {
+      epoll_post(eph);
     }
 }
 
@@ -564,6 +679,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn->pfd.arg     = epn;
         epn->pfd.cb      = epoll_default_cb;
         epn->pfd.revents = 0;
+        list_clear_node(&epn->rnode);
 
         ret = poll_fdsetup(fd, &epn->pfd, true);
         if (ret < 0)
@@ -582,6 +698,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 poll_fdsetup(fd, &epn->pfd, false);
+                epoll_unready(eph, epn);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
                 goto out;
@@ -612,6 +729,15 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
+
+        /* EPOLLEXCLUSIVE can only be given when the fd is added */
+
+        if ((ev->events & EPOLLEXCLUSIVE) != 0)
+          {
+            ret = -EINVAL;
+            goto err;
+          }
+
         list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
@@ -619,6 +745,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     poll_fdsetup(fd, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
                     epn->notified    = false;
                     epn->data        = ev->data;
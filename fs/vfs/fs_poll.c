@@ -32,6 +32,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/cancelpt.h>
@@ -274,8 +275,11 @@ void poll_default_cb(FAR struct pollfd *fds)
 
 void poll_notify(FAR struct pollfd **afds, int nfds, pollevent_t eventset)
 {
-  int i;
   FAR struct pollfd *fds;
+  FAR atomic_uint *rev;
+  pollevent_t revents;
+  pollevent_t events;
+  int i;
 
   DEBUGASSERT(afds != NULL && nfds >= 1);
 
@@ -284,20 +288,33 @@ void poll_notify(FAR struct pollfd **afds, int nfds, pollevent_t eventset)
       fds = afds[i];
       if (fds != NULL)
         {
-          /* The error event must be set in fds->revents */
+          /* The error event must be set in fds->revents.  revents is
+           * accumulated atomically, the callback may consume it on
+           * another CPU at the same time (see epoll).
+           */
 
-          fds->revents |= eventset & (fds->events | POLLERR | POLLHUP);
-          if ((fds->revents & (POLLERR | POLLHUP)) != 0)
+          rev    = (FAR atomic_uint *)&fds->revents;
+          events = eventset & (fds->events | POLLERR | POLLHUP);
+          if ((events & (POLLERR | POLLHUP)) != 0)
             {
               /* Error or Hung up, clear POLLOUT event */
 
-              fds->revents &= ~POLLOUT;
+              events &= ~POLLOUT;
+              atomic_fetch_and(rev, ~POLLOUT);
+            }
+
+          revents = atomic_fetch_or(rev, events) | events;
+          if ((revents & (POLLERR | POLLHUP)) != 0 &&
+              (revents & POLLOUT) != 0)
+            {
+              atomic_fetch_and(rev, ~POLLOUT);
+              revents &= ~POLLOUT;
             }
 
-          if ((fds->revents != 0 || (fds->events & POLLALWAYS) != 0) &&
+          if ((revents != 0 || (fds->events & POLLALWAYS) != 0) &&
               fds->cb != NULL)
             {
-              finfo("Report events: %08" PRIx32 "\n", fds->revents);
+              finfo("Report events: %08" PRIx32 "\n", revents);
               fds->cb(fds);
             }
         }
@@ -146,18 +146,23 @@ int symlink(FAR const char *path1, FAR const char *path2)
 
       inode_lock();
       ret = inode_reserve(path2, 0777, &inode);
-      inode_unlock();
       if (ret < 0)
         {
+          inode_unlock();
           fs_heap_free(newpath2);
           errcode = -ret;
           goto errout_with_search;
         }
 
-      /* Initialize the inode */
+      /* Initialize the inode.  This is done before the inode tree is
+       * unlocked, so that no path search sees (and caches) the new inode
+       * as a plain inode.
+       */
 
       INODE_SET_SOFTLINK(inode);
       inode->u.i_link = newpath2;
+      inode_cache_flush();
+      inode_unlock();
     }
 
   /* Symbolic link successfully created */
@@ -114,6 +114,8 @@
 #define IP_TTL                (__SO_PROTOCOL + 14) /* The IP TTL (time to live)
                                                     * of IP packets sent by the
                                                     * network stack */
+#define IP_RECVERR            (__SO_PROTOCOL + 15) /* Extended error message
+                                                    * (control message) */
 
 /* SOL_IPV6 protocol-level socket options. */
 
@@ -136,6 +138,18 @@
                                                     * field */
 #define IPV6_RECVHOPLIMIT     (__SO_PROTOCOL + 11) /* Access the hop limit field */
 #define IPV6_HOPLIMIT         (__SO_PROTOCOL + 12) /* Hop limit */
+#define IPV6_RECVERR          (__SO_PROTOCOL + 13) /* Extended error message
+                                                    * (control message) */
+
+/* Origins of the errors reported by recvmsg(MSG_ERRQUEUE) */
+
+#define SO_EE_ORIGIN_NONE     0
+#define SO_EE_ORIGIN_LOCAL    1
+#define SO_EE_ORIGIN_ICMP     2
+#define SO_EE_ORIGIN_ICMP6    3
+#define SO_EE_ORIGIN_ZEROCOPY 5  /* Completion of MSG_ZEROCOPY sends */
+
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
 
 /* Values used with SIOCSIFMCFILTER and SIOCGIFMCFILTER ioctl's */
 
@@ -308,6 +322,22 @@ struct in_pktinfo
   struct in_addr ipi_addr;          /* Header Destination address */
 };
 
+/* Extended error, the data of the IP_RECVERR and IPV6_RECVERR control
+ * messages.  For SO_EE_ORIGIN_ZEROCOPY, ee_info..ee_data is the range of
+ * the completed sends.
+ */
+
+struct sock_extended_err
+{
+  uint32_t ee_errno;                /* Error number */
+  uint8_t  ee_origin;               /* SO_EE_ORIGIN_* */
+  uint8_t  ee_type;
+  uint8_t  ee_code;
+  uint8_t  ee_pad;
+  uint32_t ee_info;
+  uint32_t ee_data;
+};
+
 /* IPv6 Internet address */
 
 struct in6_addr
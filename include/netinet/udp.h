@@ -33,6 +33,18 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* UDP protocol (SOL_UDP) socket options */
+
+#define UDP_SEGMENT      (__SO_PROTOCOL + 0) /* Split sends in datagrams of
+                                              * this size, 0 to disable.
+                                              * Argument: int */
+
+#define UDP_MAX_SEGMENTS 64 /* Maximum number of datagrams per send */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
 /* UDP header as specified by RFC 768, August 1980. */
 
 struct udphdr
@@ -210,6 +210,9 @@ int           host_fstat(int fd, struct nuttx_stat_s *buf);
 int           host_fchstat(int fd, const struct nuttx_stat_s *buf,
                            int flags);
 int           host_ftruncate(int fd, nuttx_off_t length);
+void         *host_mmap(int fd, nuttx_off_t offset, nuttx_size_t length,
+                        int writable, int shared);
+int           host_munmap(void *addr, nuttx_size_t length);
 void         *host_opendir(const char *name);
 int           host_readdir(void *dirp, struct nuttx_dirent_s *entry);
 void          host_rewinddir(void *dirp);
@@ -234,6 +237,9 @@ int           host_dup(int fd);
 int           host_fstat(int fd, struct stat *buf);
 int           host_fchstat(int fd, const struct stat *buf, int flags);
 int           host_ftruncate(int fd, off_t length);
+void         *host_mmap(int fd, off_t offset, size_t length,
+                        int writable, int shared);
+int           host_munmap(void *addr, size_t length);
 void         *host_opendir(const char *name);
 int           host_readdir(void *dirp, struct dirent *entry);
 void          host_rewinddir(void *dirp);
@@ -0,0 +1,385 @@
+/****************************************************************************
+ * include/nuttx/lfring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_LFRING_H
+#define __INCLUDE_NUTTX_LFRING_H
+
+/* Lock-free ring buffers.  Unlike circbuf, these need no external locking
+ * as long as the producer/consumer roles are respected:
+ *
+ *   spsc_ring - A byte stream with one producer and one consumer.
+ *   mpsc_ring - A queue of fixed-size elements with any number of
+ *               producers (tasks or interrupt handlers) and one consumer.
+ *
+ * Both offer zero-copy access: the producer reserves space, fills it and
+ * commits it; the consumer peeks at the data and releases it.  The
+ * producer and consumer indices live in separate cache lines so that the
+ * two sides do not contend on them.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <nuttx/atomic.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size the producer and consumer indices are padded to */
+
+#ifndef LFRING_CACHELINE
+#  define LFRING_CACHELINE 64
+#endif
+
+/* Each mpsc_ring element is preceded by a sequence number, the element
+ * data is aligned to 8 bytes.
+ */
+
+#define MPSC_RING_HDRSIZE        8
+#define MPSC_RING_STRIDE(esize) \
+  ((MPSC_RING_HDRSIZE + (esize) + 7) & ~7)
+
+/* The buffer size needed for 'nelem' elements of 'esize' bytes */
+
+#define MPSC_RING_BUFSIZE(nelem, esize) ((nelem) * MPSC_RING_STRIDE(esize))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes a single-producer single-consumer byte ring.
+ * The indices run freely and are reduced modulo the (power of two) size.
+ */
+
+struct spsc_ring_s
+{
+  FAR uint8_t *base;          /* The pointer to buffer space */
+  unsigned int mask;          /* The size of buffer space - 1 */
+  bool external;              /* The flag for external buffer */
+  uint8_t pad0[LFRING_CACHELINE - sizeof(FAR void *) -
+               sizeof(unsigned int) - sizeof(bool)];
+
+  /* Written by the producer only */
+
+  atomic_uint head;           /* The write index */
+  unsigned int tailcache;     /* Last tail seen by the producer */
+  uint8_t pad1[LFRING_CACHELINE - 2 * sizeof(unsigned int)];
+
+  /* Written by the consumer only */
+
+  atomic_uint tail;           /* The read index */
+  unsigned int headcache;     /* Last head seen by the consumer */
+  uint8_t pad2[LFRING_CACHELINE - 2 * sizeof(unsigned int)];
+};
+
+/* This structure describes a multi-producer single-consumer queue of
+ * fixed-size elements.  Every element carries a sequence number that tells
+ * whether it is free for the producer of a given lap or committed for the
+ * consumer, so a producer that is preempted between reserve and commit
+ * never blocks the other producers.
+ */
+
+struct mpsc_ring_s
+{
+  FAR uint8_t *base;          /* The pointer to element space */
+  size_t stride;              /* The size of one element with its header */
+  unsigned int mask;          /* The number of elements - 1 */
+  bool external;              /* The flag for external buffer */
+  uint8_t pad0[LFRING_CACHELINE - sizeof(FAR void *) - sizeof(size_t) -
+               sizeof(unsigned int) - sizeof(bool)];
+
+  /* Shared by the producers */
+
+  atomic_uint head;           /* The next element to reserve */
+  uint8_t pad1[LFRING_CACHELINE - sizeof(unsigned int)];
+
+  /* Owned by the consumer */
+
+  unsigned int tail;          /* The next element to consume */
+  uint8_t pad2[LFRING_CACHELINE - sizeof(unsigned int)];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: spsc_ring_init
+ *
+ * Description:
+ *   Initialize a single-producer single-consumer ring.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring to be used.
+ *   base  - A pointer to the ring's internal buffer.  If NULL, a buffer of
+ *           the given size will be allocated.
+ *   bytes - The size of the internal buffer, a power of two.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int spsc_ring_init(FAR struct spsc_ring_s *ring, FAR void *base,
+                   size_t bytes);
+
+/****************************************************************************
+ * Name: spsc_ring_uninit
+ *
+ * Description:
+ *   Free the ring.
+ *
+ ****************************************************************************/
+
+void spsc_ring_uninit(FAR struct spsc_ring_s *ring);
+
+/****************************************************************************
+ * Name: spsc_ring_used/space
+ *
+ * Description:
+ *   Return the number of bytes that can be read or written.  The result is
+ *   exact for the caller's own side and a lower bound for the other one.
+ *
+ ****************************************************************************/
+
+size_t spsc_ring_used(FAR struct spsc_ring_s *ring);
+size_t spsc_ring_space(FAR struct spsc_ring_s *ring);
+
+/****************************************************************************
+ * Name: spsc_ring_reserve
+ *
+ * Description:
+ *   Producer: get the largest contiguous free area of the ring.  Fill it
+ *   and make the data visible with spsc_ring_commit().
+ *
+ * Input Parameters:
+ *   ring - Address of the ring to be used.
+ *   size - Returns the size of the area.
+ *
+ * Returned Value:
+ *   The start of the area, or NULL if the ring is full.
+ *
+ ****************************************************************************/
+
+FAR void *spsc_ring_reserve(FAR struct spsc_ring_s *ring,
+                            FAR size_t *size);
+
+/****************************************************************************
+ * Name: spsc_ring_commit
+ *
+ * Description:
+ *   Producer: publish 'bytes' bytes written to the area returned by
+ *   spsc_ring_reserve().
+ *
+ ****************************************************************************/
+
+void spsc_ring_commit(FAR struct spsc_ring_s *ring, size_t bytes);
+
+/****************************************************************************
+ * Name: spsc_ring_peek
+ *
+ * Description:
+ *   Consumer: get the largest contiguous area of readable data.  Free it
+ *   with spsc_ring_release() when it has been consumed.
+ *
+ * Input Parameters:
+ *   ring - Address of the ring to be used.
+ *   size - Returns the size of the area.
+ *
+ * Returned Value:
+ *   The start of the area, or NULL if the ring is empty.
+ *
+ ****************************************************************************/
+
+FAR void *spsc_ring_peek(FAR struct spsc_ring_s *ring, FAR size_t *size);
+
+/****************************************************************************
+ * Name: spsc_ring_release
+ *
+ * Description:
+ *   Consumer: give 'bytes' consumed bytes back to the producer.
+ *
+ ****************************************************************************/
+
+void spsc_ring_release(FAR struct spsc_ring_s *ring, size_t bytes);
+
+/****************************************************************************
+ * Name: spsc_ring_write
+ *
+ * Description:
+ *   Producer: copy as much of 'src' as fits into the ring.
+ *
+ * Returned Value:
+ *   The number of bytes written.
+ *
+ ****************************************************************************/
+
+ssize_t spsc_ring_write(FAR struct spsc_ring_s *ring,
+                        FAR const void *src, size_t bytes);
+
+/****************************************************************************
+ * Name: spsc_ring_read
+ *
+ * Description:
+ *   Consumer: copy up to 'bytes' bytes out of the ring.
+ *
+ * Returned Value:
+ *   The number of bytes read.
+ *
+ ****************************************************************************/
+
+ssize_t spsc_ring_read(FAR struct spsc_ring_s *ring,
+                       FAR void *dst, size_t bytes);
+
+/****************************************************************************
+ * Name: mpsc_ring_init
+ *
+ * Description:
+ *   Initialize a multi-producer single-consumer ring.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring to be used.
+ *   base  - A pointer to the ring's internal buffer of
+ *           MPSC_RING_BUFSIZE(nelem, esize) bytes.  If NULL, the buffer
+ *           will be allocated.
+ *   nelem - The number of elements, a power of two.
+ *   esize - The size of one element.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int mpsc_ring_init(FAR struct mpsc_ring_s *ring, FAR void *base,
+                   size_t nelem, size_t esize);
+
+/****************************************************************************
+ * Name: mpsc_ring_uninit
+ *
+ * Description:
+ *   Free the ring.
+ *
+ ****************************************************************************/
+
+void mpsc_ring_uninit(FAR struct mpsc_ring_s *ring);
+
+/****************************************************************************
+ * Name: mpsc_ring_reserve
+ *
+ * Description:
+ *   Producer: claim a free element.  Fill it and hand it to the consumer
+ *   with mpsc_ring_commit().  May be called from interrupt handlers.
+ *
+ * Returned Value:
+ *   The element, or NULL if the ring is full.
+ *
+ ****************************************************************************/
+
+FAR void *mpsc_ring_reserve(FAR struct mpsc_ring_s *ring);
+
+/****************************************************************************
+ * Name: mpsc_ring_commit
+ *
+ * Description:
+ *   Producer: publish an element returned by mpsc_ring_reserve().
+ *   Elements become visible to the consumer in reservation order.
+ *
+ ****************************************************************************/
+
+void mpsc_ring_commit(FAR struct mpsc_ring_s *ring, FAR void *elem);
+
+/****************************************************************************
+ * Name: mpsc_ring_peek
+ *
+ * Description:
+ *   Consumer: get the oldest committed element without removing it.
+ *
+ * Returned Value:
+ *   The element, or NULL if the ring is empty or the oldest element has
+ *   not been committed yet.
+ *
+ ****************************************************************************/
+
+FAR void *mpsc_ring_peek(FAR struct mpsc_ring_s *ring);
+
+/****************************************************************************
+ * Name: mpsc_ring_release
+ *
+ * Description:
+ *   Consumer: give the element returned by mpsc_ring_peek() back to the
+ *   producers.
+ *
+ ****************************************************************************/
+
+void mpsc_ring_release(FAR struct mpsc_ring_s *ring);
+
+/****************************************************************************
+ * Name: mpsc_ring_push
+ *
+ * Description:
+ *   Producer: copy one element into the ring.
+ *
+ * Returned Value:
+ *   Zero on success; -EAGAIN if the ring is full.
+ *
+ ****************************************************************************/
+
+int mpsc_ring_push(FAR struct mpsc_ring_s *ring, FAR const void *elem,
+                   size_t esize);
+
+/****************************************************************************
+ * Name: mpsc_ring_pop
+ *
+ * Description:
+ *   Consumer: copy the oldest element out of the ring.
+ *
+ * Returned Value:
+ *   Zero on success; -EAGAIN if the ring is empty.
+ *
+ ****************************************************************************/
+
+int mpsc_ring_pop(FAR struct mpsc_ring_s *ring, FAR void *elem,
+                  size_t esize);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_LFRING_H */
@@ -81,7 +81,7 @@
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -96,6 +96,20 @@
 #  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
 #endif
 
+#ifdef CONFIG_IOB_OFFLOAD
+/* Offload flags of a packet, valid in the I/O buffer at the head of the
+ * chain.  See netdev_lowerhalf.h for how drivers use them.
+ */
+
+#  define IOB_OFFLOAD_CSUM_PARTIAL (1 << 0) /* TX: L4 checksum holds only the
+                                             * pseudo-header sum */
+#  define IOB_OFFLOAD_CSUM_VALID   (1 << 1) /* RX: L4 checksum verified */
+#  define IOB_OFFLOAD_GSO_TCPV4    (1 << 2) /* TX: TCP/IPv4 super-segment */
+#  define IOB_OFFLOAD_GSO_TCPV6    (1 << 3) /* TX: TCP/IPv6 super-segment */
+#  define IOB_OFFLOAD_GSO          (IOB_OFFLOAD_GSO_TCPV4 | \
+                                    IOB_OFFLOAD_GSO_TCPV6)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -127,6 +141,13 @@ struct iob_s
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
+#ifdef CONFIG_IOB_OFFLOAD
+  uint16_t io_csumstart;  /* Checksummed area start, from the L3 header */
+  uint16_t io_csumoff;    /* Checksum field offset from io_csumstart */
+  uint16_t io_gsosize;    /* Payload size of each segment */
+  uint8_t  io_offload;    /* IOB_OFFLOAD_* flags */
+#endif
+
 #ifdef CONFIG_IOB_ALLOC
   iob_free_cb_t io_free;  /* Custom free callback */
   FAR uint8_t  *io_data;
@@ -170,6 +191,17 @@ struct iob_stats_s
   int nthrottle;
 };
 
+#ifdef CONFIG_IOB_CLASSES
+struct iob_class_stats_s
+{
+  unsigned int bufsize;   /* Payload size of the buffers of the class */
+  int ntotal;             /* Number of buffers */
+  int nfree;              /* Number of free buffers */
+  unsigned long nalloc;   /* Allocations served by the class */
+  unsigned long nmiss;    /* Best fits found the class empty */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -268,6 +300,39 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
                                       iob_free_cb_t free_cb);
 #endif
 
+#ifdef CONFIG_IOB_CLASSES
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate the smallest free I/O buffer that holds 'size' bytes in
+ *   one piece, from the size classes and from the default buffers, without
+ *   waiting.  The throttle only applies to the default buffers.
+ *
+ * Returned Value:
+ *   The I/O buffer, or NULL if no buffer of that size is free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled);
+
+/****************************************************************************
+ * Name: iob_tryshrink
+ *
+ * Description:
+ *   Copy a packet held in a single I/O buffer, headroom included, to a
+ *   free buffer of a smaller size class.  The original buffer is left
+ *   unchanged.
+ *
+ * Returned Value:
+ *   The copy, or NULL if the packet is in a chain or no smaller buffer
+ *   that holds it is free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryshrink(FAR const struct iob_s *iob, bool throttled);
+#endif
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -691,6 +756,26 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
 void iob_getstats(FAR struct iob_stats_s *stats);
+
+/****************************************************************************
+ * Name: iob_getclassstats
+ *
+ * Description:
+ *   Return the usage statistics of an I/O buffer size class.  The classes
+ *   are numbered from zero by increasing buffer size.
+ *
+ * Input Parameters:
+ *   index - The number of the class
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, -ENOENT if there is no such class.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CLASSES
+int iob_getclassstats(int index, FAR struct iob_class_stats_s *stats);
+#endif
 #endif
 
 #endif /* CONFIG_MM_IOB */
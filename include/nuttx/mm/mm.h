@@ -160,6 +160,10 @@
 #define MM_ALLOC_MAGIC   0xaa
 #define MM_FREE_MAGIC    0x55
 
+/* Number of buckets of the free chunk histogram, see mm_fraginfo() */
+
+#define MM_FRAG_NBUCKETS (sizeof(size_t) * 8)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -176,6 +180,17 @@ struct mempool_init_s
   size_t            dict_expendsize;
 };
 
+/* Free chunk histogram of a heap.  Bucket 'n' covers the free chunks of
+ * 2^n up to 2^(n + 1) - 1 bytes.
+ */
+
+struct mm_fraginfo_s
+{
+  size_t nfree[MM_FRAG_NBUCKETS]; /* Number of free chunks */
+  size_t sfree[MM_FRAG_NBUCKETS]; /* Total size of the free chunks */
+  size_t mxfree;                  /* Size of the largest free chunk */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -404,6 +419,8 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
+void mm_fraginfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_fraginfo_s *info);
 
 /* Functions contained in kmm_mallinfo.c ************************************/
 
@@ -326,6 +326,22 @@ ssize_t net_ioctl_arglen(uint8_t domain, int cmd);
  *                       momentarily to wait for an IOB to become
  *                       available.
  *
+ * Finer grained locks protect state that may be accessed without the
+ * network lock.  They must always be taken in this order, skipping any
+ * that are not needed:
+ *
+ *   1. net_lock()     - The network lock.
+ *   2. Connection list locks, e.g. the UDP free list lock in
+ *      net/udp/udp_conn.c.  The active connection lists are still
+ *      protected by the network lock.
+ *   3. Per-connection locks, e.g. the read-ahead lock of UDP
+ *      connections.
+ *   4. Device locks, e.g. the upper half lock in
+ *      drivers/net/netdev_upperhalf.c that serializes calls into the lower
+ *      half driver.
+ *
+ * No lower level lock may be held while blocking on a higher level one.
+ *
  ****************************************************************************/
 
 /****************************************************************************
@@ -928,6 +944,66 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends several messages to a socket with a single
+ *   call.  This is an internal OS interface.  It is functionally equivalent
+ *   to sendmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Array of messages to send
+ *   vlen      Number of messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent, the msg_len field of
+ *   each of them is set to the number of bytes sent.  If the first message
+ *   can not be sent, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives several messages from a socket with a single
+ *   call.  This is an internal OS interface.  It is functionally equivalent
+ *   to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Array of buffers to receive the messages
+ *   vlen      Number of messages in msgvec
+ *   flags     Receive flags
+ *   timeout   Timeout of the whole batch, NULL to wait forever
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received, the msg_len field
+ *   of each of them is set to the number of bytes received.  If the first
+ *   message can not be received, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -192,6 +192,20 @@
 #  define NETDEV_ERRORS(dev)
 #endif
 
+/* Offload capabilities a driver advertises in d_features:
+ *
+ *   TXCSUM - Completes TCP/UDP checksums marked IOB_OFFLOAD_CSUM_PARTIAL
+ *   RXCSUM - Verifies received TCP/UDP checksums, IOB_OFFLOAD_CSUM_VALID
+ *   TSO    - Segments TCP packets of up to d_gsomax bytes marked with
+ *            IOB_OFFLOAD_GSO
+ */
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define NETDEV_FEATURE_TXCSUM (1 << 0)
+#  define NETDEV_FEATURE_RXCSUM (1 << 1)
+#  define NETDEV_FEATURE_TSO    (1 << 2)
+#endif
+
 /* There are some helper pointers for accessing the contents of the IP
  * headers
  */
@@ -339,6 +353,11 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint8_t d_features;           /* NETDEV_FEATURE_* offload capabilities */
+  uint16_t d_gsomax;            /* Largest TSO packet, from the L3 header */
+#endif
+
   /* Link layer address */
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
@@ -119,6 +119,14 @@ struct netdev_lowerhalf_s
 
   atomic_int quota[NETPKT_TYPENUM];
 
+  /* Number of RX/TX queue pairs, 0 or 1 for a single queue driver.  Set
+   * before registering, the queues are numbered from 0.
+   */
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  int nqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -172,6 +180,26 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmit_queue/receive_queue - Like transmit and receive, for one
+   *   queue of a driver with nqueues > 1, which needs not provide the
+   *   single queue variants.  Calls for different queues may run
+   *   concurrently, calls for one queue are serialized.
+   */
+
+  CODE int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt, int queue);
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      int queue);
+
+  /* affinity - Optional, called once the work thread of a queue is bound
+   *   to its CPU, e.g. to route the queue interrupt to the same CPU.
+   */
+
+  CODE void (*affinity)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                        int cpu);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -308,6 +336,26 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue/netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Like netdev_lower_rxready and netdev_lower_txdone, for one queue of a
+ *   multi-queue driver: the work thread of that queue is woken up.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue number
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -561,4 +609,76 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
 #define netpkt_free_queue(queue) iob_free_queue(queue)
 
+/****************************************************************************
+ * Name: netpkt_offload
+ *
+ * Description:
+ *   Get the offload requests of a packet to transmit, a combination of
+ *   IOB_OFFLOAD_CSUM_PARTIAL and one of the IOB_OFFLOAD_GSO_* types, see
+ *   NETDEV_FEATURE_TXCSUM and NETDEV_FEATURE_TSO.
+ *
+ * Input Parameters:
+ *   pkt - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define netpkt_offload(pkt) ((pkt)->io_offload)
+#endif
+
+/****************************************************************************
+ * Name: netpkt_csum_start/netpkt_csum_offset
+ *
+ * Description:
+ *   For IOB_OFFLOAD_CSUM_PARTIAL: the offset from the packet data where
+ *   the checksummed area starts, and the offset of the checksum field from
+ *   there.  The field holds the pseudo-header sum, the driver (or device)
+ *   must add the sum of the area from the start to the end of the packet
+ *   and store the complement of the result.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   pkt - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define netpkt_csum_start(dev, pkt) \
+     (NET_LL_HDRLEN(&(dev)->netdev) + (pkt)->io_csumstart)
+#  define netpkt_csum_offset(dev, pkt) ((pkt)->io_csumoff)
+#endif
+
+/****************************************************************************
+ * Name: netpkt_gso_size
+ *
+ * Description:
+ *   For IOB_OFFLOAD_GSO_*: the TCP payload size of the segments to cut the
+ *   packet into.
+ *
+ * Input Parameters:
+ *   pkt - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define netpkt_gso_size(pkt) ((pkt)->io_gsosize)
+#endif
+
+/****************************************************************************
+ * Name: netpkt_set_csum_valid
+ *
+ * Description:
+ *   Mark a received packet whose TCP/UDP checksum the device has verified,
+ *   for drivers that advertise NETDEV_FEATURE_RXCSUM.
+ *
+ * Input Parameters:
+ *   pkt - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define netpkt_set_csum_valid(pkt) \
+     ((pkt)->io_offload |= IOB_OFFLOAD_CSUM_VALID)
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_LOWERHALF_H */
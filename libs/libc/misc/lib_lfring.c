@@ -0,0 +1,558 @@
+/****************************************************************************
+ * libs/libc/misc/lib_lfring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+
+#include <nuttx/lfring.h>
+#include <nuttx/lib/lib.h>
+#include <nuttx/lib/math32.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The sequence number of an mpsc_ring element */
+
+#define MPSC_RING_SEQ(ring, pos) \
+  ((FAR atomic_uint *)((ring)->base + ((pos) & (ring)->mask) * \
+                       (ring)->stride))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spsc_ring_init
+ *
+ * Description:
+ *   Initialize a single-producer single-consumer ring.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring to be used.
+ *   base  - A pointer to the ring's internal buffer.  If NULL, a buffer of
+ *           the given size will be allocated.
+ *   bytes - The size of the internal buffer, a power of two.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int spsc_ring_init(FAR struct spsc_ring_s *ring, FAR void *base,
+                   size_t bytes)
+{
+  DEBUGASSERT(ring);
+
+  if (!IS_POWER_OF_2(bytes) || bytes > UINT_MAX / 2 + 1)
+    {
+      return -EINVAL;
+    }
+
+  ring->external = !!base;
+
+  if (!base)
+    {
+      base = lib_malloc(bytes);
+      if (!base)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  ring->base      = base;
+  ring->mask      = bytes - 1;
+  ring->tailcache = 0;
+  ring->headcache = 0;
+  atomic_init(&ring->head, 0);
+  atomic_init(&ring->tail, 0);
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: spsc_ring_uninit
+ *
+ * Description:
+ *   Free the ring.
+ *
+ ****************************************************************************/
+
+void spsc_ring_uninit(FAR struct spsc_ring_s *ring)
+{
+  DEBUGASSERT(ring);
+
+  if (!ring->external)
+    {
+      lib_free(ring->base);
+    }
+
+  ring->base = NULL;
+}
+
+/****************************************************************************
+ * Name: spsc_ring_used
+ *
+ * Description:
+ *   Return the number of bytes that can be read.
+ *
+ ****************************************************************************/
+
+size_t spsc_ring_used(FAR struct spsc_ring_s *ring)
+{
+  unsigned int tail = atomic_load_explicit(&ring->tail,
+                                           memory_order_acquire);
+  unsigned int head = atomic_load_explicit(&ring->head,
+                                           memory_order_acquire);
+
+  return head - tail;
+}
+
+/****************************************************************************
+ * Name: spsc_ring_space
+ *
+ * Description:
+ *   Return the number of bytes that can be written.
+ *
+ ****************************************************************************/
+
+size_t spsc_ring_space(FAR struct spsc_ring_s *ring)
+{
+  return ring->mask + 1 - spsc_ring_used(ring);
+}
+
+/****************************************************************************
+ * Name: spsc_ring_reserve
+ *
+ * Description:
+ *   Producer: get the largest contiguous free area of the ring.
+ *
+ ****************************************************************************/
+
+FAR void *spsc_ring_reserve(FAR struct spsc_ring_s *ring,
+                            FAR size_t *size)
+{
+  unsigned int head = atomic_load_explicit(&ring->head,
+                                           memory_order_relaxed);
+  unsigned int off = head & ring->mask;
+  unsigned int space;
+
+  /* Only look at the consumer's cache line if the cached tail is not
+   * enough to fill up to the end of the buffer.
+   */
+
+  space = ring->mask + 1 - (head - ring->tailcache);
+  if (space < ring->mask + 1 - off)
+    {
+      ring->tailcache = atomic_load_explicit(&ring->tail,
+                                             memory_order_acquire);
+      space = ring->mask + 1 - (head - ring->tailcache);
+    }
+
+  if (space > ring->mask + 1 - off)
+    {
+      space = ring->mask + 1 - off;
+    }
+
+  *size = space;
+  return space > 0 ? ring->base + off : NULL;
+}
+
+/****************************************************************************
+ * Name: spsc_ring_commit
+ *
+ * Description:
+ *   Producer: publish the bytes written to the reserved area.
+ *
+ ****************************************************************************/
+
+void spsc_ring_commit(FAR struct spsc_ring_s *ring, size_t bytes)
+{
+  unsigned int head = atomic_load_explicit(&ring->head,
+                                           memory_order_relaxed);
+
+  DEBUGASSERT(head + bytes - ring->tailcache <= ring->mask + 1);
+  atomic_store_explicit(&ring->head, head + bytes, memory_order_release);
+}
+
+/****************************************************************************
+ * Name: spsc_ring_peek
+ *
+ * Description:
+ *   Consumer: get the largest contiguous area of readable data.
+ *
+ ****************************************************************************/
+
+FAR void *spsc_ring_peek(FAR struct spsc_ring_s *ring, FAR size_t *size)
+{
+  unsigned int tail = atomic_load_explicit(&ring->tail,
+                                           memory_order_relaxed);
+  unsigned int off = tail & ring->mask;
+  unsigned int used;
+
+  used = ring->headcache - tail;
+  if (used < ring->mask + 1 - off)
+    {
+      ring->headcache = atomic_load_explicit(&ring->head,
+                                             memory_order_acquire);
+      used = ring->headcache - tail;
+    }
+
+  if (used > ring->mask + 1 - off)
+    {
+      used = ring->mask + 1 - off;
+    }
+
+  *size = used;
+  return used > 0 ? ring->base + off : NULL;
+}
+
+/****************************************************************************
+ * Name: spsc_ring_release
+ *
+ * Description:
+ *   Consumer: give consumed bytes back to the producer.
+ *
+ ****************************************************************************/
+
+void spsc_ring_release(FAR struct spsc_ring_s *ring, size_t bytes)
+{
+  unsigned int tail = atomic_load_explicit(&ring->tail,
+                                           memory_order_relaxed);
+
+  DEBUGASSERT(ring->headcache - tail >= bytes);
+  atomic_store_explicit(&ring->tail, tail + bytes, memory_order_release);
+}
+
+/****************************************************************************
+ * Name: spsc_ring_write
+ *
+ * Description:
+ *   Producer: copy as much of 'src' as fits into the ring.
+ *
+ ****************************************************************************/
+
+ssize_t spsc_ring_write(FAR struct spsc_ring_s *ring,
+                        FAR const void *src, size_t bytes)
+{
+  FAR const uint8_t *ptr = src;
+  FAR void *dst;
+  size_t total = 0;
+  size_t size;
+
+  /* At most two rounds, one up to the end of the buffer and one from its
+   * start.
+   */
+
+  while (total < bytes && (dst = spsc_ring_reserve(ring, &size)) != NULL)
+    {
+      if (size > bytes - total)
+        {
+          size = bytes - total;
+        }
+
+      memcpy(dst, ptr + total, size);
+      spsc_ring_commit(ring, size);
+      total += size;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: spsc_ring_read
+ *
+ * Description:
+ *   Consumer: copy up to 'bytes' bytes out of the ring.
+ *
+ ****************************************************************************/
+
+ssize_t spsc_ring_read(FAR struct spsc_ring_s *ring,
+                       FAR void *dst, size_t bytes)
+{
+  FAR uint8_t *ptr = dst;
+  FAR void *src;
+  size_t total = 0;
+  size_t size;
+
+  while (total < bytes && (src = spsc_ring_peek(ring, &size)) != NULL)
+    {
+      if (size > bytes - total)
+        {
+          size = bytes - total;
+        }
+
+      memcpy(ptr + total, src, size);
+      spsc_ring_release(ring, size);
+      total += size;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: mpsc_ring_init
+ *
+ * Description:
+ *   Initialize a multi-producer single-consumer ring.
+ *
+ * Input Parameters:
+ *   ring  - Address of the ring to be used.
+ *   base  - A pointer to the ring's internal buffer of
+ *           MPSC_RING_BUFSIZE(nelem, esize) bytes.  If NULL, the buffer
+ *           will be allocated.
+ *   nelem - The number of elements, a power of two.
+ *   esize - The size of one element.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int mpsc_ring_init(FAR struct mpsc_ring_s *ring, FAR void *base,
+                   size_t nelem, size_t esize)
+{
+  unsigned int i;
+
+  DEBUGASSERT(ring);
+
+  if (!IS_POWER_OF_2(nelem) || nelem > UINT_MAX / 2 + 1 || esize == 0)
+    {
+      return -EINVAL;
+    }
+
+  ring->external = !!base;
+
+  if (!base)
+    {
+      base = lib_malloc(MPSC_RING_BUFSIZE(nelem, esize));
+      if (!base)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  ring->base   = base;
+  ring->stride = MPSC_RING_STRIDE(esize);
+  ring->mask   = nelem - 1;
+  ring->tail   = 0;
+  atomic_init(&ring->head, 0);
+
+  /* Element 'i' is free for the producer that reserves position 'i' */
+
+  for (i = 0; i < nelem; i++)
+    {
+      atomic_init(MPSC_RING_SEQ(ring, i), i);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mpsc_ring_uninit
+ *
+ * Description:
+ *   Free the ring.
+ *
+ ****************************************************************************/
+
+void mpsc_ring_uninit(FAR struct mpsc_ring_s *ring)
+{
+  DEBUGASSERT(ring);
+
+  if (!ring->external)
+    {
+      lib_free(ring->base);
+    }
+
+  ring->base = NULL;
+}
+
+/****************************************************************************
+ * Name: mpsc_ring_reserve
+ *
+ * Description:
+ *   Producer: claim a free element.
+ *
+ ****************************************************************************/
+
+FAR void *mpsc_ring_reserve(FAR struct mpsc_ring_s *ring)
+{
+  FAR atomic_uint *seqp;
+  unsigned int pos;
+  unsigned int seq;
+  int diff;
+
+  pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  for (; ; )
+    {
+      seqp = MPSC_RING_SEQ(ring, pos);
+      seq  = atomic_load_explicit(seqp, memory_order_acquire);
+      diff = (int)(seq - pos);
+
+      if (diff == 0)
+        {
+          /* The element is free in this lap, try to claim it.  On failure
+           * 'pos' is updated to the current head.
+           */
+
+          if (atomic_compare_exchange_weak_explicit(&ring->head, &pos,
+                                                    pos + 1,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed))
+            {
+              return (FAR uint8_t *)seqp + MPSC_RING_HDRSIZE;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* The element of the previous lap is not consumed yet */
+
+          return NULL;
+        }
+      else
+        {
+          /* Another producer has claimed it, retry with the new head */
+
+          pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mpsc_ring_commit
+ *
+ * Description:
+ *   Producer: publish an element returned by mpsc_ring_reserve().
+ *
+ ****************************************************************************/
+
+void mpsc_ring_commit(FAR struct mpsc_ring_s *ring, FAR void *elem)
+{
+  FAR atomic_uint *seqp = (FAR atomic_uint *)
+                          ((FAR uint8_t *)elem - MPSC_RING_HDRSIZE);
+  unsigned int seq = atomic_load_explicit(seqp, memory_order_relaxed);
+
+  atomic_store_explicit(seqp, seq + 1, memory_order_release);
+}
+
+/****************************************************************************
+ * Name: mpsc_ring_peek
+ *
+ * Description:
+ *   Consumer: get the oldest committed element without removing it.
+ *
+ ****************************************************************************/
+
+FAR void *mpsc_ring_peek(FAR struct mpsc_ring_s *ring)
+{
+  FAR atomic_uint *seqp = MPSC_RING_SEQ(ring, ring->tail);
+
+  if (atomic_load_explicit(seqp, memory_order_acquire) != ring->tail + 1)
+    {
+      return NULL;
+    }
+
+  return (FAR uint8_t *)seqp + MPSC_RING_HDRSIZE;
+}
+
+/****************************************************************************
+ * Name: mpsc_ring_release
+ *
+ * Description:
+ *   Consumer: give the peeked element back to the producers.
+ *
+ ****************************************************************************/
+
+void mpsc_ring_release(FAR struct mpsc_ring_s *ring)
+{
+  FAR atomic_uint *seqp = MPSC_RING_SEQ(ring, ring->tail);
+
+  DEBUGASSERT(atomic_load_explicit(seqp, memory_order_relaxed) ==
+              ring->tail + 1);
+
+  /* Free the element for the producer of the next lap */
+
+  atomic_store_explicit(seqp, ring->tail + ring->mask + 1,
+                        memory_order_release);
+  ring->tail++;
+}
+
+/****************************************************************************
+ * Name: mpsc_ring_push
+ *
+ * Description:
+ *   Producer: copy one element into the ring.
+ *
+ ****************************************************************************/
+
+int mpsc_ring_push(FAR struct mpsc_ring_s *ring, FAR const void *elem,
+                   size_t esize)
+{
+  FAR void *dst;
+
+  DEBUGASSERT(esize <= ring->stride - MPSC_RING_HDRSIZE);
+
+  dst = mpsc_ring_reserve(ring);
+  if (dst == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  memcpy(dst, elem, esize);
+  mpsc_ring_commit(ring, dst);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mpsc_ring_pop
+ *
+ * Description:
+ *   Consumer: copy the oldest element out of the ring.
+ *
+ ****************************************************************************/
+
+int mpsc_ring_pop(FAR struct mpsc_ring_s *ring, FAR void *elem,
+                  size_t esize)
+{
+  FAR void *src;
+
+  DEBUGASSERT(esize <= ring->stride - MPSC_RING_HDRSIZE);
+
+  src = mpsc_ring_peek(ring);
+  if (src == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  memcpy(elem, src, esize);
+  mpsc_ring_release(ring);
+  return 0;
+}
@@ -0,0 +1,773 @@
+/****************************************************************************
+ * libs/libc/misc/lib_lfringtest.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <errno.h>
+
+#include <nuttx/circbuf.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/lfring.h>
+#include <nuttx/mutex.h>
+#include <nuttx/signal.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/procfs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LFRINGTEST_NTASKS    CONFIG_LIBC_LFRING_TEST_NPRODUCERS
+#define LFRINGTEST_NITEMS    CONFIG_LIBC_LFRING_TEST_NITEMS
+
+/* The producer id of the interrupt producer follows the task ones */
+
+#define LFRINGTEST_IRQ       LFRINGTEST_NTASKS
+
+/* Elements pushed by each run of the interrupt producer */
+
+#define LFRINGTEST_IRQBURST  4
+
+/* Ring sizes.  They are small on purpose, so that the producers keep
+ * running into a full ring and the consumer into an empty one.
+ */
+
+#define LFRINGTEST_NELEM     64
+#define LFRINGTEST_SPSCSIZE  256
+#define LFRINGTEST_NBYTES    (LFRINGTEST_NITEMS * 8)
+
+/* The benchmark moves messages of MSGSIZE bytes in batches of BATCH */
+
+#define LFRINGTEST_MSGSIZE   16
+#define LFRINGTEST_BATCH     32
+#define LFRINGTEST_BENCHSIZE (LFRINGTEST_MSGSIZE * LFRINGTEST_BATCH)
+
+/* Size of the report generated by one read of /proc/lfring */
+
+#define LFRINGTEST_TEXTLEN   512
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct lfringtest_elem_s
+{
+  uint32_t producer;                  /* Index of the producer */
+  uint32_t seq;                       /* Per-producer sequence number */
+};
+
+struct lfringtest_s
+{
+  struct mpsc_ring_s mpsc;            /* Ring under test */
+  struct spsc_ring_s spsc;            /* Ring under test */
+  struct wdog_s wdog;                 /* Runs the interrupt producer */
+  int priority;                       /* Priority of the consumer */
+  atomic_uint done;                   /* Task producers that finished */
+  atomic_uint stop;                   /* Stop the interrupt producer */
+  uint32_t irqseq;                    /* Next interrupt sequence number */
+  uint32_t irqfull;                   /* Interrupt pushes on a full ring */
+};
+
+/* This structure describes one open "file" */
+
+struct lfringtest_file_s
+{
+  struct procfs_file_s base;          /* Base open file structure */
+  size_t textsize;                    /* Valid characters in text[] */
+  bool   valid;                       /* The test has been run */
+  char   text[LFRINGTEST_TEXTLEN];    /* Test report */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     lfringtest_open(FAR struct file *filep,
+                               FAR const char *relpath,
+                               int oflags, mode_t mode);
+static int     lfringtest_close(FAR struct file *filep);
+static ssize_t lfringtest_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static int     lfringtest_dup(FAR const struct file *oldp,
+                              FAR struct file *newp);
+static int     lfringtest_stat(FAR const char *relpath,
+                               FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_lfringtest_operations =
+{
+  lfringtest_open,   /* open */
+  lfringtest_close,  /* close */
+  lfringtest_read,   /* read */
+  NULL,              /* write */
+  NULL,              /* poll */
+  lfringtest_dup,    /* dup */
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+  lfringtest_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct lfringtest_s g_lfringtest;
+
+/* Only one test runs at a time */
+
+static mutex_t g_lfringtest_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lfringtest_nsec
+ ****************************************************************************/
+
+static uint64_t lfringtest_nsec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: lfringtest_producer
+ *
+ * Description:
+ *   Task producer of the mpsc_ring.  Every 16th element is held between
+ *   reserve and commit across a context switch, so that the other
+ *   producers reserve the elements behind it and the consumer has to wait
+ *   for it.
+ *
+ ****************************************************************************/
+
+static int lfringtest_producer(int argc, FAR char *argv[])
+{
+  FAR struct lfringtest_s *test = &g_lfringtest;
+  FAR struct lfringtest_elem_s *elem;
+  uint32_t producer = atoi(argv[1]);
+  uint32_t seq = 0;
+
+  while (seq < LFRINGTEST_NITEMS)
+    {
+      elem = mpsc_ring_reserve(&test->mpsc);
+      if (elem == NULL)
+        {
+          sched_yield();
+          continue;
+        }
+
+      elem->producer = producer;
+      elem->seq      = seq++;
+
+      if (seq % 16 == 0)
+        {
+          sched_yield();
+        }
+
+      mpsc_ring_commit(&test->mpsc, elem);
+    }
+
+  atomic_fetch_add(&test->done, 1);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lfringtest_interrupt
+ *
+ * Description:
+ *   Interrupt producer of the mpsc_ring, run from a watchdog on every
+ *   tick.  It may preempt a task producer between reserve and commit.
+ *
+ ****************************************************************************/
+
+static void lfringtest_interrupt(wdparm_t arg)
+{
+  FAR struct lfringtest_s *test = (FAR struct lfringtest_s *)arg;
+  FAR struct lfringtest_elem_s *elem;
+  int i;
+
+  for (i = 0; i < LFRINGTEST_IRQBURST; i++)
+    {
+      elem = mpsc_ring_reserve(&test->mpsc);
+      if (elem == NULL)
+        {
+          test->irqfull++;
+          break;
+        }
+
+      elem->producer = LFRINGTEST_IRQ;
+      elem->seq      = test->irqseq++;
+      mpsc_ring_commit(&test->mpsc, elem);
+    }
+
+  if (atomic_load(&test->stop) == 0)
+    {
+      wd_start(&test->wdog, 1, lfringtest_interrupt, arg);
+    }
+}
+
+/****************************************************************************
+ * Name: lfringtest_mpsc
+ *
+ * Description:
+ *   Run the task and interrupt producers against the calling task as the
+ *   consumer, which checks that the elements of every producer arrive
+ *   once and in order.
+ *
+ ****************************************************************************/
+
+static size_t lfringtest_mpsc(FAR struct lfringtest_s *test,
+                              FAR char *text, size_t textlen)
+{
+  FAR struct lfringtest_elem_s *elem;
+  uint32_t expect[LFRINGTEST_NTASKS + 1];
+  unsigned long errors = 0;
+  unsigned long total = 0;
+  unsigned int nstarted = 0;
+  bool stopped = false;
+  FAR char *argv[2];
+  char arg[16];
+  clock_t start;
+  int ret;
+  int i;
+
+  ret = mpsc_ring_init(&test->mpsc, NULL, LFRINGTEST_NELEM,
+                       sizeof(struct lfringtest_elem_s));
+  if (ret < 0)
+    {
+      return procfs_snprintf(text, textlen, "mpsc: error %d\n", ret);
+    }
+
+  memset(expect, 0, sizeof(expect));
+  atomic_store(&test->done, 0);
+  atomic_store(&test->stop, 0);
+  test->irqseq  = 0;
+  test->irqfull = 0;
+
+  start = perf_gettime();
+  wd_start(&test->wdog, 1, lfringtest_interrupt, (wdparm_t)test);
+
+  for (i = 0; i < LFRINGTEST_NTASKS; i++)
+    {
+      snprintf(arg, sizeof(arg), "%d", i);
+      argv[0] = arg;
+      argv[1] = NULL;
+
+      ret = kthread_create("lfring_producer", test->priority,
+                           CONFIG_DEFAULT_TASK_STACKSIZE,
+                           lfringtest_producer, argv);
+      if (ret < 0)
+        {
+          errors++;
+          expect[i] = LFRINGTEST_NITEMS;
+          continue;
+        }
+
+      nstarted++;
+    }
+
+  for (; ; )
+    {
+      elem = mpsc_ring_peek(&test->mpsc);
+      if (elem == NULL)
+        {
+          if (atomic_load(&test->done) < nstarted)
+            {
+              sched_yield();
+              continue;
+            }
+
+          if (stopped)
+            {
+              break;
+            }
+
+          /* The task producers are done: stop the interrupt producer and
+           * drain what it pushed.  The second cancel catches a watchdog
+           * that restarted itself on another CPU.
+           */
+
+          atomic_store(&test->stop, 1);
+          wd_cancel(&test->wdog);
+          nxsig_usleep(2 * USEC_PER_TICK);
+          wd_cancel(&test->wdog);
+          stopped = true;
+          continue;
+        }
+
+      if (elem->producer > LFRINGTEST_IRQ ||
+          elem->seq != expect[elem->producer])
+        {
+          errors++;
+        }
+
+      if (elem->producer <= LFRINGTEST_IRQ)
+        {
+          expect[elem->producer] = elem->seq + 1;
+        }
+
+      total++;
+      mpsc_ring_release(&test->mpsc);
+    }
+
+  start = perf_gettime() - start;
+
+  for (i = 0; i < LFRINGTEST_NTASKS; i++)
+    {
+      if (expect[i] != LFRINGTEST_NITEMS)
+        {
+          errors++;
+        }
+    }
+
+  if (expect[LFRINGTEST_IRQ] != test->irqseq)
+    {
+      errors++;
+    }
+
+  mpsc_ring_uninit(&test->mpsc);
+
+  return procfs_snprintf(text, textlen,
+                         "mpsc: %d tasks + interrupt, %lu items "
+                         "(%lu from interrupt) in %lu us, %lu errors\n",
+                         LFRINGTEST_NTASKS, total,
+                         (unsigned long)test->irqseq,
+                         (unsigned long)(lfringtest_nsec(start) /
+                                         NSEC_PER_USEC),
+                         errors);
+}
+
+/****************************************************************************
+ * Name: lfringtest_spscproducer
+ *
+ * Description:
+ *   Producer of the spsc_ring: a counting byte stream written in chunks of
+ *   random size, some of them held across a context switch before the
+ *   commit.
+ *
+ ****************************************************************************/
+
+static int lfringtest_spscproducer(int argc, FAR char *argv[])
+{
+  FAR struct lfringtest_s *test = &g_lfringtest;
+  uint32_t seed = 1;
+  uint32_t pos = 0;
+  FAR uint8_t *dst;
+  size_t chunk;
+  size_t size;
+  size_t i;
+
+  while (pos < LFRINGTEST_NBYTES)
+    {
+      dst = spsc_ring_reserve(&test->spsc, &size);
+      if (dst == NULL)
+        {
+          sched_yield();
+          continue;
+        }
+
+      seed  = seed * 1103515245 + 12345;
+      chunk = 1 + (seed >> 16) % 64;
+      chunk = MIN(chunk, MIN(size, LFRINGTEST_NBYTES - pos));
+
+      for (i = 0; i < chunk; i++)
+        {
+          dst[i] = (uint8_t)(pos + i);
+        }
+
+      if (chunk % 8 == 0)
+        {
+          sched_yield();
+        }
+
+      spsc_ring_commit(&test->spsc, chunk);
+      pos += chunk;
+    }
+
+  atomic_fetch_add(&test->done, 1);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lfringtest_spsc
+ *
+ * Description:
+ *   Stream LFRINGTEST_NBYTES bytes through the spsc_ring and check them.
+ *
+ ****************************************************************************/
+
+static size_t lfringtest_spsc(FAR struct lfringtest_s *test,
+                              FAR char *text, size_t textlen)
+{
+  FAR char *argv[1] =
+    {
+      NULL
+    };
+
+  unsigned long errors = 0;
+  uint32_t seed = 2;
+  uint32_t pos = 0;
+  FAR uint8_t *src;
+  clock_t start;
+  size_t chunk;
+  size_t size;
+  size_t i;
+  int ret;
+
+  ret = spsc_ring_init(&test->spsc, NULL, LFRINGTEST_SPSCSIZE);
+  if (ret < 0)
+    {
+      return procfs_snprintf(text, textlen, "spsc: error %d\n", ret);
+    }
+
+  atomic_store(&test->done, 0);
+  start = perf_gettime();
+
+  ret = kthread_create("lfring_spsc", test->priority,
+                       CONFIG_DEFAULT_TASK_STACKSIZE,
+                       lfringtest_spscproducer, argv);
+  if (ret < 0)
+    {
+      spsc_ring_uninit(&test->spsc);
+      return procfs_snprintf(text, textlen, "spsc: error %d\n", ret);
+    }
+
+  while (pos < LFRINGTEST_NBYTES)
+    {
+      src = spsc_ring_peek(&test->spsc, &size);
+      if (src == NULL)
+        {
+          sched_yield();
+          continue;
+        }
+
+      seed  = seed * 1103515245 + 12345;
+      chunk = MIN(size, 1 + (seed >> 16) % 64);
+
+      for (i = 0; i < chunk; i++)
+        {
+          if (src[i] != (uint8_t)(pos + i))
+            {
+              errors++;
+            }
+        }
+
+      spsc_ring_release(&test->spsc, chunk);
+      pos += chunk;
+    }
+
+  start = perf_gettime() - start;
+
+  /* The producer may still be on its way out */
+
+  while (atomic_load(&test->done) == 0)
+    {
+      sched_yield();
+    }
+
+  spsc_ring_uninit(&test->spsc);
+
+  return procfs_snprintf(text, textlen,
+                         "spsc: %lu bytes in %lu us, %lu errors\n",
+                         (unsigned long)pos,
+                         (unsigned long)(lfringtest_nsec(start) /
+                                         NSEC_PER_USEC),
+                         errors);
+}
+
+/****************************************************************************
+ * Name: lfringtest_bench
+ *
+ * Description:
+ *   Move LFRINGTEST_NITEMS messages through a ring, in batches of
+ *   LFRINGTEST_BATCH writes followed by as many reads, and return the
+ *   time taken.  circbuf is locked with a critical section like its users
+ *   (pipes, sensors, ramlog) do; the lock-free rings are not locked.
+ *
+ ****************************************************************************/
+
+static clock_t lfringtest_bench(int ring, FAR void *handle)
+{
+  uint8_t msg[LFRINGTEST_MSGSIZE];
+  irqstate_t flags;
+  clock_t start;
+  size_t n;
+  int i;
+
+  memset(msg, 0, sizeof(msg));
+  start = perf_gettime();
+
+  for (n = 0; n < LFRINGTEST_NITEMS; n += LFRINGTEST_BATCH)
+    {
+      for (i = 0; i < LFRINGTEST_BATCH; i++)
+        {
+          switch (ring)
+            {
+              case 0:
+                flags = enter_critical_section();
+                circbuf_write(handle, msg, sizeof(msg));
+                leave_critical_section(flags);
+                break;
+
+              case 1:
+                spsc_ring_write(handle, msg, sizeof(msg));
+                break;
+
+              default:
+                mpsc_ring_push(handle, msg, sizeof(msg));
+                break;
+            }
+        }
+
+      for (i = 0; i < LFRINGTEST_BATCH; i++)
+        {
+          switch (ring)
+            {
+              case 0:
+                flags = enter_critical_section();
+                circbuf_read(handle, msg, sizeof(msg));
+                leave_critical_section(flags);
+                break;
+
+              case 1:
+                spsc_ring_read(handle, msg, sizeof(msg));
+                break;
+
+              default:
+                mpsc_ring_pop(handle, msg, sizeof(msg));
+                break;
+            }
+        }
+    }
+
+  return perf_gettime() - start;
+}
+
+/****************************************************************************
+ * Name: lfringtest_throughput
+ ****************************************************************************/
+
+static size_t lfringtest_throughput(FAR struct lfringtest_s *test,
+                                    FAR char *text, size_t textlen)
+{
+  static const FAR char *names[] =
+    {
+      "circbuf+csection", "spsc_ring", "mpsc_ring"
+    };
+
+  struct circbuf_s circ;
+  FAR void *handle[3];
+  unsigned long rate;
+  uint64_t nsec;
+  size_t len;
+  int ret;
+  int i;
+
+  ret = circbuf_init(&circ, NULL, LFRINGTEST_BENCHSIZE);
+  if (ret >= 0)
+    {
+      ret = spsc_ring_init(&test->spsc, NULL, LFRINGTEST_BENCHSIZE);
+      if (ret >= 0)
+        {
+          ret = mpsc_ring_init(&test->mpsc, NULL, LFRINGTEST_BATCH,
+                               LFRINGTEST_MSGSIZE);
+          if (ret < 0)
+            {
+              spsc_ring_uninit(&test->spsc);
+            }
+        }
+
+      if (ret < 0)
+        {
+          circbuf_uninit(&circ);
+        }
+    }
+
+  if (ret < 0)
+    {
+      return procfs_snprintf(text, textlen, "bench: error %d\n", ret);
+    }
+
+  handle[0] = &circ;
+  handle[1] = &test->spsc;
+  handle[2] = &test->mpsc;
+
+  len = procfs_snprintf(text, textlen, "%-18s%10s%12s\n",
+                        "bench", "ns/msg", "msgs/s");
+
+  for (i = 0; i < 3; i++)
+    {
+      nsec = lfringtest_nsec(lfringtest_bench(i, handle[i]));
+      rate = nsec > 0 ? (unsigned long)
+             ((uint64_t)LFRINGTEST_NITEMS * NSEC_PER_SEC / nsec) : 0;
+
+      len += procfs_snprintf(text + len, textlen - len,
+                             "%-18s%10lu%12lu\n", names[i],
+                             (unsigned long)(nsec / LFRINGTEST_NITEMS),
+                             rate);
+    }
+
+  mpsc_ring_uninit(&test->mpsc);
+  spsc_ring_uninit(&test->spsc);
+  circbuf_uninit(&circ);
+  return len;
+}
+
+/****************************************************************************
+ * Name: lfringtest_open
+ ****************************************************************************/
+
+static int lfringtest_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct lfringtest_file_s *procfile;
+
+  procfile = kmm_zalloc(sizeof(struct lfringtest_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lfringtest_close
+ ****************************************************************************/
+
+static int lfringtest_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lfringtest_read
+ *
+ * Description:
+ *   The first read runs the stress tests and the benchmark; the following
+ *   ones return the rest of the same report.
+ *
+ ****************************************************************************/
+
+static ssize_t lfringtest_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct lfringtest_file_s *procfile = filep->f_priv;
+  FAR char *text = procfile->text;
+  off_t offset = filep->f_pos;
+  struct sched_param param;
+  size_t copysize;
+  size_t len;
+
+  if (!procfile->valid)
+    {
+      /* The producers run at the priority of the consumer, so that
+       * sched_yield() on a full or empty ring hands the CPU over.
+       */
+
+      nxmutex_lock(&g_lfringtest_lock);
+      sched_getparam(0, &param);
+      g_lfringtest.priority = param.sched_priority;
+
+      len  = lfringtest_mpsc(&g_lfringtest, text, LFRINGTEST_TEXTLEN);
+      len += lfringtest_spsc(&g_lfringtest, text + len,
+                             LFRINGTEST_TEXTLEN - len);
+      len += lfringtest_throughput(&g_lfringtest, text + len,
+                                   LFRINGTEST_TEXTLEN - len);
+      nxmutex_unlock(&g_lfringtest_lock);
+
+      procfile->textsize = len;
+      procfile->valid    = true;
+    }
+
+  copysize = procfs_memcpy(text, procfile->textsize, buffer, buflen,
+                           &offset);
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: lfringtest_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int lfringtest_dup(FAR const struct file *oldp,
+                          FAR struct file *newp)
+{
+  FAR struct lfringtest_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct lfringtest_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct lfringtest_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lfringtest_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int lfringtest_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
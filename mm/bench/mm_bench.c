@@ -0,0 +1,899 @@
+/****************************************************************************
+ * mm/bench/mm_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the report generated by one read of /proc/mmbench */
+
+#define MMBENCH_TEXTLEN   1024
+
+/* Latency histogram: eight linear sub-buckets per power of two, so that a
+ * percentile is reported within 12.5% of the measured value.
+ */
+
+#define MMBENCH_SUBSHIFT  3
+#define MMBENCH_NSUB      (1 << MMBENCH_SUBSHIFT)
+#define MMBENCH_NBUCKETS  ((32 - MMBENCH_SUBSHIFT + 1) * MMBENCH_NSUB)
+
+/* Longest line of an allocation trace */
+
+#define MMBENCH_LINELEN   80
+
+/* Block sizes of the multiple mempool front end */
+
+#define MMBENCH_POOLSTEP  16
+#define MMBENCH_NPOOLS    16
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+#  define MMBENCH_MANAGER "tlsf"
+#else
+#  define MMBENCH_MANAGER "mm_heap"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One live allocation of the running pattern */
+
+struct mmbench_slot_s
+{
+  uintptr_t id;                       /* Trace identifier */
+  FAR void *mem;                      /* NULL if the slot is free */
+  size_t    size;                     /* Requested size */
+};
+
+/* State of one pattern run against one heap */
+
+struct mmbench_s
+{
+  FAR struct mm_heap_s *heap;         /* Private heap under test */
+  uint32_t seed;                      /* Pattern random generator */
+  size_t   ops;                       /* Allocator calls */
+  size_t   fails;                     /* Failed allocations */
+  uint64_t nsec;                      /* Time spent in the allocator */
+  uint32_t hist[MMBENCH_NBUCKETS];    /* Latency histogram */
+  struct mmbench_slot_s slot[CONFIG_MM_BENCH_NSLOTS];
+  struct mm_fraginfo_s frag;          /* Free chunks at the end of the run */
+};
+
+typedef int (*mmbench_pattern_t)(FAR struct mmbench_s *bench);
+
+/* This structure describes one open "file" */
+
+struct mmbench_file_s
+{
+  struct procfs_file_s base;          /* Base open file structure */
+  size_t textsize;                    /* Valid characters in text[] */
+  bool   valid;                       /* The benchmark has been run */
+  char   text[MMBENCH_TEXTLEN];       /* Benchmark report */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     mmbench_netbuf(FAR struct mmbench_s *bench);
+static int     mmbench_cxx(FAR struct mmbench_s *bench);
+static int     mmbench_random(FAR struct mmbench_s *bench);
+static int     mmbench_trace(FAR struct mmbench_s *bench);
+
+static int     mmbench_open(FAR struct file *filep, FAR const char *relpath,
+                            int oflags, mode_t mode);
+static int     mmbench_close(FAR struct file *filep);
+static ssize_t mmbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t mmbench_write(FAR struct file *filep,
+                             FAR const char *buffer, size_t buflen);
+static int     mmbench_dup(FAR const struct file *oldp,
+                           FAR struct file *newp);
+static int     mmbench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_mmbench_operations =
+{
+  mmbench_open,   /* open */
+  mmbench_close,  /* close */
+  mmbench_read,   /* read */
+  mmbench_write,  /* write */
+  NULL,           /* poll */
+  mmbench_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  mmbench_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct
+{
+  FAR const char   *name;
+  mmbench_pattern_t run;
+}
+g_mmbench_patterns[] =
+{
+  { "netbuf", mmbench_netbuf },
+  { "cxx",    mmbench_cxx    },
+  { "random", mmbench_random },
+  { "trace",  mmbench_trace  },
+};
+
+/* Allocation trace selected by writing its path to /proc/mmbench */
+
+static char g_mmbench_path[PATH_MAX];
+
+/* Only one benchmark runs at a time */
+
+static mutex_t g_mmbench_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmbench_rand
+ *
+ * Description:
+ *   xorshift32, so that every run replays the same pattern.
+ *
+ ****************************************************************************/
+
+static uint32_t mmbench_rand(FAR struct mmbench_s *bench)
+{
+  uint32_t x = bench->seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  bench->seed = x;
+  return x;
+}
+
+/****************************************************************************
+ * Name: mmbench_bucket / mmbench_bound
+ *
+ * Description:
+ *   Map a latency to its histogram bucket, and a bucket back to the
+ *   smallest latency that it holds.
+ *
+ ****************************************************************************/
+
+static unsigned int mmbench_bucket(uint32_t nsec)
+{
+  unsigned int shift = 0;
+
+  while ((nsec >> shift) >= 2 * MMBENCH_NSUB)
+    {
+      shift++;
+    }
+
+  if (shift == 0 && nsec < MMBENCH_NSUB)
+    {
+      return nsec;
+    }
+
+  return (shift + 1) * MMBENCH_NSUB +
+         ((nsec >> shift) & (MMBENCH_NSUB - 1));
+}
+
+static uint64_t mmbench_bound(unsigned int bucket)
+{
+  if (bucket < MMBENCH_NSUB)
+    {
+      return bucket;
+    }
+
+  return (uint64_t)(MMBENCH_NSUB + bucket % MMBENCH_NSUB) <<
+         (bucket / MMBENCH_NSUB - 1);
+}
+
+/****************************************************************************
+ * Name: mmbench_account
+ ****************************************************************************/
+
+static void mmbench_account(FAR struct mmbench_s *bench, clock_t elapsed)
+{
+  struct timespec ts;
+  uint64_t nsec;
+
+  perf_convert(elapsed, &ts);
+  nsec = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+
+  bench->ops++;
+  bench->nsec += nsec;
+  bench->hist[mmbench_bucket(nsec > UINT32_MAX ? UINT32_MAX : nsec)]++;
+}
+
+/****************************************************************************
+ * Name: mmbench_alloc / mmbench_realloc / mmbench_free
+ *
+ * Description:
+ *   Time one allocator call on the heap under test and record the result
+ *   in 'slot'.
+ *
+ ****************************************************************************/
+
+static void mmbench_alloc(FAR struct mmbench_s *bench,
+                          FAR struct mmbench_slot_s *slot, size_t size)
+{
+  clock_t start = perf_gettime();
+
+  slot->mem = mm_malloc(bench->heap, size);
+  mmbench_account(bench, perf_gettime() - start);
+
+  slot->size = size;
+  if (slot->mem == NULL)
+    {
+      bench->fails++;
+    }
+}
+
+static void mmbench_realloc(FAR struct mmbench_s *bench,
+                            FAR struct mmbench_slot_s *slot, size_t size)
+{
+  clock_t start = perf_gettime();
+  FAR void *mem;
+
+  mem = mm_realloc(bench->heap, slot->mem, size);
+  mmbench_account(bench, perf_gettime() - start);
+
+  if (mem == NULL)
+    {
+      /* The old block is still allocated */
+
+      bench->fails++;
+      return;
+    }
+
+  slot->mem  = mem;
+  slot->size = size;
+}
+
+static void mmbench_free(FAR struct mmbench_s *bench,
+                         FAR struct mmbench_slot_s *slot)
+{
+  clock_t start = perf_gettime();
+
+  mm_free(bench->heap, slot->mem);
+  mmbench_account(bench, perf_gettime() - start);
+
+  slot->mem = NULL;
+}
+
+/****************************************************************************
+ * Name: mmbench_netbuf
+ *
+ * Description:
+ *   Network buffers: FIFO lifetimes, with a mix of header sized blocks and
+ *   full Ethernet frames.
+ *
+ ****************************************************************************/
+
+static int mmbench_netbuf(FAR struct mmbench_s *bench)
+{
+  FAR struct mmbench_slot_s *slot;
+  uint32_t r;
+  size_t i;
+
+  for (i = 0; bench->ops < CONFIG_MM_BENCH_NOPS; i++)
+    {
+      slot = &bench->slot[i % CONFIG_MM_BENCH_NSLOTS];
+      if (slot->mem != NULL)
+        {
+          mmbench_free(bench, slot);
+        }
+
+      r = mmbench_rand(bench);
+      if (r % 10 < 7)
+        {
+          mmbench_alloc(bench, slot, 48 + (r >> 8) % 80);
+        }
+      else
+        {
+          mmbench_alloc(bench, slot, 1514 + (r >> 8) % 86);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_cxx
+ *
+ * Description:
+ *   C++ containers: small list and map nodes with random lifetimes, and
+ *   vectors that grow by doubling through realloc().
+ *
+ ****************************************************************************/
+
+static int mmbench_cxx(FAR struct mmbench_s *bench)
+{
+  FAR struct mmbench_slot_s *slot;
+  uint32_t r;
+
+  while (bench->ops < CONFIG_MM_BENCH_NOPS)
+    {
+      r    = mmbench_rand(bench);
+      slot = &bench->slot[r % CONFIG_MM_BENCH_NSLOTS];
+      r  >>= 16;
+
+      if (slot->mem == NULL)
+        {
+          mmbench_alloc(bench, slot, r % 4 != 0 ? 16 + r % 4 * 16 : 32);
+        }
+      else if (slot->size >= 32 && slot->size < 2048 && r % 2 != 0)
+        {
+          mmbench_realloc(bench, slot, slot->size * 2);
+        }
+      else
+        {
+          mmbench_free(bench, slot);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_random
+ *
+ * Description:
+ *   Uniformly random sizes up to 4 KB with random lifetimes.
+ *
+ ****************************************************************************/
+
+static int mmbench_random(FAR struct mmbench_s *bench)
+{
+  FAR struct mmbench_slot_s *slot;
+  uint32_t r;
+
+  while (bench->ops < CONFIG_MM_BENCH_NOPS)
+    {
+      r    = mmbench_rand(bench);
+      slot = &bench->slot[r % CONFIG_MM_BENCH_NSLOTS];
+
+      if (slot->mem != NULL)
+        {
+          mmbench_free(bench, slot);
+        }
+      else
+        {
+          mmbench_alloc(bench, slot, 1 + (r >> 16) % 4096);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_lookup
+ *
+ * Description:
+ *   Find the live allocation of a trace identifier, or a free slot if
+ *   'live' is false.  Lookups are not timed.
+ *
+ ****************************************************************************/
+
+static FAR struct mmbench_slot_s *
+mmbench_lookup(FAR struct mmbench_s *bench, uintptr_t id, bool live)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_MM_BENCH_NSLOTS; i++)
+    {
+      FAR struct mmbench_slot_s *slot = &bench->slot[i];
+
+      if (live ? slot->mem != NULL && slot->id == id : slot->mem == NULL)
+        {
+          return slot;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mmbench_replay
+ *
+ * Description:
+ *   Replay one line of an allocation trace:
+ *
+ *     a <id> <size>   allocate 'size' bytes for 'id'
+ *     r <id> <size>   reallocate the block of 'id' to 'size' bytes
+ *     f <id>          free the block of 'id'
+ *
+ *   'id' is any number that identifies the block, typically its address
+ *   on the traced system.  Empty lines and lines starting with '#' are
+ *   ignored.
+ *
+ ****************************************************************************/
+
+static int mmbench_replay(FAR struct mmbench_s *bench, FAR char *line)
+{
+  FAR struct mmbench_slot_s *slot;
+  FAR char *endp;
+  uintptr_t id;
+  size_t size;
+  char op;
+
+  while (*line == ' ' || *line == '\t')
+    {
+      line++;
+    }
+
+  op = *line;
+  if (op == '\0' || op == '#')
+    {
+      return OK;
+    }
+
+  id   = strtoul(line + 1, &endp, 0);
+  size = strtoul(endp, NULL, 0);
+
+  switch (op)
+    {
+      case 'a':
+        slot = mmbench_lookup(bench, 0, false);
+        if (slot == NULL)
+          {
+            /* More live blocks than CONFIG_MM_BENCH_NSLOTS */
+
+            bench->fails++;
+            break;
+          }
+
+        slot->id = id;
+        mmbench_alloc(bench, slot, size);
+        break;
+
+      case 'r':
+        slot = mmbench_lookup(bench, id, true);
+        if (slot != NULL)
+          {
+            mmbench_realloc(bench, slot, size);
+          }
+        break;
+
+      case 'f':
+        slot = mmbench_lookup(bench, id, true);
+        if (slot != NULL)
+          {
+            mmbench_free(bench, slot);
+          }
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_trace
+ *
+ * Description:
+ *   Replay the allocation trace whose path was written to /proc/mmbench.
+ *
+ ****************************************************************************/
+
+static int mmbench_trace(FAR struct mmbench_s *bench)
+{
+  char line[MMBENCH_LINELEN];
+  char buf[64];
+  struct file file;
+  size_t len = 0;
+  ssize_t nread;
+  ssize_t i;
+  int ret;
+
+  ret = file_open(&file, g_mmbench_path, O_RDONLY | O_CLOEXEC);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while ((nread = file_read(&file, buf, sizeof(buf))) > 0)
+    {
+      for (i = 0; i < nread; i++)
+        {
+          if (buf[i] != '\n')
+            {
+              if (len < sizeof(line) - 1)
+                {
+                  line[len++] = buf[i];
+                }
+
+              continue;
+            }
+
+          line[len] = '\0';
+          len = 0;
+
+          ret = mmbench_replay(bench, line);
+          if (ret < 0)
+            {
+              goto out;
+            }
+        }
+    }
+
+  ret = nread;
+  if (ret >= 0 && len > 0)
+    {
+      line[len] = '\0';
+      ret = mmbench_replay(bench, line);
+    }
+
+out:
+  file_close(&file);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mmbench_run
+ *
+ * Description:
+ *   Run one pattern on a fresh private heap and append its line to the
+ *   report.  The peak is the high-water mark of the heap, which includes
+ *   the mempool chunks.  The fragmentation is measured like /proc/memfrag
+ *   before the blocks still alive at the end of the pattern are freed.
+ *
+ ****************************************************************************/
+
+static int mmbench_run(FAR struct mmbench_s *bench,
+                       FAR const char *backend, bool pool,
+                       int pattern, FAR char *text, size_t textlen)
+{
+  FAR void *heapmem;
+  struct mallinfo info;
+  unsigned long frag = 0;
+  unsigned long ops = 0;
+  uint64_t p99 = 0;
+  size_t sfree = 0;
+  size_t count = 0;
+  int ret;
+  int i;
+
+  heapmem = kmm_malloc(CONFIG_MM_BENCH_HEAPSIZE);
+  if (heapmem == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(bench, 0, sizeof(*bench));
+  bench->seed = 2463534242u;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  if (pool)
+    {
+      size_t poolsize[MMBENCH_NPOOLS];
+      struct mempool_init_s init;
+
+      for (i = 0; i < MMBENCH_NPOOLS; i++)
+        {
+          poolsize[i] = (i + 1) * MMBENCH_POOLSTEP;
+        }
+
+      init.poolsize        = poolsize;
+      init.npools          = MMBENCH_NPOOLS;
+      init.threshold       = MMBENCH_NPOOLS * MMBENCH_POOLSTEP;
+      init.chunksize       = 0;
+      init.expandsize      = 4096;
+      init.dict_expendsize = 4096;
+
+      bench->heap = mm_initialize_pool("mmbench", heapmem,
+                                       CONFIG_MM_BENCH_HEAPSIZE, &init);
+    }
+  else
+#endif
+    {
+      bench->heap = mm_initialize("mmbench", heapmem,
+                                  CONFIG_MM_BENCH_HEAPSIZE);
+    }
+
+  ret = g_mmbench_patterns[pattern].run(bench);
+
+  mm_free_delaylist(bench->heap);
+  info = mm_mallinfo(bench->heap);
+  mm_fraginfo(bench->heap, &bench->frag);
+
+  for (i = 0; i < CONFIG_MM_BENCH_NSLOTS; i++)
+    {
+      if (bench->slot[i].mem != NULL)
+        {
+          mm_free(bench->heap, bench->slot[i].mem);
+        }
+    }
+
+  mm_uninitialize(bench->heap);
+  kmm_free(heapmem);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < MM_FRAG_NBUCKETS; i++)
+    {
+      sfree += bench->frag.sfree[i];
+    }
+
+  if (sfree > 0)
+    {
+      frag = 100 - (unsigned long)
+             ((uint64_t)bench->frag.mxfree * 100 / sfree);
+    }
+
+  /* Report the upper bound of the bucket that holds the 99th percentile */
+
+  for (i = 0; i < MMBENCH_NBUCKETS; i++)
+    {
+      count += bench->hist[i];
+      if ((uint64_t)count * 100 >= (uint64_t)bench->ops * 99)
+        {
+          p99 = mmbench_bound(i + 1) - 1;
+          break;
+        }
+    }
+
+  if (bench->nsec > 0)
+    {
+      ops = (unsigned long)((uint64_t)bench->ops * NSEC_PER_SEC /
+                            bench->nsec);
+    }
+
+  return procfs_snprintf(text, textlen,
+                         "%-16s%-8s%11lu%9lu%9lu%9lu%6lu%%%7lu\n",
+                         backend, g_mmbench_patterns[pattern].name,
+                         (unsigned long)bench->ops, ops,
+                         (unsigned long)p99, (unsigned long)info.usmblks,
+                         frag, (unsigned long)bench->fails);
+}
+
+/****************************************************************************
+ * Name: mmbench_report
+ *
+ * Description:
+ *   Run every pattern on the configured heap manager, then on the same
+ *   manager behind the multiple mempool front end.
+ *
+ ****************************************************************************/
+
+static size_t mmbench_report(FAR char *text, size_t textlen)
+{
+  FAR struct mmbench_s *bench;
+  FAR const char *backend;
+  size_t len;
+  int pattern;
+  int pool;
+  int ret;
+
+  len = procfs_snprintf(text, textlen,
+                        "%-16s%-8s%11s%9s%9s%9s%7s%7s\n",
+                        "backend", "pattern", "ops", "ops/s", "p99(ns)",
+                        "peak", "frag", "fails");
+
+  bench = kmm_malloc(sizeof(struct mmbench_s));
+  if (bench == NULL)
+    {
+      return len;
+    }
+
+  nxmutex_lock(&g_mmbench_lock);
+
+  for (pool = 0; pool < 2; pool++)
+    {
+#ifndef CONFIG_MM_HEAP_MEMPOOL
+      if (pool)
+        {
+          break;
+        }
+#endif
+
+      backend = pool ? MMBENCH_MANAGER "+mempool" : MMBENCH_MANAGER;
+      for (pattern = 0; pattern < nitems(g_mmbench_patterns); pattern++)
+        {
+          if (g_mmbench_patterns[pattern].run == mmbench_trace &&
+              g_mmbench_path[0] == '\0')
+            {
+              continue;
+            }
+
+          ret = mmbench_run(bench, backend, pool, pattern,
+                            text + len, textlen - len);
+          if (ret < 0)
+            {
+              ret = procfs_snprintf(text + len, textlen - len,
+                                    "%-16s%-8s error %d\n", backend,
+                                    g_mmbench_patterns[pattern].name, ret);
+            }
+
+          len += ret;
+        }
+    }
+
+  nxmutex_unlock(&g_mmbench_lock);
+  kmm_free(bench);
+  return len;
+}
+
+/****************************************************************************
+ * Name: mmbench_open
+ ****************************************************************************/
+
+static int mmbench_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct mmbench_file_s *procfile;
+
+  procfile = kmm_zalloc(sizeof(struct mmbench_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_close
+ ****************************************************************************/
+
+static int mmbench_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_read
+ *
+ * Description:
+ *   The first read runs the benchmark; the following ones return the rest
+ *   of the same report.
+ *
+ ****************************************************************************/
+
+static ssize_t mmbench_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct mmbench_file_s *procfile = filep->f_priv;
+  off_t offset = filep->f_pos;
+  size_t copysize;
+
+  if (!procfile->valid)
+    {
+      procfile->textsize = mmbench_report(procfile->text, MMBENCH_TEXTLEN);
+      procfile->valid    = true;
+    }
+
+  copysize = procfs_memcpy(procfile->text, procfile->textsize, buffer,
+                           buflen, &offset);
+
+  filep->f_pos += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: mmbench_write
+ *
+ * Description:
+ *   Select the allocation trace to replay.  An empty line deselects it.
+ *
+ ****************************************************************************/
+
+static ssize_t mmbench_write(FAR struct file *filep,
+                             FAR const char *buffer, size_t buflen)
+{
+  size_t len = buflen;
+
+  while (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == ' '))
+    {
+      len--;
+    }
+
+  if (len >= sizeof(g_mmbench_path))
+    {
+      return -ENAMETOOLONG;
+    }
+
+  nxmutex_lock(&g_mmbench_lock);
+  memcpy(g_mmbench_path, buffer, len);
+  g_mmbench_path[len] = '\0';
+  nxmutex_unlock(&g_mmbench_lock);
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: mmbench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int mmbench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct mmbench_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct mmbench_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct mmbench_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmbench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int mmbench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
@@ -42,6 +42,12 @@
 
 #define ROUNDUP(x, y)            (((x) + (y) - 1) / (y) * (y))
 
+#ifdef CONFIG_IOB_OFFLOAD
+#  define IOB_OFFLOAD_RESET(iob) ((iob)->io_offload = 0)
+#else
+#  define IOB_OFFLOAD_RESET(iob)
+#endif
+
 #if defined(CONFIG_DEBUG_FEATURES) && defined(CONFIG_IOB_DEBUG)
 #  define ioberr                 _err
 #  define iobwarn                _warn
@@ -52,6 +58,33 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* The I/O buffer size classes, by increasing buffer size */
+
+#ifdef CONFIG_IOB_CLASSES
+#  define IOB_CLASS_SMALL        0
+#  define IOB_CLASS_LARGE        1
+#  define IOB_CLASS_JUMBO        2
+#  define IOB_NCLASSES           3
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CLASSES
+/* A pool of I/O buffers of one size other than CONFIG_IOB_BUFSIZE */
+
+struct iob_class_s
+{
+  FAR struct iob_s *freelist;   /* Free buffers of the class */
+  uint16_t bufsize;             /* Payload size of the buffers */
+  uint16_t ntotal;              /* Number of buffers, zero if disabled */
+  uint16_t nfree;               /* Number of free buffers */
+  unsigned long nalloc;         /* Allocations served by the class */
+  unsigned long nmiss;          /* Best fits found the class empty */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -84,6 +117,12 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_CLASSES
+/* The I/O buffer size classes */
+
+extern struct iob_class_s g_iob_classes[IOB_NCLASSES];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -147,5 +186,97 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 void iob_notifier_signal(void);
 #endif
 
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the free lists of the I/O buffer size classes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CLASSES
+void iob_class_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_class_free
+ *
+ * Description:
+ *   Return an I/O buffer to the free list of its size class.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CLASSES
+void iob_class_free(FAR struct iob_s *iob);
+#endif
+
+/****************************************************************************
+ * Name: iob_free_global
+ *
+ * Description:
+ *   Return an I/O buffer of the default size to the global free list, or
+ *   commit it to a task that is waiting for one.
+ *
+ ****************************************************************************/
+
+void iob_free_global(FAR struct iob_s *iob);
+
+#ifdef CONFIG_IOB_PERCPU
+/****************************************************************************
+ * Name: iob_percpu_tryalloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the global free list if it is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_percpu_tryalloc(bool throttled);
+
+/****************************************************************************
+ * Name: iob_percpu_free
+ *
+ * Description:
+ *   Put a free I/O buffer in the cache of the current CPU.  Returns false
+ *   if the buffer must go to the global free list instead.
+ *
+ ****************************************************************************/
+
+bool iob_percpu_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_percpu_flush
+ *
+ * Description:
+ *   Return the I/O buffers cached by all CPUs to the global free list,
+ *   registering a waiter if wait is true.  Must be called from the
+ *   critical section.
+ *
+ ****************************************************************************/
+
+int iob_percpu_flush(bool wait);
+
+/****************************************************************************
+ * Name: iob_percpu_waitdone
+ *
+ * Description:
+ *   Undo the registration of a waiter by iob_percpu_flush().
+ *
+ ****************************************************************************/
+
+void iob_percpu_waitdone(void);
+
+/****************************************************************************
+ * Name: iob_percpu_navail
+ *
+ * Description:
+ *   Return the number of free I/O buffers in the caches of all CPUs, for
+ *   the statistics only.
+ *
+ ****************************************************************************/
+
+int iob_percpu_navail(void);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
@@ -95,6 +95,7 @@ static FAR struct iob_s *iob_alloc_committed(void)
       iob->io_len    = 0;    /* Length of the data in the entry */
       iob->io_offset = 0;    /* Offset to the beginning of data */
       iob->io_pktlen = 0;    /* Total length of the packet */
+      IOB_OFFLOAD_RESET(iob);
     }
 
   leave_critical_section(flags);
@@ -117,6 +118,9 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   FAR sem_t *sem;
   clock_t start;
   int ret = OK;
+#ifdef CONFIG_IOB_PERCPU
+  bool waiter = false;
+#endif
 
 #if CONFIG_IOB_THROTTLE > 0
   /* Select the semaphore count to check. */
@@ -140,6 +144,22 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
   start = clock_systime_ticks();
   iob   = iob_tryalloc(throttled);
+
+#ifdef CONFIG_IOB_PERCPU
+  if (iob == NULL)
+    {
+      /* Return the buffers cached by the other CPUs before waiting, no
+       * buffer is cached any more until we are done.
+       */
+
+      waiter = true;
+      if (iob_percpu_flush(true) > 0)
+        {
+          iob = iob_tryalloc(throttled);
+        }
+    }
+#endif
+
   while (ret == OK && iob == NULL)
     {
       /* If not successful, then the semaphore count was less than or equal
@@ -168,6 +188,13 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
         }
     }
 
+#ifdef CONFIG_IOB_PERCPU
+  if (waiter)
+    {
+      iob_percpu_waitdone();
+    }
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -208,6 +235,18 @@ static void iob_free_dynamic(FAR void *data)
 
 FAR struct iob_s *iob_timedalloc(bool throttled, unsigned int timeout)
 {
+#ifdef CONFIG_IOB_PERCPU
+  FAR struct iob_s *iob;
+
+  /* Try the cache of this CPU before locking the free list */
+
+  iob = iob_percpu_tryalloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
   /* Were we called from the interrupt level? */
 
   if (up_interrupt_context() || sched_idletask() || timeout == 0)
@@ -254,6 +293,18 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   FAR sem_t *sem;
 #endif
 
+#ifdef CONFIG_IOB_PERCPU
+  /* Take the I/O buffer from the cache of this CPU, which is refilled
+   * from the free list in batches.
+   */
+
+  iob = iob_percpu_tryalloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   /* Select the semaphore count to check. */
 
@@ -316,6 +367,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
           iob->io_len    = 0;    /* Length of the data in the entry */
           iob->io_offset = 0;    /* Offset to the beginning of data */
           iob->io_pktlen = 0;    /* Total length of the packet */
+          IOB_OFFLOAD_RESET(iob);
           return iob;
         }
     }
@@ -358,6 +410,7 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_offset  = 0;                /* Offset to the beginning of data */
       iob->io_bufsize = size;             /* Total length of the iob buffer */
       iob->io_pktlen  = 0;                /* Total length of the packet */
+      IOB_OFFLOAD_RESET(iob);
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ROUNDUP((uintptr_t)(iob + 1),
                                                CONFIG_IOB_ALIGNMENT);
@@ -404,6 +457,7 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_offset  = 0;       /* Offset to the beginning of data */
       iob->io_bufsize = size;    /* Total length of the iob buffer */
       iob->io_pktlen  = 0;       /* Total length of the packet */
+      IOB_OFFLOAD_RESET(iob);
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
     }
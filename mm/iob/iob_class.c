@@ -0,0 +1,363 @@
+/****************************************************************************
+ * mm/iob/iob_class.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_CLASSES
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The classes are ordered by size around the default buffers */
+
+#if CONFIG_IOB_SMALL_BUFSIZE >= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_SMALL_BUFSIZE must be less than CONFIG_IOB_BUFSIZE
+#endif
+
+#if CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_LARGE_BUFSIZE must be greater than CONFIG_IOB_BUFSIZE
+#endif
+
+#if CONFIG_IOB_JUMBO_BUFSIZE <= CONFIG_IOB_LARGE_BUFSIZE
+#  error CONFIG_IOB_JUMBO_BUFSIZE must exceed CONFIG_IOB_LARGE_BUFSIZE
+#endif
+
+/* Each buffer is an iob_s followed by its payload, both aligned to
+ * CONFIG_IOB_ALIGNMENT and to the alignment of the iob_s itself.
+ */
+
+#define IOB_CLASS_ALIGN        MAX(CONFIG_IOB_ALIGNMENT, sizeof(uintptr_t))
+#define IOB_CLASS_HDRSIZE      ROUNDUP(sizeof(struct iob_s), IOB_CLASS_ALIGN)
+#define IOB_CLASS_SLOTSIZE(s)  (IOB_CLASS_HDRSIZE + \
+                                ROUNDUP(s, IOB_CLASS_ALIGN))
+#define IOB_CLASS_POOLSIZE(s, n) \
+  (IOB_CLASS_SLOTSIZE(s) * (n) + IOB_CLASS_ALIGN - 1)
+
+#ifdef IOB_SECTION
+#  define IOB_CLASS_POOL(name, s, n) \
+  static uint8_t name[IOB_CLASS_POOLSIZE(s, n)] locate_data(IOB_SECTION)
+#else
+#  define IOB_CLASS_POOL(name, s, n) \
+  static uint8_t name[IOB_CLASS_POOLSIZE(s, n)]
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+IOB_CLASS_POOL(g_iob_small_pool, CONFIG_IOB_SMALL_BUFSIZE,
+               CONFIG_IOB_SMALL_NBUFFERS);
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+IOB_CLASS_POOL(g_iob_large_pool, CONFIG_IOB_LARGE_BUFSIZE,
+               CONFIG_IOB_LARGE_NBUFFERS);
+#endif
+
+#if CONFIG_IOB_JUMBO_NBUFFERS > 0
+IOB_CLASS_POOL(g_iob_jumbo_pool, CONFIG_IOB_JUMBO_BUFSIZE,
+               CONFIG_IOB_JUMBO_NBUFFERS);
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct iob_class_s g_iob_classes[IOB_NCLASSES] =
+{
+  {
+    NULL, CONFIG_IOB_SMALL_BUFSIZE
+  },
+  {
+    NULL, CONFIG_IOB_LARGE_BUFSIZE
+  },
+  {
+    NULL, CONFIG_IOB_JUMBO_BUFSIZE
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_class_setup
+ *
+ * Description:
+ *   Carve the buffers of a class out of its pool and add them to the free
+ *   list of the class.
+ *
+ ****************************************************************************/
+
+static void iob_class_setup(FAR struct iob_class_s *ioc, FAR uint8_t *pool,
+                            int nbuffers)
+{
+  uintptr_t buf = ROUNDUP((uintptr_t)pool, IOB_CLASS_ALIGN);
+  int i;
+
+  for (i = 0; i < nbuffers; i++)
+    {
+      FAR struct iob_s *iob;
+
+      iob = (FAR struct iob_s *)(buf + i * IOB_CLASS_SLOTSIZE(ioc->bufsize));
+      iob->io_bufsize = ioc->bufsize;
+      iob->io_free    = NULL;
+      iob->io_data    = (FAR uint8_t *)iob + IOB_CLASS_HDRSIZE;
+      iob->io_flink   = ioc->freelist;
+      ioc->freelist   = iob;
+    }
+
+  ioc->ntotal = nbuffers;
+  ioc->nfree  = nbuffers;
+}
+
+/****************************************************************************
+ * Name: iob_class_tryalloc
+ *
+ * Description:
+ *   Take the buffer at the head of the free list of a class.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_class_tryalloc(FAR struct iob_class_s *ioc)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  iob = ioc->freelist;
+  if (iob != NULL)
+    {
+      ioc->freelist = iob->io_flink;
+      ioc->nfree--;
+      ioc->nalloc++;
+    }
+  else
+    {
+      ioc->nmiss++;
+    }
+
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      IOB_OFFLOAD_RESET(iob);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_class_bestfit
+ *
+ * Description:
+ *   Take the smallest free buffer of at least 'size' and less than 'limit'
+ *   bytes, moving to the next larger one when a class is exhausted.  The
+ *   default buffers come between the small and the large class.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_class_bestfit(unsigned int size,
+                                           unsigned int limit,
+                                           bool throttled)
+{
+  FAR struct iob_class_s *ioc;
+  FAR struct iob_s *iob;
+  int i;
+
+  for (i = 0; i < IOB_NCLASSES; i++)
+    {
+      ioc = &g_iob_classes[i];
+
+      if (i == IOB_CLASS_LARGE && size <= CONFIG_IOB_BUFSIZE &&
+          CONFIG_IOB_BUFSIZE < limit)
+        {
+          iob = iob_tryalloc(throttled);
+          if (iob != NULL)
+            {
+              return iob;
+            }
+        }
+
+      if (ioc->bufsize >= limit)
+        {
+          break;
+        }
+
+      if (ioc->ntotal > 0 && size <= ioc->bufsize)
+        {
+          iob = iob_class_tryalloc(ioc);
+          if (iob != NULL)
+            {
+              return iob;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the free lists of the I/O buffer size classes.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void)
+{
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  iob_class_setup(&g_iob_classes[IOB_CLASS_SMALL], g_iob_small_pool,
+                  CONFIG_IOB_SMALL_NBUFFERS);
+#endif
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  iob_class_setup(&g_iob_classes[IOB_CLASS_LARGE], g_iob_large_pool,
+                  CONFIG_IOB_LARGE_NBUFFERS);
+#endif
+#if CONFIG_IOB_JUMBO_NBUFFERS > 0
+  iob_class_setup(&g_iob_classes[IOB_CLASS_JUMBO], g_iob_jumbo_pool,
+                  CONFIG_IOB_JUMBO_NBUFFERS);
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_class_free
+ *
+ * Description:
+ *   Return an I/O buffer to the free list of its size class.
+ *
+ ****************************************************************************/
+
+void iob_class_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_class_s *ioc = g_iob_classes;
+  irqstate_t flags;
+
+  while (ioc->bufsize != iob->io_bufsize)
+    {
+      ioc++;
+      DEBUGASSERT(ioc < &g_iob_classes[IOB_NCLASSES]);
+    }
+
+  flags = enter_critical_section();
+
+  iob->io_flink = ioc->freelist;
+  ioc->freelist = iob;
+  ioc->nfree++;
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate the smallest free I/O buffer that holds 'size' bytes in
+ *   one piece, from the size classes and from the default buffers, without
+ *   waiting.  The throttle only applies to the default buffers.
+ *
+ * Returned Value:
+ *   The I/O buffer, or NULL if no buffer of that size is free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled)
+{
+  return iob_class_bestfit(size, UINT_MAX, throttled);
+}
+
+/****************************************************************************
+ * Name: iob_tryshrink
+ *
+ * Description:
+ *   Copy a packet held in a single I/O buffer, headroom included, to a
+ *   free buffer of a smaller size class.  The original buffer is left
+ *   unchanged.
+ *
+ * Returned Value:
+ *   The copy, or NULL if the packet is in a chain or no smaller buffer
+ *   that holds it is free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryshrink(FAR const struct iob_s *iob, bool throttled)
+{
+  FAR struct iob_s *copy;
+  unsigned int size;
+
+  size = iob->io_offset + iob->io_len;
+  if (iob->io_flink != NULL || size >= IOB_BUFSIZE(iob))
+    {
+      return NULL;
+    }
+
+  copy = iob_class_bestfit(size, IOB_BUFSIZE(iob), throttled);
+  if (copy == NULL)
+    {
+      return NULL;
+    }
+
+  memcpy(copy->io_data, iob->io_data, size);
+  copy->io_offset = iob->io_offset;
+  copy->io_len    = iob->io_len;
+  copy->io_pktlen = iob->io_pktlen;
+#ifdef CONFIG_IOB_OFFLOAD
+  copy->io_csumstart = iob->io_csumstart;
+  copy->io_csumoff   = iob->io_csumoff;
+  copy->io_gsosize   = iob->io_gsosize;
+  copy->io_offload   = iob->io_offload;
+#endif
+
+  return copy;
+}
+
+#endif /* CONFIG_IOB_CLASSES */
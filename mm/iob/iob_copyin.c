@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
@@ -183,11 +184,25 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
            * Copy as many bytes as possible. Block if we're allowed.
            */
 
-          if (can_block)
+          next = NULL;
+
+#ifdef CONFIG_IOB_CLASSES
+          /* Continue a long copy in one large buffer if there is one free,
+           * rather than in a chain of default buffers.
+           */
+
+          if (len > CONFIG_IOB_BUFSIZE)
+            {
+              next = iob_tryalloc_size(MIN(len, CONFIG_IOB_LARGE_BUFSIZE),
+                                       throttled);
+            }
+#endif
+
+          if (next == NULL && can_block)
             {
               next = iob_alloc(throttled);
             }
-          else
+          else if (next == NULL)
             {
               next = iob_tryalloc(throttled);
             }
@@ -68,17 +68,16 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: iob_free
+ * Name: iob_free_global
  *
  * Description:
- *   Free the I/O buffer at the head of a buffer chain returning it to the
- *   free list.  The link to  the next I/O buffer in the chain is return.
+ *   Return an I/O buffer of the default size to the global free list, or
+ *   commit it to a task that is waiting for one.
  *
  ****************************************************************************/
 
-FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+void iob_free_global(FAR struct iob_s *iob)
 {
-  FAR struct iob_s *next = iob->io_flink;
   irqstate_t flags;
 #ifdef CONFIG_IOB_NOTIFIER
   int16_t navail;
@@ -87,48 +86,6 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
   bool committed_thottled = false;
 #endif
 
-  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
-          iob, iob->io_pktlen, iob->io_len, next);
-
-  /* Copy the data that only exists in the head of a I/O buffer chain into
-   * the next entry.
-   */
-
-  if (next != NULL)
-    {
-      /* Copy and decrement the total packet length, being careful to
-       * do nothing too crazy.
-       */
-
-      if (iob->io_pktlen > iob->io_len)
-        {
-          /* Adjust packet length and move it to the next entry */
-
-          next->io_pktlen = iob->io_pktlen - iob->io_len;
-          DEBUGASSERT(next->io_pktlen >= next->io_len);
-        }
-      else
-        {
-          /* This can only happen if the free entry isn't first entry in the
-           * chain...
-           */
-
-          next->io_pktlen = 0;
-        }
-
-      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
-              next, next->io_pktlen, next->io_len);
-    }
-
-#ifdef CONFIG_IOB_ALLOC
-  if (iob->io_free != NULL)
-    {
-      iob->io_free(iob->io_data);
-      kmm_free(iob);
-      return next;
-    }
-#endif
-
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
@@ -234,6 +191,83 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
       iob_notifier_signal();
     }
 #endif
+}
+
+/****************************************************************************
+ * Name: iob_free
+ *
+ * Description:
+ *   Free the I/O buffer at the head of a buffer chain returning it to the
+ *   free list.  The link to  the next I/O buffer in the chain is return.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next = iob->io_flink;
+
+  iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
+          iob, iob->io_pktlen, iob->io_len, next);
+
+  /* Copy the data that only exists in the head of a I/O buffer chain into
+   * the next entry.
+   */
+
+  if (next != NULL)
+    {
+      /* Copy and decrement the total packet length, being careful to
+       * do nothing too crazy.
+       */
+
+      if (iob->io_pktlen > iob->io_len)
+        {
+          /* Adjust packet length and move it to the next entry */
+
+          next->io_pktlen = iob->io_pktlen - iob->io_len;
+          DEBUGASSERT(next->io_pktlen >= next->io_len);
+        }
+      else
+        {
+          /* This can only happen if the free entry isn't first entry in the
+           * chain...
+           */
+
+          next->io_pktlen = 0;
+        }
+
+      iobinfo("next=%p io_pktlen=%u io_len=%u\n",
+              next, next->io_pktlen, next->io_len);
+    }
+
+#ifdef CONFIG_IOB_ALLOC
+  if (iob->io_free != NULL)
+    {
+      iob->io_free(iob->io_data);
+      kmm_free(iob);
+      return next;
+    }
+#endif
+
+#ifdef CONFIG_IOB_CLASSES
+  /* Buffers of the other sizes go back to their own class */
+
+  if (IOB_BUFSIZE(iob) != CONFIG_IOB_BUFSIZE)
+    {
+      iob_class_free(iob);
+      return next;
+    }
+#endif
+
+#ifdef CONFIG_IOB_PERCPU
+  /* Keep the I/O buffer in the cache of this CPU if possible */
+
+  if (iob_percpu_free(iob))
+    {
+      return next;
+    }
+#endif
+
+  iob_free_global(iob);
 
   /* And return the I/O buffer after the one that was freed */
 
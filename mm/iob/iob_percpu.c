@@ -0,0 +1,473 @@
+/****************************************************************************
+ * mm/iob/iob_percpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_PERCPU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IOB_PERCPU_MAX  (2 * CONFIG_IOB_PERCPU_BATCH)
+
+#if IOB_PERCPU_MAX * CONFIG_SMP_NCPUS > CONFIG_IOB_NBUFFERS / 2
+#  error The per-CPU caches can hold more than half of the I/O buffers
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The free I/O buffers cached by one CPU.  The lock is only contended
+ * when a task flushes the caches of all CPUs before waiting for a buffer.
+ * It nests inside the critical section, never the other way around.
+ */
+
+struct iob_percpu_s
+{
+  spinlock_t lock;
+  FAR struct iob_s *freelist;
+  int nfree;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_percpu_s g_iob_percpu[CONFIG_SMP_NCPUS];
+
+/* The number of tasks flushing the caches before waiting for a buffer.
+ * While it is not zero, the freed buffers are not cached.
+ */
+
+static atomic_int g_iob_percpu_nwaiters;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_percpu_pop
+ *
+ * Description:
+ *   Take an I/O buffer from a cache.  The cache must be locked.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_percpu_pop(FAR struct iob_percpu_s *pcpu)
+{
+  FAR struct iob_s *iob = pcpu->freelist;
+
+  if (iob != NULL)
+    {
+      pcpu->freelist = iob->io_flink;
+      pcpu->nfree--;
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_refill
+ *
+ * Description:
+ *   Move up to a batch of I/O buffers from the global free list to the
+ *   cache of a CPU and take one of them.  The buffers are accounted as
+ *   allocated, the same way as iob_tryalloc() does one by one.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_percpu_refill(FAR struct iob_percpu_s *pcpu,
+                                           bool throttled)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int navail;
+  int n;
+
+  flags = enter_critical_section();
+  spin_lock(&pcpu->lock);
+
+  navail = g_iob_sem.semcount;
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled)
+    {
+      navail = MIN(navail, g_throttle_sem.semcount);
+    }
+#endif
+
+  /* Take a single buffer while a task is waiting, it would not see the
+   * rest of the batch in this cache.
+   */
+
+  if (atomic_load(&g_iob_percpu_nwaiters) > 0)
+    {
+      navail = MIN(navail, 1);
+    }
+
+  for (n = 0; n < MIN(navail, CONFIG_IOB_PERCPU_BATCH); n++)
+    {
+      iob = g_iob_freelist;
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      g_iob_freelist = iob->io_flink;
+      iob->io_flink  = pcpu->freelist;
+      pcpu->freelist = iob;
+    }
+
+  pcpu->nfree        += n;
+  g_iob_sem.semcount -= n;
+  DEBUGASSERT(g_iob_sem.semcount >= 0);
+
+#if CONFIG_IOB_THROTTLE > 0
+  if (g_throttle_sem.semcount > 0)
+    {
+      g_throttle_sem.semcount -= MIN(n, g_throttle_sem.semcount);
+    }
+#endif
+
+  iob = iob_percpu_pop(pcpu);
+  spin_unlock(&pcpu->lock);
+  leave_critical_section(flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_drain
+ *
+ * Description:
+ *   Return a batch of I/O buffers from a cache to the global free list.
+ *   The batch is added at once unless tasks are waiting for buffers, in
+ *   which case each one is committed to them by iob_free_global().
+ *
+ ****************************************************************************/
+
+static void iob_percpu_drain(FAR struct iob_s *head, FAR struct iob_s *tail,
+                             int n)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+#if CONFIG_IOB_THROTTLE > 0
+  if (g_iob_sem.semcount >= 0 && g_throttle_sem.semcount >= 0)
+#else
+  if (g_iob_sem.semcount >= 0)
+#endif
+    {
+      tail->io_flink = g_iob_freelist;
+      g_iob_freelist = head;
+
+      while (n-- > 0)
+        {
+          g_iob_sem.semcount++;
+#if CONFIG_IOB_THROTTLE > 0
+          if (g_iob_sem.semcount > CONFIG_IOB_THROTTLE)
+            {
+              g_throttle_sem.semcount++;
+            }
+#endif
+        }
+
+      DEBUGASSERT(g_iob_sem.semcount <= CONFIG_IOB_NBUFFERS);
+      leave_critical_section(flags);
+
+#ifdef CONFIG_IOB_NOTIFIER
+      iob_notifier_signal();
+#endif
+      return;
+    }
+
+  leave_critical_section(flags);
+
+  tail->io_flink = NULL;
+  for (; head != NULL; head = next)
+    {
+      next = head->io_flink;
+      iob_free_global(head);
+    }
+}
+
+/****************************************************************************
+ * Name: iob_percpu_detach
+ *
+ * Description:
+ *   Detach the first n I/O buffers of a cache.  The cache must be locked
+ *   and hold at least n buffers.  Returns the head and sets *tail.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_percpu_detach(FAR struct iob_percpu_s *pcpu,
+                                           int n, FAR struct iob_s **tail)
+{
+  FAR struct iob_s *head = pcpu->freelist;
+  int i;
+
+  DEBUGASSERT(n > 0 && n <= pcpu->nfree);
+
+  *tail = head;
+  for (i = 1; i < n; i++)
+    {
+      *tail = (*tail)->io_flink;
+    }
+
+  pcpu->freelist = (*tail)->io_flink;
+  pcpu->nfree   -= n;
+  return head;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_percpu_tryalloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the global free list if it is empty.
+ *
+ * Returned Value:
+ *   The I/O buffer, or NULL if there is none available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_percpu_tryalloc(bool throttled)
+{
+  FAR struct iob_percpu_s *pcpu;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* The cached buffers are part of the reserve of the unthrottled
+   * allocations when the global pool is at the throttle.
+   */
+
+  if (throttled && g_throttle_sem.semcount <= 0)
+    {
+      return NULL;
+    }
+#endif
+
+  flags = up_irq_save();
+  pcpu  = &g_iob_percpu[this_cpu()];
+
+  spin_lock(&pcpu->lock);
+  iob = iob_percpu_pop(pcpu);
+  spin_unlock(&pcpu->lock);
+
+  if (iob == NULL)
+    {
+      iob = iob_percpu_refill(pcpu, throttled);
+    }
+
+  up_irq_restore(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      IOB_OFFLOAD_RESET(iob);
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_free
+ *
+ * Description:
+ *   Put a free I/O buffer in the cache of the current CPU, returning a
+ *   batch to the global free list if the cache is full.  If a task started
+ *   to wait for a buffer meanwhile, the whole cache is returned instead.
+ *
+ * Returned Value:
+ *   True if the buffer was taken, false if it must go to the global free
+ *   list because a task is waiting for a buffer.
+ *
+ ****************************************************************************/
+
+bool iob_percpu_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_percpu_s *pcpu;
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  irqstate_t flags;
+  int n = 0;
+
+  if (atomic_load(&g_iob_percpu_nwaiters) > 0)
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  pcpu  = &g_iob_percpu[this_cpu()];
+  spin_lock(&pcpu->lock);
+
+  iob->io_flink  = pcpu->freelist;
+  pcpu->freelist = iob;
+  pcpu->nfree++;
+
+  /* A waiter registers before it flushes the caches under their locks, so
+   * either its flush sees this buffer or this check sees the waiter.
+   */
+
+  if (atomic_load(&g_iob_percpu_nwaiters) > 0)
+    {
+      n = pcpu->nfree;
+    }
+  else if (pcpu->nfree >= IOB_PERCPU_MAX)
+    {
+      n = CONFIG_IOB_PERCPU_BATCH;
+    }
+
+  if (n > 0)
+    {
+      head = iob_percpu_detach(pcpu, n, &tail);
+    }
+
+  spin_unlock(&pcpu->lock);
+  up_irq_restore(flags);
+
+  if (head != NULL)
+    {
+      iob_percpu_drain(head, tail, n);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_flush
+ *
+ * Description:
+ *   Return the I/O buffers cached by all CPUs to the global free list.  A
+ *   task calls this before waiting for a buffer, with wait set, so that no
+ *   buffer stays stranded in a cache while it waits.  It must then call
+ *   iob_percpu_waitdone() when it stops waiting.
+ *
+ *   This must be called from the critical section.
+ *
+ * Returned Value:
+ *   The number of buffers returned to the global free list.
+ *
+ ****************************************************************************/
+
+int iob_percpu_flush(bool wait)
+{
+  FAR struct iob_percpu_s *pcpu;
+  FAR struct iob_s *head;
+  FAR struct iob_s *tail;
+  int total = 0;
+  int n;
+  int i;
+
+  if (wait)
+    {
+      atomic_fetch_add(&g_iob_percpu_nwaiters, 1);
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      pcpu = &g_iob_percpu[i];
+      head = NULL;
+
+      spin_lock(&pcpu->lock);
+      n = pcpu->nfree;
+      if (n > 0)
+        {
+          head = iob_percpu_detach(pcpu, n, &tail);
+        }
+
+      spin_unlock(&pcpu->lock);
+
+      if (head != NULL)
+        {
+          iob_percpu_drain(head, tail, n);
+          total += n;
+        }
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_waitdone
+ *
+ * Description:
+ *   Undo the registration of a waiter by iob_percpu_flush().
+ *
+ ****************************************************************************/
+
+void iob_percpu_waitdone(void)
+{
+  atomic_fetch_sub(&g_iob_percpu_nwaiters, 1);
+}
+
+/****************************************************************************
+ * Name: iob_percpu_navail
+ *
+ * Description:
+ *   Return the number of free I/O buffers in the caches of all CPUs.  This
+ *   is a snapshot for the statistics, the caches are not locked.
+ *
+ ****************************************************************************/
+
+int iob_percpu_navail(void)
+{
+  int navail = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      navail += g_iob_percpu[i].nfree;
+    }
+
+  return navail;
+}
+
+#endif /* CONFIG_IOB_PERCPU */
@@ -26,6 +26,9 @@
 
 #include <nuttx/config.h>
 
+#include <errno.h>
+
+#include <nuttx/irq.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -67,6 +70,10 @@ void iob_getstats(FAR struct iob_stats_s *stats)
       stats->nwait = 0;
     }
 
+#ifdef CONFIG_IOB_PERCPU
+  stats->nfree += iob_percpu_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   nxsem_get_value(&g_throttle_sem, &stats->nthrottle);
   if (stats->nthrottle < 0)
@@ -80,5 +87,46 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     }
 }
 
+/****************************************************************************
+ * Name: iob_getclassstats
+ *
+ * Description:
+ *   Return the usage statistics of an I/O buffer size class.  The classes
+ *   are numbered from zero by increasing buffer size.
+ *
+ * Input Parameters:
+ *   index - The number of the class
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, -ENOENT if there is no such class.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CLASSES
+int iob_getclassstats(int index, FAR struct iob_class_stats_s *stats)
+{
+  FAR struct iob_class_s *ioc;
+  irqstate_t flags;
+
+  if (index < 0 || index >= IOB_NCLASSES)
+    {
+      return -ENOENT;
+    }
+
+  ioc   = &g_iob_classes[index];
+  flags = enter_critical_section();
+
+  stats->bufsize = ioc->bufsize;
+  stats->ntotal  = ioc->ntotal;
+  stats->nfree   = ioc->nfree;
+  stats->nalloc  = ioc->nalloc;
+  stats->nmiss   = ioc->nmiss;
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
         * !CONFIG_FS_PROCFS_EXCLUDE_IOBINFO */
@@ -31,6 +31,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
@@ -123,6 +124,15 @@
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
 
+/* The per-CPU cache keeps one magazine for every chunk size that is a
+ * multiple of MM_ALIGN, up to CONFIG_MM_HEAP_PERCPU_CACHE_MAXSIZE.
+ */
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+#  define MM_CACHE_NCLASSES (CONFIG_MM_HEAP_PERCPU_CACHE_MAXSIZE / MM_ALIGN)
+#  define MM_CACHE_BATCH    (CONFIG_MM_HEAP_PERCPU_CACHE_DEPTH / 2)
+#endif
+
 /* Due to alignment, the lowest two bits of valid chunk size are always
  * zero, thus the two bits are reused to depict allocation status: bit
  * 0 depicts the allocation state of current chunk, and bit 1 depicts that
@@ -217,6 +227,16 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+/* This describes a per-CPU magazine of cached chunks of one size */
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+struct mm_magazine_s
+{
+  FAR struct mm_delaynode_s *head;          /* Cached chunks, LIFO order */
+  size_t count;                             /* Number of cached chunks */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -261,6 +281,15 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+  /* Per-CPU magazines of allocated chunks kept for reuse.  The lock of a
+   * CPU is only contended when another CPU flushes its magazines.
+   */
+
+  struct mm_magazine_s mm_cache[CONFIG_SMP_NCPUS][MM_CACHE_NCLASSES];
+  spinlock_t mm_cachelock[CONFIG_SMP_NCPUS];
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
@@ -297,10 +326,24 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
                 FAR void *arg);
 
+/* Functions contained in mm_malloc.c ***************************************/
+
+FAR struct mm_allocnode_s *mm_allocchunk(FAR struct mm_heap_s *heap,
+                                         size_t alignsize);
+
 /* Functions contained in mm_free.c *****************************************/
 
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+bool mm_cache_flush(FAR struct mm_heap_s *heap);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -0,0 +1,398 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/kasan.h>
+#include <nuttx/sched_note.h>
+
+#include "mm_heap/mm.h"
+
+/* The magazines are accessed with the interrupts disabled, which is not
+ * possible from the user space heap of a protected or kernel build: there
+ * the cache is always bypassed.
+ */
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_drain
+ *
+ * Description:
+ *   Return a list of chunks detached from the magazine 'ndx' of a CPU to
+ *   the heap under a single acquisition of the MM mutex.
+ *
+ * Returned Value:
+ *   true if the chunks were returned, false if they were put back.
+ *
+ ****************************************************************************/
+
+static bool mm_cache_drain(FAR struct mm_heap_s *heap,
+                           FAR struct mm_delaynode_s *chunk,
+                           int cpu, size_t ndx)
+{
+  FAR struct mm_delaynode_s *next;
+  FAR struct mm_magazine_s *mag;
+  irqstate_t flags;
+  size_t count = 1;
+
+  if (mm_lock(heap) < 0)
+    {
+      /* The mutex can't be taken here (e.g. in an interrupt handler).  The
+       * chunks were already reported as freed, so put them back instead of
+       * going through mm_delayfree(): the next drain takes them.
+       */
+
+      for (next = chunk; next->flink != NULL; next = next->flink)
+        {
+          count++;
+        }
+
+      flags = spin_lock_irqsave(&heap->mm_cachelock[cpu]);
+
+      mag = &heap->mm_cache[cpu][ndx];
+      next->flink = mag->head;
+      mag->head   = chunk;
+      mag->count += count;
+
+      spin_unlock_irqrestore(&heap->mm_cachelock[cpu], flags);
+      return false;
+    }
+
+  while (chunk != NULL)
+    {
+      next = chunk->flink;
+      mm_freechunk(heap, (FAR struct mm_freenode_s *)
+                         ((FAR char *)chunk - MM_SIZEOF_ALLOCNODE));
+      chunk = next;
+    }
+
+  mm_unlock(heap);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cache_refill
+ *
+ * Description:
+ *   Allocate a batch of chunks under a single acquisition of the MM mutex.
+ *   The first one is returned, the others go to the magazine of this CPU.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_delaynode_s *
+mm_cache_refill(FAR struct mm_heap_s *heap, size_t alignsize, size_t ndx)
+{
+  FAR struct mm_delaynode_s *head = NULL;
+  FAR struct mm_delaynode_s *tail = NULL;
+  FAR struct mm_delaynode_s *chunk;
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_magazine_s *mag;
+  irqstate_t flags;
+  size_t count = 0;
+  int cpu;
+
+  if (mm_lock(heap) < 0)
+    {
+      return NULL;
+    }
+
+  while (count < MM_CACHE_BATCH)
+    {
+      node = mm_allocchunk(heap, alignsize);
+      if (node == NULL)
+        {
+          break;
+        }
+
+#if CONFIG_MM_BACKTRACE >= 0
+      node->pid = PID_MM_MEMPOOL;
+#endif
+
+      chunk = (FAR struct mm_delaynode_s *)
+              ((FAR char *)node + MM_SIZEOF_ALLOCNODE);
+      chunk->flink = head;
+      head = chunk;
+      if (tail == NULL)
+        {
+          tail = chunk;
+        }
+
+      count++;
+    }
+
+  mm_unlock(heap);
+
+  if (head == NULL)
+    {
+      return NULL;
+    }
+
+  chunk = head;
+  head  = head->flink;
+  if (head != NULL)
+    {
+      cpu   = this_cpu();
+      flags = spin_lock_irqsave(&heap->mm_cachelock[cpu]);
+
+      mag = &heap->mm_cache[cpu][ndx];
+      tail->flink = mag->head;
+      mag->head   = head;
+      mag->count += count - 1;
+
+      spin_unlock_irqrestore(&heap->mm_cachelock[cpu], flags);
+    }
+
+  return chunk;
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Take a chunk of 'alignsize' bytes from the magazine of this CPU,
+ *   refilling the magazine from the heap if it is empty.
+ *
+ * Input Parameters:
+ *   heap      - The heap to allocate from
+ *   alignsize - The chunk size, including the allocation header
+ *
+ * Returned Value:
+ *   The allocated memory, or NULL if the size is not cached or the heap
+ *   is exhausted.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *chunk;
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_magazine_s *mag;
+  FAR void *ret;
+  irqstate_t flags;
+  size_t nodesize;
+  size_t ndx;
+  int cpu;
+
+  ndx = alignsize / MM_ALIGN - 1;
+  if (ndx >= MM_CACHE_NCLASSES)
+    {
+      return NULL;
+    }
+
+  /* The task may migrate once this_cpu() is read, the magazine is still
+   * consistent as it is used under its lock.
+   */
+
+  cpu   = this_cpu();
+  flags = spin_lock_irqsave(&heap->mm_cachelock[cpu]);
+
+  mag   = &heap->mm_cache[cpu][ndx];
+  chunk = mag->head;
+  if (chunk != NULL)
+    {
+      mag->head = chunk->flink;
+      mag->count--;
+    }
+
+  spin_unlock_irqrestore(&heap->mm_cachelock[cpu], flags);
+
+  if (chunk == NULL)
+    {
+      chunk = mm_cache_refill(heap, alignsize, ndx);
+      if (chunk == NULL)
+        {
+          return NULL;
+        }
+    }
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)chunk - MM_SIZEOF_ALLOCNODE);
+  nodesize = MM_SIZEOF_NODE(node);
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node) && nodesize >= alignsize);
+
+  MM_ADD_BACKTRACE(heap, node);
+  sched_note_heap(NOTE_HEAP_ALLOC, heap, chunk, nodesize, heap->mm_curused);
+
+  ret = kasan_unpoison(chunk, nodesize - MM_ALLOCNODE_OVERHEAD);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  return ret;
+#else
+  return NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Put a chunk into the magazine of this CPU.  A full magazine is drained
+ *   to half of its depth, keeping the most recently freed chunks.
+ *
+ * Input Parameters:
+ *   heap - The heap the memory belongs to
+ *   mem  - The memory to free
+ *
+ * Returned Value:
+ *   true if the chunk was cached, false if its size is not cached.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *chunk = kasan_reset_tag(mem);
+  FAR struct mm_delaynode_s *drain = NULL;
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_magazine_s *mag;
+  irqstate_t flags;
+  size_t nodesize;
+  size_t ndx;
+  int cpu;
+  int i;
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)chunk - MM_SIZEOF_ALLOCNODE);
+  nodesize = MM_SIZEOF_NODE(node);
+  ndx = nodesize / MM_ALIGN - 1;
+  if (ndx >= MM_CACHE_NCLASSES)
+    {
+      return false;
+    }
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+  sched_note_heap(NOTE_HEAP_FREE, heap, mem, nodesize, heap->mm_curused);
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, MM_FREE_MAGIC, nodesize - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  kasan_poison(mem, nodesize - MM_ALLOCNODE_OVERHEAD);
+
+#if CONFIG_MM_BACKTRACE >= 0
+  node->pid = PID_MM_MEMPOOL;
+#endif
+
+  cpu   = this_cpu();
+  flags = spin_lock_irqsave(&heap->mm_cachelock[cpu]);
+
+  mag = &heap->mm_cache[cpu][ndx];
+  chunk->flink = mag->head;
+  mag->head    = chunk;
+  if (++mag->count >= CONFIG_MM_HEAP_PERCPU_CACHE_DEPTH)
+    {
+      for (i = 1; i < MM_CACHE_BATCH; i++)
+        {
+          chunk = chunk->flink;
+        }
+
+      drain        = chunk->flink;
+      chunk->flink = NULL;
+      mag->count   = MM_CACHE_BATCH;
+    }
+
+  spin_unlock_irqrestore(&heap->mm_cachelock[cpu], flags);
+
+  if (drain != NULL)
+    {
+      mm_cache_drain(heap, drain, cpu, ndx);
+    }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return all the chunks cached by all CPUs to the heap.
+ *
+ * Returned Value:
+ *   true if any chunk was returned.
+ *
+ ****************************************************************************/
+
+bool mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  bool ret = false;
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  FAR struct mm_delaynode_s *chunk;
+  FAR struct mm_magazine_s *mag;
+  irqstate_t flags;
+  size_t ndx;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          flags = spin_lock_irqsave(&heap->mm_cachelock[cpu]);
+
+          mag        = &heap->mm_cache[cpu][ndx];
+          chunk      = mag->head;
+          mag->head  = NULL;
+          mag->count = 0;
+
+          spin_unlock_irqrestore(&heap->mm_cachelock[cpu], flags);
+
+          if (chunk != NULL && mm_cache_drain(heap, chunk, cpu, ndx))
+            {
+              ret = true;
+            }
+        }
+    }
+
+#endif
+  return ret;
+}
@@ -113,6 +113,24 @@ static void mallinfo_task_handler(FAR struct mm_allocnode_s *node,
     }
 }
 
+static void fraginfo_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
+{
+  FAR struct mm_fraginfo_s *info = arg;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+  int ndx;
+
+  if (MM_NODE_IS_FREE(node))
+    {
+      ndx = flsl(nodesize) - 1;
+      info->nfree[ndx]++;
+      info->sfree[ndx] += nodesize;
+      if (nodesize > info->mxfree)
+        {
+          info->mxfree = nodesize;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -216,3 +234,17 @@ size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 
   return 0;
 }
+
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Walk the heap and return the histogram of the free chunk sizes.
+ *
+ ****************************************************************************/
+
+void mm_fraginfo(FAR struct mm_heap_s *heap, FAR struct mm_fraginfo_s *info)
+{
+  memset(info, 0, sizeof(*info));
+  mm_foreach(heap, fraginfo_handler, info);
+}
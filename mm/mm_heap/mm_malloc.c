@@ -157,63 +157,22 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
 }
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_allocchunk
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
- *
- *  8-byte alignment of the allocated data is assured.
+ *  Take the best fitting free chunk of at least 'alignsize' bytes out of
+ *  the nodelist, split off the remainder and mark it allocated.  The
+ *  caller must hold the MM mutex.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR struct mm_allocnode_s *mm_allocchunk(FAR struct mm_heap_s *heap,
+                                         size_t alignsize)
 {
   FAR struct mm_freenode_s *node;
-  size_t alignsize;
   size_t nodesize;
-  FAR void *ret = NULL;
   int ndx;
 
-  /* Free the delay list first */
-
-  free_delaylist(heap, false);
-
-#ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
-    {
-      ret = mempool_multiple_alloc(heap->mm_mpool, size);
-      if (ret != NULL)
-        {
-          return ret;
-        }
-    }
-#endif
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is aligned with MM_ALIGN and its size is at
-   * least MM_MIN_CHUNK.
-   */
-
-  if (size < MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD)
-    {
-      size = MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD;
-    }
-
-  alignsize = MM_ALIGN_UP(size + MM_ALLOCNODE_OVERHEAD);
-  if (alignsize < size)
-    {
-      /* There must have been an integer overflow */
-
-      return NULL;
-    }
-
-  DEBUGASSERT(alignsize >= MM_ALIGN);
-
-  /* We need to hold the MM mutex while we muck with the nodelist. */
-
-  DEBUGVERIFY(mm_lock(heap));
-
   /* Convert the request size into a nodelist index */
 
   ndx = mm_size2ndx(alignsize);
@@ -317,6 +276,80 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       /* Handle the case of an exact size match */
 
       node->size |= MM_ALLOC_BIT;
+    }
+
+  return (FAR struct mm_allocnode_s *)node;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_allocnode_s *node;
+  size_t alignsize;
+  FAR void *ret = NULL;
+
+  /* Free the delay list first */
+
+  free_delaylist(heap, false);
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+  if (heap->mm_mpool)
+    {
+      ret = mempool_multiple_alloc(heap->mm_mpool, size);
+      if (ret != NULL)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is aligned with MM_ALIGN and its size is at
+   * least MM_MIN_CHUNK.
+   */
+
+  if (size < MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD)
+    {
+      size = MM_MIN_CHUNK - MM_ALLOCNODE_OVERHEAD;
+    }
+
+  alignsize = MM_ALIGN_UP(size + MM_ALLOCNODE_OVERHEAD);
+  if (alignsize < size)
+    {
+      /* There must have been an integer overflow */
+
+      return NULL;
+    }
+
+  DEBUGASSERT(alignsize >= MM_ALIGN);
+
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+  /* Try the magazine of this CPU first, without taking the MM mutex */
+
+  ret = mm_cache_alloc(heap, alignsize);
+  if (ret != NULL)
+    {
+      return ret;
+    }
+#endif
+
+  /* We need to hold the MM mutex while we muck with the nodelist. */
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  node = mm_allocchunk(heap, alignsize);
+  if (node)
+    {
       ret = (FAR void *)((FAR char *)node + MM_SIZEOF_ALLOCNODE);
     }
 
@@ -324,7 +357,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   if (ret)
     {
-      sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, nodesize,
+      sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, MM_SIZEOF_NODE(node),
                       heap->mm_curused);
     }
 
@@ -333,7 +366,8 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   if (ret)
     {
       MM_ADD_BACKTRACE(heap, node);
-      ret = kasan_unpoison(ret, nodesize - MM_ALLOCNODE_OVERHEAD);
+      ret = kasan_unpoison(ret, MM_SIZEOF_NODE(node) -
+                                MM_ALLOCNODE_OVERHEAD);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
 #endif
@@ -351,6 +385,15 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_PERCPU_CACHE
+  /* Try again after returning the chunks cached by all CPUs */
+
+  else if (mm_cache_flush(heap))
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
 #ifdef CONFIG_DEBUG_MM
   else if (MM_INTERNAL_HEAP(heap))
     {
@@ -34,6 +34,7 @@
 #include <sched.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/param.h>
 
 #include <nuttx/arch.h>
@@ -424,6 +425,28 @@ static void mallinfo_handler(FAR void *ptr, size_t size, int used,
     }
 }
 
+/****************************************************************************
+ * Name: fraginfo_handler
+ ****************************************************************************/
+
+static void fraginfo_handler(FAR void *ptr, size_t size, int used,
+                             FAR void *user)
+{
+  FAR struct mm_fraginfo_s *info = user;
+  int ndx;
+
+  if (!used && size > 0)
+    {
+      ndx = flsl(size) - 1;
+      info->nfree[ndx]++;
+      info->sfree[ndx] += size;
+      if (size > info->mxfree)
+        {
+          info->mxfree = size;
+        }
+    }
+}
+
 /****************************************************************************
  * Name: mallinfo_task_handler
  ****************************************************************************/
@@ -1696,3 +1719,32 @@ size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
   return SIZE_MAX;
 }
+
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Walk the heap and return the histogram of the free chunk sizes.
+ *
+ ****************************************************************************/
+
+void mm_fraginfo(FAR struct mm_heap_s *heap, FAR struct mm_fraginfo_s *info)
+{
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  memset(info, 0, sizeof(*info));
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      DEBUGVERIFY(mm_lock(heap));
+      tlsf_walk_pool(heap->mm_heapstart[region], fraginfo_handler, info);
+      mm_unlock(heap);
+    }
+#undef region
+}
@@ -107,7 +107,7 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
 
   while (remain > 0)
     {
-      if (iob->io_len + iob->io_offset == CONFIG_IOB_BUFSIZE)
+      if (iob->io_len + iob->io_offset == IOB_BUFSIZE(iob))
         {
           if (iob->io_flink == NULL)
             {
@@ -122,7 +122,7 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
           iob = iob->io_flink;
         }
 
-      copyin = CONFIG_IOB_BUFSIZE -
+      copyin = IOB_BUFSIZE(iob) -
                (iob->io_len + iob->io_offset);
       if (copyin > remain)
         {
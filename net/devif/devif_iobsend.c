@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -34,6 +35,8 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
+#include "netdev/netdev.h"
+
 #ifdef CONFIG_MM_IOB
 
 /****************************************************************************
@@ -59,6 +62,9 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                    unsigned int len, unsigned int offset,
                    unsigned int target_offset)
 {
+#ifndef CONFIG_NET_IPFRAG
+  unsigned int maxlen;
+#endif
   int ret;
 
   if (dev == NULL)
@@ -74,7 +80,20 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  maxlen = NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Only TCP super-segments, which are segmented by the device or in
+   * software, may be larger than the MTU.
+   */
+
+  if ((dev->d_iob->io_offload & IOB_OFFLOAD_GSO) != 0)
+    {
+      maxlen = MAX(maxlen, netdev_gso_maxsize(dev));
+    }
+#endif
+
+  if (len + target_offset > maxlen)
     {
       ret = -EMSGSIZE;
       goto errout;
@@ -110,6 +129,15 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
   return dev->d_sndlen;
 
 errout:
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Do not leave the GSO mark to whatever is sent next */
+
+  if (dev != NULL && dev->d_iob != NULL)
+    {
+      dev->d_iob->io_offload = 0;
+    }
+#endif
+
   nerr("ERROR: devif_iob_send error: %d\n", ret);
   return ret;
 }
@@ -111,6 +111,17 @@ int devif_loopback(FAR struct net_driver_s *dev)
        pkt_input(dev);
 #endif
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+      /* A checksum left to the driver needs no completion on the way to
+       * ourself, the data can't have been corrupted.
+       */
+
+      if ((dev->d_iob->io_offload & IOB_OFFLOAD_CSUM_PARTIAL) != 0)
+        {
+          dev->d_iob->io_offload = IOB_OFFLOAD_CSUM_VALID;
+        }
+#endif
+
       /* We only accept IP packets of the configured type */
 
 #ifdef CONFIG_NET_IPv4
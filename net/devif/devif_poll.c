@@ -1170,10 +1170,17 @@ int devif_poll_out(FAR struct net_driver_s *dev,
 
   devif_out(dev);
 
-  bstop = devif_loopback(dev);
-  if (bstop)
+  /* A loopback device polled with a callback sends the packets itself,
+   * e.g. through an emulated lossy link.
+   */
+
+  if (callback == NULL || dev->d_lltype != NET_LL_LOOPBACK)
     {
-      return bstop;
+      bstop = devif_loopback(dev);
+      if (bstop)
+        {
+          return bstop;
+        }
     }
 
   if (callback)
@@ -297,6 +297,21 @@ uint16_t ipv4_build_header(FAR struct ipv4_hdr_s *ipv4, uint16_t total_len,
                            uint8_t tos, FAR struct ipv4_opt_s *opt);
 #endif
 
+/****************************************************************************
+ * Name: ipv4_alloc_ipid
+ *
+ * Description:
+ *   Allocate the identification of an outgoing IPv4 packet.
+ *
+ * Returned Value:
+ *   The IP ID in host byte order
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+uint16_t ipv4_alloc_ipid(void);
+#endif
+
 /****************************************************************************
  * Name: ipv6_build_header
  *
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <stdbool.h>
@@ -33,6 +34,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <netinet/udp.h>
+
 #include <nuttx/net/net.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/tcp.h>
@@ -1718,6 +1721,73 @@ static int inet_poll(FAR struct socket *psock, FAR struct pollfd *fds,
 #endif /* NET_TCP_HAVE_STACK || !NET_UDP_HAVE_STACK */
 }
 
+/****************************************************************************
+ * Name: inet_udp_sendto
+ *
+ * Description:
+ *   Send a UDP datagram, or a train of datagrams of the UDP_SEGMENT size
+ *   if the option is set on the socket and the data does not fit in one.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient, NULL for a connected socket
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+#ifdef NET_UDP_HAVE_STACK
+static ssize_t inet_udp_sendto(FAR struct socket *psock,
+                               FAR const void *buf, size_t len, int flags,
+                               FAR const struct sockaddr *to,
+                               socklen_t tolen)
+{
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR const uint8_t *ptr = buf;
+  size_t gso_size = conn->gso_size;
+  size_t nsent = 0;
+  ssize_t ret = OK;
+
+  if (gso_size > 0 && len > gso_size)
+    {
+      if (len > gso_size * UDP_MAX_SEGMENTS)
+        {
+          return -EINVAL;
+        }
+
+      /* Queue all the segments before the device gets a chance to poll */
+
+      net_lock();
+      while (nsent < len)
+        {
+          ret = psock_udp_sendto(psock, ptr + nsent,
+                                 MIN(len - nsent, gso_size),
+                                 flags, to, tolen);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nsent += ret;
+        }
+
+      net_unlock();
+      return nsent > 0 ? nsent : ret;
+    }
+#endif
+
+  return psock_udp_sendto(psock, buf, len, flags, to, tolen);
+}
+#endif
+
 /****************************************************************************
  * Name: inet_send
  *
@@ -1788,7 +1858,7 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
               /* UDP/IP packet send */
 
               ret = _SS_ISCONNECTED(conn->s_flags) ?
-                psock_udp_sendto(psock, buf, len, 0, NULL, 0) : -ENOTCONN;
+                inet_udp_sendto(psock, buf, len, 0, NULL, 0) : -ENOTCONN;
             }
 #endif /* NET_UDP_HAVE_STACK */
 
@@ -1796,7 +1866,7 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
           /* Only UDP/IP packet send */
 
           ret = _SS_ISCONNECTED(conn->s_flags) ?
-            psock_udp_sendto(psock, buf, len, 0, NULL, 0) : -ENOTCONN;
+            inet_udp_sendto(psock, buf, len, 0, NULL, 0) : -ENOTCONN;
 #else
           ret = -ENOSYS;
 #endif /* CONFIG_NET_6LOWPAN */
@@ -1903,12 +1973,12 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
     {
       /* UDP/IP packet sendto */
 
-      nsent = psock_udp_sendto(psock, buf, len, flags, to, tolen);
+      nsent = inet_udp_sendto(psock, buf, len, flags, to, tolen);
     }
 #endif /* NET_UDP_HAVE_STACK */
 
 #elif defined(NET_UDP_HAVE_STACK)
-  nsent = psock_udp_sendto(psock, buf, len, flags, to, tolen);
+  nsent = inet_udp_sendto(psock, buf, len, flags, to, tolen);
 #else
   nwarn("WARNING: UDP not available in this configuiration\n");
   nsent = -ENOSYS;
@@ -2312,6 +2382,16 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
         }
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The error queue only holds the MSG_ZEROCOPY completions */
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      return psock->s_type == SOCK_STREAM ?
+             tcp_zerocopy_recverr(psock, msg) : -EAGAIN;
+    }
+#endif
+
   /* Read from the network interface driver buffer.
    * Or perform the TCP/IP or UDP recv() operation.
    */
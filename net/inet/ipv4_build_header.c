@@ -46,6 +46,22 @@ static uint16_t g_ipid;
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ipv4_alloc_ipid
+ *
+ * Description:
+ *   Allocate the identification of an outgoing IPv4 packet.
+ *
+ * Returned Value:
+ *   The IP ID in host byte order
+ *
+ ****************************************************************************/
+
+uint16_t ipv4_alloc_ipid(void)
+{
+  return ++g_ipid;
+}
+
 /****************************************************************************
  * Name: ipv4_build_header
  *
@@ -71,15 +87,16 @@ uint16_t ipv4_build_header(FAR struct ipv4_hdr_s *ipv4, uint16_t total_len,
                            FAR const in_addr_t *dst_ip, uint8_t ttl,
                            uint8_t tos, FAR struct ipv4_opt_s *opt)
 {
+  uint16_t ipid = ipv4_alloc_ipid();
+
   /* Initialize the IP header. */
 
   ipv4->vhl         = 0x45;   /* orginal initial value like this */
   ipv4->tos         = tos;
   ipv4->len[0]      = (total_len >> 8);
   ipv4->len[1]      = (total_len & 0xff);
-  ++g_ipid;
-  ipv4->ipid[0]     = g_ipid >> 8;
-  ipv4->ipid[1]     = g_ipid & 0xff;
+  ipv4->ipid[0]     = ipid >> 8;
+  ipv4->ipid[1]     = ipid & 0xff;
   ipv4->ipoffset[0] = IP_FLAG_DONTFRAG >> 8;
   ipv4->ipoffset[1] = IP_FLAG_DONTFRAG & 0xff;
   ipv4->ttl         = ttl;
@@ -106,7 +123,7 @@ uint16_t ipv4_build_header(FAR struct ipv4_hdr_s *ipv4, uint16_t total_len,
   ipv4->ipchksum    = ~ipv4_chksum(ipv4);
 #endif
 
-  ninfo("IPv4 Packet: ipid:%d, length: %d\n", g_ipid, total_len);
+  ninfo("IPv4 Packet: ipid:%d, length: %d\n", ipid, total_len);
 
   return (ipv4->vhl & IPv4_HLMASK) << 2;
 }
@@ -299,6 +299,58 @@ void ipfwd_dropstats(FAR struct forward_s *fwd);
 int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4);
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flowcache_lookup
+ *
+ * Description:
+ *   Look up the flow of an IPv4 packet to be forwarded.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received
+ *   ipv4  - A pointer to the IPv4 header in within the IPv4 packet
+ *
+ * Returned Value:
+ *   The forwarding device of the flow if it is cached, NULL otherwise.
+ *   The packet of a cached flow is accepted by the FORWARD filter chain.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct net_driver_s *
+ipv4_flowcache_lookup(FAR struct net_driver_s *dev,
+                      FAR const struct ipv4_hdr_s *ipv4);
+#else
+#  define ipv4_flowcache_lookup(dev, ipv4) NULL
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flowcache_add
+ *
+ * Description:
+ *   Remember the forwarding device of the flow of an IPv4 packet, after its
+ *   route was looked up and the FORWARD filter chain accepted it.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received
+ *   fwddev - The device on which the packet must be forwarded
+ *   ipv4   - A pointer to the IPv4 header in within the IPv4 packet
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipv4_flowcache_add(FAR struct net_driver_s *dev,
+                        FAR struct net_driver_s *fwddev,
+                        FAR const struct ipv4_hdr_s *ipv4);
+#else
+#  define ipv4_flowcache_add(dev, fwddev, ipv4)
+#endif
+
 /****************************************************************************
  * Name: ipv6_forward
  *
@@ -369,4 +421,23 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #endif
 
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Invalidate all of the cached flows.  This must be called whenever the
+ *   forwarding device or the filter verdict of a flow may change.
+ *
+ * Assumptions:
+ *   May be called with or without the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flowcache_flush(void);
+#else
+#  define ipfwd_flowcache_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -0,0 +1,310 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/net/ip.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/net/icmp.h>
+
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLOWCACHE_MASK     (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE - 1)
+
+#if (CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE & FLOWCACHE_MASK) != 0
+#  error CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE must be a power of two
+#endif
+
+/* The fragment offset in the 16-bit flags + fragment offset field */
+
+#define IPv4_FRAGOFFSET(ipv4) \
+  ((((uint16_t)(ipv4)->ipoffset[0] << 8) | (ipv4)->ipoffset[1]) & 0x1fff)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The key of a flow: the receiving device and the fields of the IPv4 and
+ * L4 headers that the route lookup and the FORWARD filter chain depend on.
+ * For ICMP, the ports hold the type and the code.
+ */
+
+struct ipv4_flowkey_s
+{
+  FAR struct net_driver_s *indev;
+  in_addr_t srcipaddr;
+  in_addr_t destipaddr;
+  uint16_t  srcport;
+  uint16_t  destport;
+  uint8_t   proto;
+};
+
+/* A cached flow and the forwarding device resolved for it.  The entry is
+ * only valid while its generation is the current one.
+ */
+
+struct ipv4_flow_s
+{
+  struct ipv4_flowkey_s    key;
+  FAR struct net_driver_s *outdev;
+  uint32_t                 gen;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ipv4_flow_s g_ipv4_flows[CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE];
+
+/* The entries are zeroed, so that generation 0 is never valid */
+
+static uint32_t g_flowcache_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flowcache_key
+ *
+ * Description:
+ *   Extract the key of the flow of an IPv4 packet.
+ *
+ * Returned Value:
+ *   True if the packet can use the flow cache.  Fragments other than the
+ *   first one do not hold the L4 header and are never cached.
+ *
+ ****************************************************************************/
+
+static bool ipv4_flowcache_key(FAR struct net_driver_s *dev,
+                               FAR const struct ipv4_hdr_s *ipv4,
+                               FAR struct ipv4_flowkey_s *key)
+{
+  FAR const uint8_t *l4hdr;
+
+  if (IPv4_FRAGOFFSET(ipv4) != 0)
+    {
+      return false;
+    }
+
+  l4hdr = (FAR const uint8_t *)ipv4 + ((ipv4->vhl & IPv4_HLMASK) << 2);
+
+  key->indev      = dev;
+  key->srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  key->destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  key->proto      = ipv4->proto;
+
+  switch (ipv4->proto)
+    {
+      case IP_PROTO_TCP:
+      case IP_PROTO_UDP:
+        {
+          /* Ports in TCP & UDP headers have same offset. */
+
+          FAR const struct udp_hdr_s *udp =
+            (FAR const struct udp_hdr_s *)l4hdr;
+
+          key->srcport  = udp->srcport;
+          key->destport = udp->destport;
+        }
+        break;
+
+      case IP_PROTO_ICMP:
+        {
+          FAR const struct icmp_hdr_s *icmp =
+            (FAR const struct icmp_hdr_s *)l4hdr;
+
+          key->srcport  = icmp->type;
+          key->destport = icmp->icode;
+        }
+        break;
+
+      default:
+        key->srcport  = 0;
+        key->destport = 0;
+        break;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ipv4_flowcache_slot
+ *
+ * Description:
+ *   Return the entry of the cache where a flow is stored.
+ *
+ ****************************************************************************/
+
+static FAR struct ipv4_flow_s *
+ipv4_flowcache_slot(FAR const struct ipv4_flowkey_s *key)
+{
+  uint32_t hash;
+
+  hash  = key->srcipaddr ^ key->destipaddr;
+  hash ^= (uint32_t)(uintptr_t)key->indev;
+  hash ^= ((uint32_t)key->srcport << 16 | key->destport) + key->proto;
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return &g_ipv4_flows[hash & FLOWCACHE_MASK];
+}
+
+/****************************************************************************
+ * Name: ipv4_flowcache_match
+ ****************************************************************************/
+
+static bool ipv4_flowcache_match(FAR const struct ipv4_flowkey_s *a,
+                                 FAR const struct ipv4_flowkey_s *b)
+{
+  return a->indev == b->indev &&
+         a->srcipaddr == b->srcipaddr && a->destipaddr == b->destipaddr &&
+         a->srcport == b->srcport && a->destport == b->destport &&
+         a->proto == b->proto;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flowcache_lookup
+ *
+ * Description:
+ *   Look up the flow of an IPv4 packet to be forwarded.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received
+ *   ipv4  - A pointer to the IPv4 header in within the IPv4 packet
+ *
+ * Returned Value:
+ *   The forwarding device of the flow if it is cached, NULL otherwise.
+ *   The packet of a cached flow is accepted by the FORWARD filter chain.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *
+ipv4_flowcache_lookup(FAR struct net_driver_s *dev,
+                      FAR const struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipv4_flow_s *flow;
+  struct ipv4_flowkey_s key;
+
+  if (!ipv4_flowcache_key(dev, ipv4, &key))
+    {
+      return NULL;
+    }
+
+  flow = ipv4_flowcache_slot(&key);
+  if (flow->gen != g_flowcache_gen ||
+      !ipv4_flowcache_match(&flow->key, &key))
+    {
+      return NULL;
+    }
+
+  return flow->outdev;
+}
+
+/****************************************************************************
+ * Name: ipv4_flowcache_add
+ *
+ * Description:
+ *   Remember the forwarding device of the flow of an IPv4 packet, after its
+ *   route was looked up and the FORWARD filter chain accepted it.  The
+ *   entry replaces any other flow stored at the same place.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received
+ *   fwddev - The device on which the packet must be forwarded
+ *   ipv4   - A pointer to the IPv4 header in within the IPv4 packet
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipv4_flowcache_add(FAR struct net_driver_s *dev,
+                        FAR struct net_driver_s *fwddev,
+                        FAR const struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipv4_flow_s *flow;
+  struct ipv4_flowkey_s key;
+
+  if (ipv4_flowcache_key(dev, ipv4, &key))
+    {
+      flow         = ipv4_flowcache_slot(&key);
+      flow->key    = key;
+      flow->outdev = fwddev;
+      flow->gen    = g_flowcache_gen;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Invalidate all of the cached flows.  This must be called whenever the
+ *   forwarding device or the filter verdict of a flow may change: on route,
+ *   address or filter rule changes, and when a device goes up or down or is
+ *   unregistered.
+ *
+ * Assumptions:
+ *   May be called with or without the network locked.
+ *
+ ****************************************************************************/
+
+void ipfwd_flowcache_flush(void)
+{
+  net_lock();
+
+  if (++g_flowcache_gen == 0)
+    {
+      /* The generations wrapped, forget the stale entries for good */
+
+      memset(g_ipv4_flows, 0, sizeof(g_ipv4_flows));
+      g_flowcache_gen = 1;
+    }
+
+  net_unlock();
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
@@ -143,8 +143,7 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t iphdrlen;
-  uint16_t sum;
+  uint32_t sum;
   int ttl;
 
   /* Check time-to-live (TTL) */
@@ -161,27 +160,13 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   ipv4->ttl = ttl;
 
-  /* Get the IP header length (accounting for possible options). */
-
-  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
-
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Update the IPv4 checksum incrementally (RFC 1624) instead of summing
+   * the whole header again.  The TTL is the upper byte of its 16-bit word,
+   * so decrementing it adds 0x0100 to the one's complement checksum.
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, iphdrlen);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = HTONS(sum);
-    }
-
-  ipv4->ipchksum = ~sum;
+  sum            = (uint32_t)ipv4->ipchksum + HTONS(0x0100);
+  ipv4->ipchksum = (uint16_t)(sum + (sum >= 0xffff));
   return ttl;
 }
 
@@ -217,27 +202,6 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
 #endif
   int ret;
 
-#ifdef CONFIG_NET_IPFILTER
-  /* Do filter before forwarding, to make sure we drop silently before
-   * replying any other errors.
-   */
-
-  ret = ipv4_filter_fwd(dev, fwddev, ipv4);
-  if (ret < 0)
-    {
-      ninfo("Drop/Reject FORWARD packet due to filter %d\n", ret);
-
-      /* Let ipv4_forward reply the reject. */
-
-      if (ret == IPFILTER_TARGET_REJECT)
-        {
-          ret = -ENETUNREACH;
-        }
-
-      goto errout;
-    }
-#endif
-
   /* Verify that the full packet will fit within the forwarding device's MTU
    * if DF is set.
    */
@@ -464,17 +428,51 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   int icmp_reply_code;
 #endif /* CONFIG_NET_ICMP */
 
-  /* Search for a device that can forward this packet. */
-
-  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
-  srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  /* The forwarding device of a known flow was already looked up and the
+   * filter accepted the flow.
+   */
 
-  fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+  fwddev = ipv4_flowcache_lookup(dev, ipv4);
   if (fwddev == NULL)
     {
-      nwarn("WARNING: Not routable\n");
-      ret = -ENETUNREACH;
-      goto drop;
+      /* Search for a device that can forward this packet. */
+
+      destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+      srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+
+      fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+      if (fwddev == NULL)
+        {
+          nwarn("WARNING: Not routable\n");
+          ret = -ENETUNREACH;
+          goto drop;
+        }
+
+      if (fwddev != dev)
+        {
+#ifdef CONFIG_NET_IPFILTER
+          /* Do filter before forwarding, to make sure we drop silently
+           * before replying any other errors.
+           */
+
+          ret = ipv4_filter_fwd(dev, fwddev, ipv4);
+          if (ret < 0)
+            {
+              ninfo("Drop/Reject FORWARD packet due to filter %d\n", ret);
+
+              /* Reply the reject below. */
+
+              if (ret == IPFILTER_TARGET_REJECT)
+                {
+                  ret = -ENETUNREACH;
+                }
+
+              goto drop;
+            }
+#endif
+
+          ipv4_flowcache_add(dev, fwddev, ipv4);
+        }
     }
 
   /* Check if we are forwarding on the same device that we received the
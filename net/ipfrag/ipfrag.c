@@ -1264,6 +1264,15 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return OK;
     }
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* TCP super-segments are cut at TCP and not at IP level */
+
+  if ((dev->d_iob->io_offload & IOB_OFFLOAD_GSO) != 0)
+    {
+      return netdev_gso_fragout(dev);
+    }
+#endif
+
   ninfo("pkt size: %d, MTU: %d\n", dev->d_iob->io_pktlen, mtu);
 
 #ifdef CONFIG_NET_IPv4
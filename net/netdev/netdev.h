@@ -526,6 +526,82 @@ void netdev_ipv6_removemcastmac(FAR struct net_driver_s *dev,
 #  define netdev_ipv6_removemcastmac(dev,addr)
 #endif
 
+/****************************************************************************
+ * Name: netdev_gso_maxsize
+ *
+ * Description:
+ *   Return the largest TCP segment, IP header included, that may be handed
+ *   to a device either for TSO or for software segmentation; zero if
+ *   segments must not exceed the MSS.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+uint16_t netdev_gso_maxsize(FAR struct net_driver_s *dev);
+#else
+#  define netdev_gso_maxsize(dev) 0
+#endif
+
+/****************************************************************************
+ * Name: netdev_txcsum_offload
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the packet in d_iob to the driver if
+ *   it can complete it, or if the packet is a super-segment.  The IP header
+ *   must already be built.
+ *
+ * Input Parameters:
+ *   dev     - The network device
+ *   proto   - IP_PROTO_TCP or IP_PROTO_UDP
+ *   iplen   - The size of the IP header
+ *   csumoff - The offset of the checksum field in the L4 header
+ *
+ * Returned Value:
+ *   true if the checksum was left to the driver; false if the caller must
+ *   calculate it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+bool netdev_txcsum_offload(FAR struct net_driver_s *dev, uint8_t proto,
+                           unsigned int iplen, unsigned int csumoff);
+#else
+#  define netdev_txcsum_offload(dev, proto, iplen, csumoff) false
+#endif
+
+/****************************************************************************
+ * Name: netdev_rxcsum_valid
+ *
+ * Description:
+ *   Return true if the driver has verified the TCP or UDP checksum of the
+ *   received packet in d_iob.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define netdev_rxcsum_valid(dev) \
+     (((dev)->d_iob->io_offload & IOB_OFFLOAD_CSUM_VALID) != 0)
+#else
+#  define netdev_rxcsum_valid(dev) false
+#endif
+
+/****************************************************************************
+ * Name: netdev_gso_fragout
+ *
+ * Description:
+ *   Called instead of IP fragmentation for a TCP super-segment: devices
+ *   with TSO take it as it is, for the others it is segmented in software
+ *   into d_fragout.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_OFFLOAD) && defined(CONFIG_NET_IPFRAG)
+int netdev_gso_fragout(FAR struct net_driver_s *dev);
+#endif
+
 #ifdef CONFIG_NETDEV_RSS
 void netdev_notify_recvcpu(FAR struct net_driver_s *dev,
                            int cpu, uint8_t domain,
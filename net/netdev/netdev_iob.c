@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -110,7 +111,14 @@ void netdev_iob_prepare_dynamic(FAR struct net_driver_s *dev, uint16_t size)
 
   /* alloc new iob for jumbo frame */
 
-  iob = iob_alloc_dynamic(size);
+#ifdef CONFIG_IOB_CLASSES
+  iob = iob_tryalloc_size(MAX(size, CONFIG_IOB_BUFSIZE), false);
+  if (iob == NULL)
+#endif
+    {
+      iob = iob_alloc_dynamic(size);
+    }
+
   if (iob == NULL)
     {
       nerr("ERROR: Failed to allocate an I/O buffer.");
@@ -210,7 +218,20 @@ FAR struct iob_s *netdev_iob_clone(FAR struct net_driver_s *dev,
   FAR struct iob_s *iob;
   int ret;
 
-  iob = iob_tryalloc(throttled);
+#ifdef CONFIG_IOB_CLASSES
+  /* Clone into a single buffer if one is large enough.  The clone may be
+   * given to a device, so it is never smaller than a default buffer.
+   */
+
+  iob = iob_tryalloc_size(MAX(dev->d_iob->io_pktlen +
+                              CONFIG_NET_LL_GUARDSIZE,
+                              CONFIG_IOB_BUFSIZE), throttled);
+  if (iob == NULL)
+#endif
+    {
+      iob = iob_tryalloc(throttled);
+    }
+
   if (iob == NULL)
     {
       nwarn("WARNING: IOB alloc failed for dev %s!\n", dev->d_ifname);
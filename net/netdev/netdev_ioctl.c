@@ -82,6 +82,7 @@
 #include "netdev/netdev.h"
 #include "devif/devif.h"
 #include "igmp/igmp.h"
+#include "ipforward/ipforward.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
@@ -901,6 +902,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFNETMASK:  /* Set network mask */
         ioctl_set_ipv4addr(&dev->d_netmask, &req->ifr_addr);
+        ipfwd_flowcache_flush();
         break;
 #endif
 
@@ -1093,6 +1095,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
               }
 
             ioctl_set_ipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+            ipfwd_flowcache_flush();
             netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
 
@@ -1124,6 +1127,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
             netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
             dev->d_ipaddr = 0;
+            ipfwd_flowcache_flush();
           }
 #endif
 
@@ -1961,6 +1965,7 @@ int netdev_ifup(FAR struct net_driver_s *dev)
               /* Mark the interface as up */
 
               dev->d_flags |= IFF_UP;
+              ipfwd_flowcache_flush();
 
               /* Update the driver status */
 
@@ -1995,6 +2000,7 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
               /* Mark the interface as down */
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
+              ipfwd_flowcache_flush();
 
               /* Update the driver status */
 
@@ -0,0 +1,372 @@
+/****************************************************************************
+ * net/netdev/netdev_offload.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+
+#include "netdev/netdev.h"
+#include "inet/inet.h"
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_pseudo_chksum
+ *
+ * Description:
+ *   Calculate the sum of the TCP/UDP pseudo-header of an IPv4 or IPv6
+ *   packet, using the packet length found in its IP header.
+ *
+ * Input Parameters:
+ *   ip    - The IP header
+ *   proto - The upper layer protocol
+ *   iplen - The size of the IP header, including options or extension
+ *           headers
+ *
+ * Returned Value:
+ *   The sum in host byte order, not complemented.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_pseudo_chksum(FAR const uint8_t *ip, uint8_t proto,
+                                     unsigned int iplen)
+{
+  uint16_t upperlen;
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR const struct ipv4_hdr_s *ipv4 = (FAR const struct ipv4_hdr_s *)ip;
+
+      upperlen = (((uint16_t)ipv4->len[0] << 8) + ipv4->len[1]) - iplen;
+      return chksum(upperlen + proto,
+                    (FAR const uint8_t *)ipv4->srcipaddr,
+                    2 * sizeof(in_addr_t));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  FAR const struct ipv6_hdr_s *ipv6 = (FAR const struct ipv6_hdr_s *)ip;
+
+  upperlen = (((uint16_t)ipv6->len[0] << 8) + ipv6->len[1]) -
+             (iplen - IPv6_HDRLEN);
+  return chksum(upperlen + proto, (FAR const uint8_t *)ipv6->srcipaddr,
+                2 * sizeof(net_ipv6addr_t));
+#else
+  return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_gso_segment
+ *
+ * Description:
+ *   Cut the TCP super-segment in d_iob into MSS-sized packets and queue
+ *   them to d_fragout, from where they are sent like IP fragments.
+ *   The TCP and IP headers are copied to every packet and fixed up:
+ *   sequence number, IP length and identification, FIN/PSH only on the
+ *   last packet, and the checksums.  Each IPv4 packet gets a new IP ID.
+ *
+ * Input Parameters:
+ *   dev - The network device; d_iob holds the L3 super-segment
+ *
+ * Returned Value:
+ *   OK on success, d_iob has then been released.  A negated errno value
+ *   on failure, d_fragout has then been released and d_iob is left to the
+ *   caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SWGSO
+static int netdev_gso_segment(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *pkt = dev->d_iob;
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *seg;
+  FAR uint8_t *ip = IPBUF(0);
+  unsigned int hdrlen;
+  unsigned int paylen;
+  unsigned int seglen;
+  unsigned int iplen;
+  unsigned int off;
+  uint32_t seqno;
+  uint16_t sum;
+  uint8_t flags;
+  bool csum;
+  bool ipv4;
+
+  ipv4  = (pkt->io_offload & IOB_OFFLOAD_GSO_TCPV4) != 0;
+  iplen = ipv4 ? (ip[0] & IPv4_HLMASK) << 2 : IPv6_HDRLEN;
+  tcp   = (FAR struct tcp_hdr_s *)(ip + iplen);
+
+  hdrlen = iplen + ((tcp->tcpoffset >> 4) << 2);
+  paylen = pkt->io_pktlen - hdrlen;
+  seqno  = ((uint32_t)tcp->seqno[0] << 24) | ((uint32_t)tcp->seqno[1] << 16) |
+           ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+  flags  = tcp->flags;
+  csum   = (pkt->io_offload & IOB_OFFLOAD_CSUM_PARTIAL) != 0;
+
+  DEBUGASSERT(pkt->io_gsosize > 0 && hdrlen <= pkt->io_len);
+
+  for (off = 0; off < paylen; off += seglen)
+    {
+      seglen = MIN(pkt->io_gsosize, paylen - off);
+
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          goto errout;
+        }
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+      if (iob_clone_partial(pkt, hdrlen, 0, seg, 0, false, false) < 0 ||
+          iob_clone_partial(pkt, seglen, hdrlen + off, seg, hdrlen,
+                            false, false) < 0)
+        {
+          iob_free_chain(seg);
+          goto errout;
+        }
+
+      ip  = IOB_DATA(seg);
+      tcp = (FAR struct tcp_hdr_s *)(ip + iplen);
+
+      tcp->seqno[0] = (seqno + off) >> 24;
+      tcp->seqno[1] = (seqno + off) >> 16;
+      tcp->seqno[2] = (seqno + off) >> 8;
+      tcp->seqno[3] = (seqno + off);
+      tcp->flags    = off + seglen < paylen ?
+                      flags & ~(TCP_FIN | TCP_PSH) : flags;
+
+#ifdef CONFIG_NET_IPv4
+      if (ipv4)
+        {
+          FAR struct ipv4_hdr_s *ipv4hdr = (FAR struct ipv4_hdr_s *)ip;
+          uint16_t ipid;
+
+          /* The first packet keeps the ID of the super-segment */
+
+          ipid = off == 0 ? ((uint16_t)ip[4] << 8) | ip[5] :
+                            ipv4_alloc_ipid();
+
+          ipv4hdr->len[0]   = (hdrlen + seglen) >> 8;
+          ipv4hdr->len[1]   = (hdrlen + seglen) & 0xff;
+          ipv4hdr->ipid[0]  = ipid >> 8;
+          ipv4hdr->ipid[1]  = ipid & 0xff;
+          ipv4hdr->ipchksum = 0;
+          ipv4hdr->ipchksum = ~ipv4_chksum(ipv4hdr);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if (!ipv4)
+        {
+          FAR struct ipv6_hdr_s *ipv6hdr = (FAR struct ipv6_hdr_s *)ip;
+
+          ipv6hdr->len[0] = (hdrlen + seglen - IPv6_HDRLEN) >> 8;
+          ipv6hdr->len[1] = (hdrlen + seglen - IPv6_HDRLEN) & 0xff;
+        }
+#endif
+
+      /* The checksum of the super-segment was left to the driver, either
+       * leave it again or complete it here.
+       */
+
+      if (csum)
+        {
+          sum = netdev_pseudo_chksum(ip, IP_PROTO_TCP, iplen);
+          if ((dev->d_features & NETDEV_FEATURE_TXCSUM) != 0)
+            {
+              tcp->tcpchksum    = HTONS(sum);
+              seg->io_csumstart = iplen;
+              seg->io_csumoff   = pkt->io_csumoff;
+              seg->io_offload   = IOB_OFFLOAD_CSUM_PARTIAL;
+            }
+          else
+            {
+              tcp->tcpchksum = 0;
+              sum = chksum_iob(sum, seg, iplen);
+              tcp->tcpchksum = ~((sum == 0) ? 0xffff : HTONS(sum));
+            }
+        }
+
+      if (iob_tryadd_queue(seg, &dev->d_fragout) < 0)
+        {
+          iob_free_chain(seg);
+          goto errout;
+        }
+
+#ifdef CONFIG_NET_STATISTICS
+      if (off > 0)
+        {
+          g_netstats.tcp.sent++;
+        }
+#endif
+    }
+
+  netdev_iob_release(dev);
+  netdev_txnotify_dev(dev);
+  return OK;
+
+errout:
+  iob_free_queue(&dev->d_fragout);
+  return -ENOMEM;
+}
+#endif /* CONFIG_NETDEV_SWGSO */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gso_maxsize
+ *
+ * Description:
+ *   Return the largest TCP segment, IP header included, that may be handed
+ *   to a device either for TSO or for software segmentation.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *
+ * Returned Value:
+ *   The size, or zero if segments must not exceed the MSS.
+ *
+ ****************************************************************************/
+
+uint16_t netdev_gso_maxsize(FAR struct net_driver_s *dev)
+{
+  /* Packets to ourselves are never segmented, and radios run TCP through
+   * their own adaptation layers.
+   */
+
+  if (dev->d_lltype == NET_LL_LOOPBACK ||
+      dev->d_lltype == NET_LL_IEEE802154 ||
+      dev->d_lltype == NET_LL_PKTRADIO)
+    {
+      return 0;
+    }
+
+  if ((dev->d_features & NETDEV_FEATURE_TSO) != 0)
+    {
+      return dev->d_gsomax;
+    }
+
+#ifdef CONFIG_NETDEV_SWGSO
+  return CONFIG_NETDEV_SWGSO_MAXSIZE;
+#else
+  return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_txcsum_offload
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the packet in d_iob to the driver if
+ *   the device can complete it, or if the packet is a super-segment that
+ *   will be segmented later anyway.  The checksum field is then set to the
+ *   pseudo-header sum and the packet is marked IOB_OFFLOAD_CSUM_PARTIAL.
+ *   The IP header, including its length, must already be built.
+ *
+ * Input Parameters:
+ *   dev     - The network device
+ *   proto   - IP_PROTO_TCP or IP_PROTO_UDP
+ *   iplen   - The size of the IP header
+ *   csumoff - The offset of the checksum field in the L4 header
+ *
+ * Returned Value:
+ *   true if the checksum was left to the driver; false if the caller must
+ *   calculate it.
+ *
+ ****************************************************************************/
+
+bool netdev_txcsum_offload(FAR struct net_driver_s *dev, uint8_t proto,
+                           unsigned int iplen, unsigned int csumoff)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR uint16_t *field;
+
+  if ((dev->d_features & NETDEV_FEATURE_TXCSUM) == 0 &&
+      (iob->io_offload & IOB_OFFLOAD_GSO) == 0)
+    {
+      iob->io_offload = 0;
+      return false;
+    }
+
+  field  = (FAR uint16_t *)((FAR uint8_t *)IPBUF(iplen) + csumoff);
+  *field = HTONS(netdev_pseudo_chksum(IPBUF(0), proto, iplen));
+
+  iob->io_csumstart = iplen;
+  iob->io_csumoff   = csumoff;
+  iob->io_offload   = (iob->io_offload & IOB_OFFLOAD_GSO) |
+                      IOB_OFFLOAD_CSUM_PARTIAL;
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_gso_fragout
+ *
+ * Description:
+ *   Called instead of IP fragmentation for a TCP super-segment: devices
+ *   with TSO take it as it is, for the others it is segmented in software.
+ *
+ * Input Parameters:
+ *   dev - The network device; d_iob holds the L3 super-segment
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFRAG
+int netdev_gso_fragout(FAR struct net_driver_s *dev)
+{
+  if ((dev->d_features & NETDEV_FEATURE_TSO) != 0)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_NETDEV_SWGSO
+  return netdev_gso_segment(dev);
+#else
+  return -EMSGSIZE;
+#endif
+}
+#endif /* CONFIG_NET_IPFRAG */
+
+#endif /* CONFIG_NETDEV_OFFLOAD */
@@ -39,6 +39,7 @@
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -145,6 +146,10 @@ int netdev_unregister(FAR struct net_driver_s *dev)
             }
 
           curr->flink = NULL;
+
+          /* Forget the flows forwarded to or from the device */
+
+          ipfwd_flowcache_flush();
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
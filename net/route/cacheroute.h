@@ -57,58 +57,71 @@
 void net_init_cacheroute(void);
 
 /****************************************************************************
- * Name: net_addcache_ipv4 and net_addcache_ipv6
+ * Name: net_lookupcache_ipv4 and net_lookupcache_ipv6
  *
  * Description:
- *   Add one route to the routing table cache
+ *   Look up the best route to a destination address in the routing table
+ *   cache.  On a hit, the entry becomes the most recently used one.
  *
  * Input Parameters:
- *   None
+ *   target    - The destination address to look up.
+ *   router    - The location to return the router address.
+ *   prefixlen - The location to return the prefix length of the route, -1
+ *               if there is no route to the destination.
  *
  * Returned Value:
- *   Zero (OK) is returned on success; a negated errno value is returned
- *   on any failure.
+ *   Zero (OK) is returned on a hit; -ENOENT is returned if the destination
+ *   is not in the cache.  Other negated errno values may be returned on
+ *   failures.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-int net_addcache_ipv4(FAR struct net_route_ipv4_s *route);
+int net_lookupcache_ipv4(in_addr_t target, FAR in_addr_t *router,
+                         FAR int8_t *prefixlen);
 #endif
 
 #ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-int net_addcache_ipv6(FAR struct net_route_ipv6_s *route);
+int net_lookupcache_ipv6(const net_ipv6addr_t target,
+                         net_ipv6addr_t router, FAR int16_t *prefixlen);
 #endif
 
 /****************************************************************************
- * Name: net_foreachcache_ipv4/net_foreachcache_ipv6
+ * Name: net_addcache_ipv4 and net_addcache_ipv6
  *
  * Description:
- *   Traverse the routing table cache
+ *   Add the best route to a destination address to the routing table
+ *   cache, as the most recently used entry.  The least recently used entry
+ *   is replaced if the cache is full.
  *
  * Input Parameters:
- *   handler - Will be called for each route in the routing table cache.
- *   arg     - An arbitrary value that will be passed to the handler.
+ *   target    - The destination address.
+ *   router    - The address of the router of the route.
+ *   prefixlen - The prefix length of the route, -1 if there is no route to
+ *               the destination.
  *
  * Returned Value:
- *   Zero (OK) returned if the entire table was searched.  A negated errno
- *   value will be returned in the event of a failure.  Handlers may also
- *   terminate the search early with any non-zero value.
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on any failure.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-int net_foreachcache_ipv4(route_handler_ipv4_t handler, FAR void *arg);
+int net_addcache_ipv4(in_addr_t target, in_addr_t router,
+                      int8_t prefixlen);
 #endif
 
 #ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-int net_foreachcache_ipv6(route_handler_ipv6_t handler, FAR void *arg);
+int net_addcache_ipv6(const net_ipv6addr_t target,
+                      const net_ipv6addr_t router, int16_t prefixlen);
 #endif
 
 /****************************************************************************
  * Name: net_flushcache_ipv4 and net_flushcache_ipv6
  *
  * Description:
- *   Flush the content of the routing table cache
+ *   Flush the content of the routing table cache.  This must be called
+ *   whenever a route is added to or deleted from the routing table.
  *
  * Input Parameters:
  *   None
@@ -35,7 +35,9 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
+#include "route/cacheroute.h"
 #include "route/fileroute.h"
 #include "route/route.h"
 
@@ -88,6 +90,14 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_closeroute_ipv4(&fshandle);
 
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
+  /* The cached routes to the destinations may have changed */
+
+  net_flushcache_ipv4();
+#endif
+
+  ipfwd_flowcache_flush();
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -124,6 +134,12 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_closeroute_ipv6(&fshandle);
 
+#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+  /* The cached routes to the destinations may have changed */
+
+  net_flushcache_ipv6();
+#endif
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET6);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -36,7 +36,9 @@
 
 #include <arch/irq.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
+#include "route/cacheroute.h"
 #include "route/ramroute.h"
 #include "route/route.h"
 
@@ -88,6 +90,15 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+  ramroute_ipv4_trie_add(route);
+
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
+  /* The cached routes to the destinations may have changed */
+
+  net_flushcache_ipv4();
+#endif
+
+  ipfwd_flowcache_flush();
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
@@ -125,6 +136,13 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+  ramroute_ipv6_trie_add(route);
+
+#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+  /* The cached routes to the destinations may have changed */
+
+  net_flushcache_ipv6();
+#endif
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET6);
@@ -67,11 +67,16 @@
  ****************************************************************************/
 
 #ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-/* This structure describes one entry in the routing table cache */
+/* This structure describes one entry in the routing table cache: the
+ * best route to one destination address.  The prefix length is -1 if
+ * there is no route to the destination.
+ */
 
 struct net_cache_ipv4_entry_s
 {
-  struct net_route_ipv4_s entry;
+  in_addr_t target;                     /* The destination address */
+  in_addr_t router;                     /* Route packets via this router */
+  int8_t prefixlen;                     /* Prefix length of the route */
   FAR struct net_cache_ipv4_entry_s *flink;
 };
 
@@ -85,11 +90,16 @@ struct net_cache_ipv4_queue_s
 #endif
 
 #ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-/* This structure describes one entry in the routing table cache */
+/* This structure describes one entry in the routing table cache: the
+ * best route to one destination address.  The prefix length is -1 if
+ * there is no route to the destination.
+ */
 
 struct net_cache_ipv6_entry_s
 {
-  struct net_route_ipv6_s entry;
+  net_ipv6addr_t target;                /* The destination address */
+  net_ipv6addr_t router;                /* Route packets via this router */
+  int16_t prefixlen;                    /* Prefix length of the route */
   FAR struct net_cache_ipv6_entry_s *flink;
 };
 
@@ -372,6 +382,101 @@ FAR struct net_cache_ipv6_entry_s *net_alloccache_ipv6(void)
 }
 #endif
 
+/****************************************************************************
+ * Name: net_findcache_ipv4 and net_findcache_ipv6
+ *
+ * Description:
+ *   Find the routing table cache entry of a destination address and remove
+ *   it from the routing table cache list.
+ *
+ * Input Parameters:
+ *   target - The destination address to look for.
+ *
+ * Returned Value:
+ *   The routing table cache entry of the destination address, or NULL if
+ *   it is not in the routing table cache.
+ *
+ * Assumptions:
+ *   Caller has the routing table cache locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
+static FAR struct net_cache_ipv4_entry_s *
+net_findcache_ipv4(in_addr_t target)
+{
+  FAR struct net_cache_ipv4_entry_s *cache;
+  FAR struct net_cache_ipv4_entry_s *prev;
+
+  for (prev = NULL, cache = g_ipv4_cache.head;
+       cache != NULL;
+       prev = cache, cache = cache->flink)
+    {
+      if (net_ipv4addr_cmp(cache->target, target))
+        {
+          /* Remove the cache entry from the list */
+
+          if (prev == NULL)
+            {
+              g_ipv4_cache.head = cache->flink;
+            }
+          else
+            {
+              prev->flink = cache->flink;
+            }
+
+          if (g_ipv4_cache.tail == cache)
+            {
+              g_ipv4_cache.tail = prev;
+            }
+
+          cache->flink = NULL;
+          break;
+        }
+    }
+
+  return cache;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+static FAR struct net_cache_ipv6_entry_s *
+net_findcache_ipv6(const net_ipv6addr_t target)
+{
+  FAR struct net_cache_ipv6_entry_s *cache;
+  FAR struct net_cache_ipv6_entry_s *prev;
+
+  for (prev = NULL, cache = g_ipv6_cache.head;
+       cache != NULL;
+       prev = cache, cache = cache->flink)
+    {
+      if (net_ipv6addr_cmp(cache->target, target))
+        {
+          /* Remove the cache entry from the list */
+
+          if (prev == NULL)
+            {
+              g_ipv6_cache.head = cache->flink;
+            }
+          else
+            {
+              prev->flink = cache->flink;
+            }
+
+          if (g_ipv6_cache.tail == cache)
+            {
+              g_ipv6_cache.tail = prev;
+            }
+
+          cache->flink = NULL;
+          break;
+        }
+    }
+
+  return cache;
+}
+#endif
+
 /****************************************************************************
  * Name: net_reset_ipv4_cache and net_reset_ipv6_cache
  *
@@ -457,29 +562,32 @@ void net_init_cacheroute(void)
 }
 
 /****************************************************************************
- * Name: net_addcache_ipv4 and net_addcache_ipv6
+ * Name: net_lookupcache_ipv4 and net_lookupcache_ipv6
  *
  * Description:
- *   Add one route to the routing table cache
+ *   Look up the best route to a destination address in the routing table
+ *   cache.  On a hit, the entry becomes the most recently used one.
  *
  * Input Parameters:
- *   None
+ *   target    - The destination address to look up.
+ *   router    - The location to return the router address.
+ *   prefixlen - The location to return the prefix length of the route, -1
+ *               if there is no route to the destination.
  *
  * Returned Value:
- *   Zero (OK) is returned on success; a negated errno value is returned
- *   on any failure.
+ *   Zero (OK) is returned on a hit; -ENOENT is returned if the destination
+ *   is not in the cache.  Other negated errno values may be returned on
+ *   failures.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-int net_addcache_ipv4(FAR struct net_route_ipv4_s *route)
+int net_lookupcache_ipv4(in_addr_t target, FAR in_addr_t *router,
+                         FAR int8_t *prefixlen)
 {
   FAR struct net_cache_ipv4_entry_s *cache;
-  FAR struct net_cache_ipv4_entry_s *prev;
   int ret;
 
-  DEBUGASSERT(route != NULL);
-
   /* Get exclusive access to the cache */
 
   ret = nxmutex_lock(&g_ipv4_cachelock);
@@ -488,80 +596,33 @@ int net_addcache_ipv4(FAR struct net_route_ipv4_s *route)
       return ret;
     }
 
-  /* First, check if the route already exists in the cache.
-   *
-   * Visit each entry in the cache
-   */
-
-  for (prev = NULL, cache = g_ipv4_cache.head;
-       cache != NULL;
-       prev = cache, cache = cache->flink)
+  cache = net_findcache_ipv4(target);
+  if (cache != NULL)
     {
-      /* To match, the masked target addresses and netmasks must be the
-       * same.
-       */
-
-      if (net_ipv4addr_cmp(route->target, cache->entry.target) &&
-          net_ipv4addr_cmp(route->netmask, cache->entry.netmask))
-        {
-          /* If the route already exists and is already at the head of the
-           * list, then do nothing.  It is already the most recently used.
-           */
-
-          if (prev == NULL)
-            {
-              nxmutex_unlock(&g_ipv4_cachelock);
-              return OK;
-            }
+      net_ipv4addr_copy(*router, cache->router);
+      *prefixlen = cache->prefixlen;
 
-          /* Otherwise, remove the cache entry from the middle or end of
-           * the list.
-           */
+      /* Make it the most recently used entry */
 
-          prev->flink = cache->flink;
-          if (g_ipv4_cache.tail == cache)
-            {
-              g_ipv4_cache.tail = prev;
-            }
-
-          cache->flink = NULL;
-          break;
-        }
+      net_add_newest_ipv4(cache);
     }
-
-  /* If we did not find the entry in the list, then we will have to
-   * allocate a new entry.
-   */
-
-  if (cache == NULL)
+  else
     {
-      /* Allocate a new cache entry (should never fail) */
-
-      cache = net_alloccache_ipv4();
-      DEBUGASSERT(cache != NULL);
-
-      /* Copy the routing table entry into the allocated cache entry. */
-
-      memcpy(&cache->entry, route, sizeof(struct net_route_ipv4_s));
+      ret = -ENOENT;
     }
 
-  /* Then add the new cache entry as the newest entry in the table */
-
-  net_add_newest_ipv4(cache);
   nxmutex_unlock(&g_ipv4_cachelock);
-  return OK;
+  return ret;
 }
 #endif
 
 #ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-int net_addcache_ipv6(FAR struct net_route_ipv6_s *route)
+int net_lookupcache_ipv6(const net_ipv6addr_t target,
+                         net_ipv6addr_t router, FAR int16_t *prefixlen)
 {
   FAR struct net_cache_ipv6_entry_s *cache;
-  FAR struct net_cache_ipv6_entry_s *prev;
   int ret;
 
-  DEBUGASSERT(route != NULL);
-
   /* Get exclusive access to the cache */
 
   ret = nxmutex_lock(&g_ipv6_cachelock);
@@ -570,94 +631,52 @@ int net_addcache_ipv6(FAR struct net_route_ipv6_s *route)
       return ret;
     }
 
-  /* First, check if the route already exists in the cache.
-   *
-   * Visit each entry in the cache.
-   */
-
-  for (prev = NULL, cache = g_ipv6_cache.head;
-       cache != NULL;
-       prev = cache, cache = cache->flink)
+  cache = net_findcache_ipv6(target);
+  if (cache != NULL)
     {
-      /* To match, the masked target addresses and netmasks must be the
-       * same.
-       */
-
-      if (net_ipv6addr_cmp(route->target, cache->entry.target) &&
-          net_ipv6addr_cmp(route->netmask, cache->entry.netmask))
-        {
-          /* If the route already exists and is already at the head of the
-           * list, then do nothing.  It is already the most recently used.
-           */
+      net_ipv6addr_copy(router, cache->router);
+      *prefixlen = cache->prefixlen;
 
-          if (prev == NULL)
-            {
-              nxmutex_unlock(&g_ipv6_cachelock);
-              return OK;
-            }
-
-          /* Otherwise, remove the cache entry from the middle or end of
-           * the list.
-           */
-
-          prev->flink = cache->flink;
-          if (g_ipv6_cache.tail == cache)
-            {
-              g_ipv6_cache.tail = prev;
-            }
+      /* Make it the most recently used entry */
 
-          cache->flink = NULL;
-          break;
-        }
+      net_add_newest_ipv6(cache);
     }
-
-  /* If we did not find the entry in the list, then we will have to
-   * allocate a new entry.
-   */
-
-  if (cache == NULL)
+  else
     {
-      /* Allocate a new cache entry (should never fail) */
-
-      cache = net_alloccache_ipv6();
-      DEBUGASSERT(cache != NULL);
-
-      /* Copy the routing table entry into the allocated cache entry */
-
-      memcpy(&cache->entry, route, sizeof(struct net_route_ipv6_s));
+      ret = -ENOENT;
     }
 
-  /* Then add the new cache entry as the newest entry in the table */
-
-  net_add_newest_ipv6(cache);
   nxmutex_unlock(&g_ipv6_cachelock);
-  return OK;
+  return ret;
 }
 #endif
 
 /****************************************************************************
- * Name: net_foreachcache_ipv4/net_foreachcache_ipv6
+ * Name: net_addcache_ipv4 and net_addcache_ipv6
  *
  * Description:
- *   Traverse the routing table cache
+ *   Add the best route to a destination address to the routing table
+ *   cache, as the most recently used entry.  The least recently used entry
+ *   is replaced if the cache is full.
  *
  * Input Parameters:
- *   handler - Will be called for each route in the routing table cache.
- *   arg     - An arbitrary value that will be passed to the handler.
+ *   target    - The destination address.
+ *   router    - The address of the router of the route.
+ *   prefixlen - The prefix length of the route, -1 if there is no route to
+ *               the destination.
  *
  * Returned Value:
- *   Zero (OK) returned if the entire table was searched.  A negated errno
- *   value will be returned in the event of a failure.  Handlers may also
- *   terminate the search early with any non-zero value.
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on any failure.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
-int net_foreachcache_ipv4(route_handler_ipv4_t handler, FAR void *arg)
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
+int net_addcache_ipv4(in_addr_t target, in_addr_t router,
+                      int8_t prefixlen)
 {
   FAR struct net_cache_ipv4_entry_s *cache;
-  FAR struct net_cache_ipv4_entry_s *next;
-  int ret = 0;
+  int ret;
 
   /* Get exclusive access to the cache */
 
@@ -667,31 +686,35 @@ int net_foreachcache_ipv4(route_handler_ipv4_t handler, FAR void *arg)
       return ret;
     }
 
-  /* Visit each entry in the routing table */
+  /* Reuse the entry of the destination if it is already in the cache,
+   * otherwise allocate a new entry (should never fail).
+   */
 
-  for (cache = g_ipv4_cache.head; ret == 0 && cache != NULL; cache = next)
+  cache = net_findcache_ipv4(target);
+  if (cache == NULL)
     {
-      /* Get the next entry in the to visit.  We do this BEFORE calling the
-       * handler because the handler may delete this entry.
-       */
-
-      next = cache->flink;
-      ret  = handler(&cache->entry, arg);
+      cache = net_alloccache_ipv4();
+      DEBUGASSERT(cache != NULL);
     }
 
-  /* Unlock the cache */
+  net_ipv4addr_copy(cache->target, target);
+  net_ipv4addr_copy(cache->router, router);
+  cache->prefixlen = prefixlen;
+
+  /* Then add the cache entry as the newest entry in the table */
 
+  net_add_newest_ipv4(cache);
   nxmutex_unlock(&g_ipv4_cachelock);
-  return ret;
+  return OK;
 }
 #endif
 
-#ifdef CONFIG_NET_IPv6
-int net_foreachcache_ipv6(route_handler_ipv6_t handler, FAR void *arg)
+#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+int net_addcache_ipv6(const net_ipv6addr_t target,
+                      const net_ipv6addr_t router, int16_t prefixlen)
 {
   FAR struct net_cache_ipv6_entry_s *cache;
-  FAR struct net_cache_ipv6_entry_s *next;
-  int ret = 0;
+  int ret;
 
   /* Get exclusive access to the cache */
 
@@ -701,22 +724,26 @@ int net_foreachcache_ipv6(route_handler_ipv6_t handler, FAR void *arg)
       return ret;
     }
 
-  /* Visit each entry in the routing table */
+  /* Reuse the entry of the destination if it is already in the cache,
+   * otherwise allocate a new entry (should never fail).
+   */
 
-  for (cache = g_ipv6_cache.head; ret == 0 && cache != NULL; cache = next)
+  cache = net_findcache_ipv6(target);
+  if (cache == NULL)
     {
-      /* Get the next entry in the to visit.  We do this BEFORE calling the
-       * handler because the handler may delete this entry.
-       */
-
-      next = cache->flink;
-      ret  = handler(&cache->entry, arg);
+      cache = net_alloccache_ipv6();
+      DEBUGASSERT(cache != NULL);
     }
 
-  /* Unlock the cache */
+  net_ipv6addr_copy(cache->target, target);
+  net_ipv6addr_copy(cache->router, router);
+  cache->prefixlen = prefixlen;
+
+  /* Then add the cache entry as the newest entry in the table */
 
+  net_add_newest_ipv6(cache);
   nxmutex_unlock(&g_ipv6_cachelock);
-  return ret;
+  return OK;
 }
 #endif
 
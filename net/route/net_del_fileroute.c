@@ -38,6 +38,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
@@ -256,6 +257,8 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   net_flushcache_ipv4();
 #endif
 
+  ipfwd_flowcache_flush();
+
   /* Loop, copying each entry, to the previous entry thus removing the entry
    * to be deleted.
    */
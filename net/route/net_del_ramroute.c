@@ -34,7 +34,9 @@
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
+#include "route/cacheroute.h"
 #include "route/ramroute.h"
 #include "route/route.h"
 
@@ -113,7 +115,16 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+      ramroute_ipv4_trie_del(route);
+
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
+      /* The cached routes to the destinations may have changed */
+
+      net_flushcache_ipv4();
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
+      ipfwd_flowcache_flush();
 
       /* And free the routing table entry by adding it to the free list */
 
@@ -171,6 +182,14 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
           ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+      ramroute_ipv6_trie_del(route);
+
+#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+      /* The cached routes to the destinations may have changed */
+
+      net_flushcache_ipv6();
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET6);
 
       /* And free the routing table entry by adding it to the free list */
@@ -41,22 +41,6 @@
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-#  define IPv4_ROUTER entry.router
-#else
-#  define IPv4_ROUTER router
-#endif
-
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-#  define IPv6_ROUTER entry.router
-#else
-#  define IPv6_ROUTER router
-#endif
-
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -65,19 +49,13 @@
 struct route_ipv4_match_s
 {
   in_addr_t target;              /* Target IPv4 address on remote network */
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-  struct net_route_ipv4_s entry; /* Full entry from the IPv4 routing table */
-#else
   in_addr_t router;              /* IPv4 address of router a local networks */
-#endif
-#ifdef CONFIG_ROUTE_LONGEST_MATCH
-  /* Only match prefix longer than prefixlen, equals to entry.netmask if we
-   * have got a match (then we only find longer prefix later).
-   * Range: -1 ~ 32
+
+  /* The prefix length of the route matched so far, only longer prefixes
+   * will match later.  Range: -1 (no match) ~ 32
    */
 
   int8_t prefixlen;
-#endif
 };
 #endif
 
@@ -85,19 +63,13 @@ struct route_ipv4_match_s
 struct route_ipv6_match_s
 {
   net_ipv6addr_t target;         /* Target IPv6 address on remote network */
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-  struct net_route_ipv6_s entry; /* Full entry from the IPv6 routing table */
-#else
   net_ipv6addr_t router;         /* IPv6 address of router a local networks */
-#endif
-#ifdef CONFIG_ROUTE_LONGEST_MATCH
-  /* Only match prefix longer than prefixlen, equals to entry.netmask if we
-   * have got a match (then we only find longer prefix later).
-   * Range: -1 ~ 128
+
+  /* The prefix length of the route matched so far, only longer prefixes
+   * will match later.  Range: -1 (no match) ~ 128
    */
 
   int16_t prefixlen;
-#endif
 };
 #endif
 
@@ -125,9 +97,7 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 {
   FAR struct route_ipv4_match_s *match =
                                (FAR struct route_ipv4_match_s *)arg;
-#ifdef CONFIG_ROUTE_LONGEST_MATCH
   int8_t prefixlen = (int8_t)net_ipv4_mask2pref(route->netmask);
-#endif
 
   /* To match, the masked target addresses must be the same.  In the event
    * of multiple matches, only the first is returned.  There is not (yet) any
@@ -140,20 +110,14 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 #endif
      )
     {
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-      /* They match.. Copy the entire routing table entry */
-
-      memcpy(&match->entry, route, sizeof(struct net_route_ipv4_s));
-#else
       /* They match.. Copy the router address */
 
       net_ipv4addr_copy(match->router, route->router);
-#endif
-#ifdef CONFIG_ROUTE_LONGEST_MATCH
-      /* Cache the prefix length */
+
+      /* Remember the prefix length */
 
       match->prefixlen = prefixlen;
-#else
+#ifndef CONFIG_ROUTE_LONGEST_MATCH
       return 1;
 #endif
     }
@@ -182,9 +146,7 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 {
   FAR struct route_ipv6_match_s *match =
                                 (FAR struct route_ipv6_match_s *)arg;
-#ifdef CONFIG_ROUTE_LONGEST_MATCH
   int16_t prefixlen = (int16_t)net_ipv6_mask2pref(route->netmask);
-#endif
 
   /* To match, the masked target addresses must be the same.  In the event
    * of multiple matches, only the first is returned.  There is not (yet) any
@@ -197,20 +159,14 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 #endif
      )
     {
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-      /* They match.. Copy the entire routing table entry */
-
-      memcpy(&match->entry, route, sizeof(struct net_route_ipv6_s));
-#else
       /* They match.. Copy the router address */
 
       net_ipv6addr_copy(match->router, route->router);
-#endif
-#ifdef CONFIG_ROUTE_LONGEST_MATCH
-      /* Cache the prefix length */
+
+      /* Remember the prefix length */
 
       match->prefixlen = prefixlen;
-#else
+#ifndef CONFIG_ROUTE_LONGEST_MATCH
       return 1;
 #endif
     }
@@ -268,31 +224,38 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
   net_ipv4addr_copy(match.target, target);
-#ifdef CONFIG_ROUTE_LONGEST_MATCH
-  match.prefixlen = prefixlen;
-#endif
+  match.prefixlen = -1;
 
 #ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-  /* First see if we can find a router entry in the cache */
+  /* First see if the best route to this address is in the cache */
 
-  ret = net_foreachcache_ipv4(net_ipv4_match, &match);
-  if (ret <= 0)
+  ret = net_lookupcache_ipv4(target, &match.router, &match.prefixlen);
+  if (ret < 0)
 #endif
     {
-      /* Not found in the cache.  Try to find a router entry with the
-       * routing table that can forward to this address
+      /* Not found in the cache.  Look up the best route to this address in
+       * the routing table.
+       */
+
+      ret = net_lookuproute_ipv4(target, net_ipv4_match, &match);
+
+#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
+      /* Add the result to the cache, even if there is no route for this
+       * address.
        */
 
-      ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+      net_addcache_ipv4(target, match.router, match.prefixlen);
+#endif
     }
 
+  UNUSED(ret);
+
   /* Did we find a route? */
 
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
-  UNUSED(ret);
   if (match.prefixlen <= prefixlen)
 #else
-  if (ret <= 0)
+  if (match.prefixlen < 0)
 #endif
     {
       /* No.. there is no route for this address */
@@ -300,19 +263,9 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
       return -ENOENT;
     }
 
-  /* We found a route. */
-
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-  /* Add the route to the cache.  If the route is already in the cache, this
-   * will update it to the most recently accessed.
-   */
-
-  net_addcache_ipv4(&match.entry);
-#endif
-
-  /* Return the router address. */
+  /* We found a route.  Return the router address. */
 
-  net_ipv4addr_copy(*router, match.IPv4_ROUTER);
+  net_ipv4addr_copy(*router, match.router);
   return OK;
 }
 #endif /* CONFIG_NET_IPv4 */
@@ -362,31 +315,38 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
   net_ipv6addr_copy(match.target, target);
-#ifdef CONFIG_ROUTE_LONGEST_MATCH
-  match.prefixlen = prefixlen;
-#endif
+  match.prefixlen = -1;
 
 #ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-  /* First see if we can find a router entry in the cache */
+  /* First see if the best route to this address is in the cache */
 
-  ret = net_foreachcache_ipv6(net_ipv6_match, &match);
-  if (ret <= 0)
+  ret = net_lookupcache_ipv6(target, match.router, &match.prefixlen);
+  if (ret < 0)
 #endif
     {
-      /* Not found in the cache.  Try to find a router entry with the
-       * routing table that can forward to this address
+      /* Not found in the cache.  Look up the best route to this address in
+       * the routing table.
        */
 
-      ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+      ret = net_lookuproute_ipv6(target, net_ipv6_match, &match);
+
+#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
+      /* Add the result to the cache, even if there is no route for this
+       * address.
+       */
+
+      net_addcache_ipv6(target, match.router, match.prefixlen);
+#endif
     }
 
+  UNUSED(ret);
+
   /* Did we find a route? */
 
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
-  UNUSED(ret);
   if (match.prefixlen <= prefixlen)
 #else
-  if (ret <= 0)
+  if (match.prefixlen < 0)
 #endif
     {
       /* No.. there is no route for this address */
@@ -394,19 +354,9 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
       return -ENOENT;
     }
 
-  /* We found a route. */
-
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-  /* Add the route to the cache.  If the route is already in the cache, this
-   * will update it to the most recently accessed.
-   */
-
-  net_addcache_ipv6(&match.entry);
-#endif
-
-  /* Return the router address. */
+  /* We found a route.  Return the router address. */
 
-  net_ipv6addr_copy(router, match.IPv6_ROUTER);
+  net_ipv6addr_copy(router, match.router);
   return OK;
 }
 #endif /* CONFIG_NET_IPv6 */
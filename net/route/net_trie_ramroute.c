@@ -0,0 +1,712 @@
+/****************************************************************************
+ * net/route/net_trie_ramroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The in-memory routes are indexed by a path-compressed binary (Patricia)
+ * trie of their prefixes.  Each node holds a prefix and, unless it is an
+ * intermediate node added where two prefixes diverge, the chain of the
+ * routes with that prefix in table order.  The children of a node extend
+ * its prefix by at least one bit, the value of the first such bit
+ * selecting the child.  An intermediate node always has two children, so
+ * a trie of N prefixes has at most 2N - 1 nodes.
+ *
+ * A lookup walks down the path of the target address and visits the
+ * routes whose prefix matches it from the shortest to the longest one,
+ * and the routes of a prefix in table order.  Routes with a netmask that
+ * is not a prefix cannot be indexed: while there is any, the lookups fall
+ * back to the traversal of the whole table.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/net/net.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#  define TRIE_KEYSIZE   16
+#else
+#  define TRIE_KEYSIZE   4
+#endif
+
+#define TRIE_BIT(key, n) (((key)[(n) >> 3] >> (7 - ((n) & 7))) & 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ramroute_trie_link_s
+{
+  FAR struct ramroute_trie_link_s *next;
+  FAR void *route;
+};
+
+struct ramroute_trie_node_s
+{
+  FAR struct ramroute_trie_node_s *child[2];
+  FAR struct ramroute_trie_link_s *routes; /* Routes with this prefix in
+                                            * table order, or NULL for an
+                                            * intermediate node */
+  uint8_t   prefixlen;             /* Prefix length in bits */
+  uint8_t   key[TRIE_KEYSIZE];     /* Prefix, in network order */
+};
+
+struct ramroute_trie_s
+{
+  FAR struct ramroute_trie_node_s *root;
+  FAR struct ramroute_trie_node_s *free;
+  FAR struct ramroute_trie_link_s *freelink;
+  uint8_t   keysize;               /* Address size in bytes */
+  uint16_t  nonprefix;             /* Routes that are not indexed */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+static struct ramroute_trie_node_s
+  g_ipv4_trienodes[2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES];
+static struct ramroute_trie_link_s
+  g_ipv4_trielinks[CONFIG_ROUTE_MAX_IPv4_RAMROUTES];
+static struct ramroute_trie_s g_ipv4_trie;
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+static struct ramroute_trie_node_s
+  g_ipv6_trienodes[2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES];
+static struct ramroute_trie_link_s
+  g_ipv6_trielinks[CONFIG_ROUTE_MAX_IPv6_RAMROUTES];
+static struct ramroute_trie_s g_ipv6_trie;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramroute_trie_init
+ ****************************************************************************/
+
+static void ramroute_trie_init(FAR struct ramroute_trie_s *trie,
+                               FAR struct ramroute_trie_node_s *nodes,
+                               int nnodes,
+                               FAR struct ramroute_trie_link_s *links,
+                               int nlinks, uint8_t keysize)
+{
+  int i;
+
+  trie->root      = NULL;
+  trie->free      = NULL;
+  trie->freelink  = NULL;
+  trie->keysize   = keysize;
+  trie->nonprefix = 0;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      nodes[i].child[0] = trie->free;
+      trie->free        = &nodes[i];
+    }
+
+  for (i = 0; i < nlinks; i++)
+    {
+      links[i].next  = trie->freelink;
+      trie->freelink = &links[i];
+    }
+}
+
+/****************************************************************************
+ * Name: ramroute_trie_link
+ *
+ * Description:
+ *   Allocate the chain link of a route, or return NULL if there is no
+ *   route.
+ *
+ ****************************************************************************/
+
+static FAR struct ramroute_trie_link_s *
+ramroute_trie_link(FAR struct ramroute_trie_s *trie, FAR void *route)
+{
+  FAR struct ramroute_trie_link_s *link;
+
+  if (route == NULL)
+    {
+      return NULL;
+    }
+
+  /* The pool holds one link per route, it cannot be exhausted */
+
+  link = trie->freelink;
+  DEBUGASSERT(link != NULL);
+  trie->freelink = link->next;
+
+  link->next  = NULL;
+  link->route = route;
+  return link;
+}
+
+/****************************************************************************
+ * Name: ramroute_trie_alloc
+ ****************************************************************************/
+
+static FAR struct ramroute_trie_node_s *
+ramroute_trie_alloc(FAR struct ramroute_trie_s *trie,
+                    FAR const uint8_t *key, uint8_t prefixlen,
+                    FAR void *route)
+{
+  FAR struct ramroute_trie_node_s *node = trie->free;
+  int i;
+
+  /* The pool holds two nodes per route, it cannot be exhausted */
+
+  DEBUGASSERT(node != NULL);
+  trie->free = node->child[0];
+
+  node->child[0]  = NULL;
+  node->child[1]  = NULL;
+  node->routes    = ramroute_trie_link(trie, route);
+  node->prefixlen = prefixlen;
+
+  /* Keep only the bits of the prefix */
+
+  for (i = 0; i < trie->keysize; i++)
+    {
+      if (prefixlen >= 8 * (i + 1))
+        {
+          node->key[i] = key[i];
+        }
+      else if (prefixlen > 8 * i)
+        {
+          node->key[i] = key[i] & (0xff << (8 * (i + 1) - prefixlen));
+        }
+      else
+        {
+          node->key[i] = 0;
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: ramroute_trie_free
+ ****************************************************************************/
+
+static void ramroute_trie_free(FAR struct ramroute_trie_s *trie,
+                               FAR struct ramroute_trie_node_s *node)
+{
+  node->child[0] = trie->free;
+  trie->free     = node;
+}
+
+/****************************************************************************
+ * Name: ramroute_trie_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a netmask, or -1 if the netmask is not a
+ *   prefix.
+ *
+ ****************************************************************************/
+
+static int ramroute_trie_prefixlen(FAR const struct ramroute_trie_s *trie,
+                                   FAR const uint8_t *netmask)
+{
+  int prefixlen = 0;
+  int i;
+
+  for (i = 0; i < trie->keysize && netmask[i] == 0xff; i++)
+    {
+      prefixlen += 8;
+    }
+
+  if (i < trie->keysize)
+    {
+      uint8_t byte = netmask[i++];
+      uint8_t zeroes = ~byte;
+
+      /* The ones of a prefix byte are followed by zeroes only */
+
+      if ((zeroes & (zeroes + 1)) != 0)
+        {
+          return -1;
+        }
+
+      for (; byte != 0; byte <<= 1)
+        {
+          prefixlen++;
+        }
+
+      for (; i < trie->keysize; i++)
+        {
+          if (netmask[i] != 0)
+            {
+              return -1;
+            }
+        }
+    }
+
+  return prefixlen;
+}
+
+/****************************************************************************
+ * Name: ramroute_trie_matchlen
+ *
+ * Description:
+ *   Return the number of leading bits that the prefix of a node and a key
+ *   have in common, up to the shortest of their lengths.
+ *
+ ****************************************************************************/
+
+static int ramroute_trie_matchlen(FAR const struct ramroute_trie_s *trie,
+                                  FAR const struct ramroute_trie_node_s *node,
+                                  FAR const uint8_t *key, int prefixlen)
+{
+  int limit = MIN(node->prefixlen, prefixlen);
+  int matchlen = 0;
+  int i;
+
+  for (i = 0; i < trie->keysize && matchlen < limit; i++)
+    {
+      uint8_t diff = node->key[i] ^ key[i];
+
+      if (diff != 0)
+        {
+          for (; (diff & 0x80) == 0; diff <<= 1)
+            {
+              matchlen++;
+            }
+
+          break;
+        }
+
+      matchlen += 8;
+    }
+
+  return MIN(matchlen, limit);
+}
+
+/****************************************************************************
+ * Name: ramroute_trie_insert
+ *
+ * Description:
+ *   Index a route.  The routes are added in table order, a route with the
+ *   same prefix as indexed ones is chained after them.
+ *
+ ****************************************************************************/
+
+static void ramroute_trie_insert(FAR struct ramroute_trie_s *trie,
+                                 FAR const uint8_t *key,
+                                 FAR const uint8_t *netmask,
+                                 FAR void *route)
+{
+  FAR struct ramroute_trie_node_s **slot = &trie->root;
+  FAR struct ramroute_trie_link_s **link;
+  FAR struct ramroute_trie_node_s *inter;
+  FAR struct ramroute_trie_node_s *node;
+  FAR struct ramroute_trie_node_s *new;
+  int prefixlen;
+  int matchlen = 0;
+
+  prefixlen = ramroute_trie_prefixlen(trie, netmask);
+  if (prefixlen < 0)
+    {
+      trie->nonprefix++;
+      return;
+    }
+
+  /* Go down while the prefix of the node is a strict prefix of the new
+   * one.
+   */
+
+  while ((node = *slot) != NULL)
+    {
+      matchlen = ramroute_trie_matchlen(trie, node, key, prefixlen);
+      if (node->prefixlen != matchlen || node->prefixlen == prefixlen)
+        {
+          break;
+        }
+
+      slot = &node->child[TRIE_BIT(key, node->prefixlen)];
+    }
+
+  if (node != NULL && node->prefixlen == prefixlen &&
+      matchlen == prefixlen)
+    {
+      /* Same prefix, chain the route after the indexed ones, or fill an
+       * intermediate node.
+       */
+
+      link = &node->routes;
+      while (*link != NULL)
+        {
+          link = &(*link)->next;
+        }
+
+      *link = ramroute_trie_link(trie, route);
+      return;
+    }
+
+  new = ramroute_trie_alloc(trie, key, prefixlen, route);
+  if (node == NULL)
+    {
+      *slot = new;
+    }
+  else if (matchlen == prefixlen)
+    {
+      /* The new prefix is a prefix of the node */
+
+      new->child[TRIE_BIT(node->key, matchlen)] = node;
+      *slot = new;
+    }
+  else
+    {
+      /* The prefixes diverge after matchlen bits */
+
+      inter = ramroute_trie_alloc(trie, key, matchlen, NULL);
+      inter->child[TRIE_BIT(key, matchlen)]       = new;
+      inter->child[TRIE_BIT(node->key, matchlen)] = node;
+      *slot = inter;
+    }
+}
+
+/****************************************************************************
+ * Name: ramroute_trie_remove
+ *
+ * Description:
+ *   Remove a route from the index.
+ *
+ ****************************************************************************/
+
+static void ramroute_trie_remove(FAR struct ramroute_trie_s *trie,
+                                 FAR const uint8_t *key,
+                                 FAR const uint8_t *netmask,
+                                 FAR void *route)
+{
+  FAR struct ramroute_trie_node_s **pslot = NULL;
+  FAR struct ramroute_trie_node_s **slot = &trie->root;
+  FAR struct ramroute_trie_node_s *parent = NULL;
+  FAR struct ramroute_trie_link_s **plink;
+  FAR struct ramroute_trie_link_s *link;
+  FAR struct ramroute_trie_node_s *node;
+  int prefixlen;
+
+  prefixlen = ramroute_trie_prefixlen(trie, netmask);
+  if (prefixlen < 0)
+    {
+      DEBUGASSERT(trie->nonprefix > 0);
+      trie->nonprefix--;
+      return;
+    }
+
+  while ((node = *slot) != NULL)
+    {
+      if (ramroute_trie_matchlen(trie, node, key, prefixlen) !=
+          node->prefixlen || node->prefixlen == prefixlen)
+        {
+          break;
+        }
+
+      parent = node;
+      pslot  = slot;
+      slot   = &node->child[TRIE_BIT(key, node->prefixlen)];
+    }
+
+  if (node == NULL || node->prefixlen != prefixlen ||
+      ramroute_trie_matchlen(trie, node, key, prefixlen) != prefixlen)
+    {
+      DEBUGPANIC();
+      return;
+    }
+
+  /* Unlink the route from the chain of its prefix */
+
+  for (plink = &node->routes; (link = *plink) != NULL; plink = &link->next)
+    {
+      if (link->route == route)
+        {
+          *plink         = link->next;
+          link->next     = trie->freelink;
+          trie->freelink = link;
+          break;
+        }
+    }
+
+  /* Keep the node while other routes with the same prefix are indexed,
+   * or as an intermediate node where its children diverge.
+   */
+
+  DEBUGASSERT(link != NULL);
+  if (node->routes != NULL ||
+      (node->child[0] != NULL && node->child[1] != NULL))
+    {
+      return;
+    }
+
+  if (node->child[0] == NULL && node->child[1] == NULL &&
+      parent != NULL && parent->routes == NULL)
+    {
+      /* The intermediate parent is not needed anymore either */
+
+      *pslot = parent->child[parent->child[0] == node];
+      ramroute_trie_free(trie, parent);
+      ramroute_trie_free(trie, node);
+    }
+  else
+    {
+      *slot = node->child[node->child[0] == NULL];
+      ramroute_trie_free(trie, node);
+    }
+}
+
+/****************************************************************************
+ * Name: ramroute_trie_next
+ *
+ * Description:
+ *   Return the next node on the path of a key, after 'node' or from the
+ *   root if it is NULL, that holds a route matching the key.
+ *
+ ****************************************************************************/
+
+static FAR struct ramroute_trie_node_s *
+ramroute_trie_next(FAR struct ramroute_trie_s *trie, FAR const uint8_t *key,
+                   FAR struct ramroute_trie_node_s *node)
+{
+  int maxlen = 8 * trie->keysize;
+
+  if (node == NULL)
+    {
+      node = trie->root;
+    }
+  else if (node->prefixlen < maxlen)
+    {
+      node = node->child[TRIE_BIT(key, node->prefixlen)];
+    }
+  else
+    {
+      return NULL;
+    }
+
+  while (node != NULL &&
+         ramroute_trie_matchlen(trie, node, key, maxlen) == node->prefixlen)
+    {
+      if (node->routes != NULL)
+        {
+          return node;
+        }
+
+      /* An intermediate node is always shorter than an address */
+
+      node = node->child[TRIE_BIT(key, node->prefixlen)];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_ramroute_trie
+ *
+ * Description:
+ *   Initialize the indexes of the in-memory routing tables.
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_ramroute_trie(void)
+{
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+  ramroute_trie_init(&g_ipv4_trie, g_ipv4_trienodes,
+                     nitems(g_ipv4_trienodes), g_ipv4_trielinks,
+                     nitems(g_ipv4_trielinks), sizeof(in_addr_t));
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+  ramroute_trie_init(&g_ipv6_trie, g_ipv6_trienodes,
+                     nitems(g_ipv6_trienodes), g_ipv6_trielinks,
+                     nitems(g_ipv6_trielinks), sizeof(net_ipv6addr_t));
+#endif
+}
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_add and ramroute_ipv6_trie_add
+ *
+ * Description:
+ *   Index a route added to the in-memory routing table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void ramroute_ipv4_trie_add(FAR struct net_route_ipv4_s *route)
+{
+  ramroute_trie_insert(&g_ipv4_trie, (FAR const uint8_t *)&route->target,
+                       (FAR const uint8_t *)&route->netmask, route);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void ramroute_ipv6_trie_add(FAR struct net_route_ipv6_s *route)
+{
+  ramroute_trie_insert(&g_ipv6_trie, (FAR const uint8_t *)route->target,
+                       (FAR const uint8_t *)route->netmask, route);
+}
+#endif
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_del and ramroute_ipv6_trie_del
+ *
+ * Description:
+ *   Remove a route from the index after it was removed from the in-memory
+ *   routing table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void ramroute_ipv4_trie_del(FAR struct net_route_ipv4_s *route)
+{
+  ramroute_trie_remove(&g_ipv4_trie, (FAR const uint8_t *)&route->target,
+                       (FAR const uint8_t *)&route->netmask, route);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void ramroute_ipv6_trie_del(FAR struct net_route_ipv6_s *route)
+{
+  ramroute_trie_remove(&g_ipv6_trie, (FAR const uint8_t *)route->target,
+                       (FAR const uint8_t *)route->netmask, route);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lookuproute_ipv4 and net_lookuproute_ipv6
+ *
+ * Description:
+ *   Visit the routes of the in-memory routing table whose prefix matches a
+ *   target address, from the shortest to the longest prefix.
+ *
+ * Input Parameters:
+ *   target  - The address to look up.
+ *   handler - Will be called for each matching route.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all of the matching routes were visited.
+ *   Handlers may also terminate the search early with any non-zero,
+ *   non-negative value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lookuproute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                         FAR void *arg)
+{
+  FAR struct ramroute_trie_node_s *node = NULL;
+  FAR struct ramroute_trie_link_s *link;
+  int ret = 0;
+
+  net_lock();
+
+  if (g_ipv4_trie.nonprefix > 0)
+    {
+      ret = net_foreachroute_ipv4(handler, arg);
+    }
+  else
+    {
+      while (ret == 0 &&
+             (node = ramroute_trie_next(&g_ipv4_trie,
+                                        (FAR const uint8_t *)&target,
+                                        node)) != NULL)
+        {
+          for (link = node->routes; ret == 0 && link != NULL;
+               link = link->next)
+            {
+              ret = handler(link->route, arg);
+            }
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lookuproute_ipv6(const net_ipv6addr_t target,
+                         route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct ramroute_trie_node_s *node = NULL;
+  FAR struct ramroute_trie_link_s *link;
+  int ret = 0;
+
+  net_lock();
+
+  if (g_ipv6_trie.nonprefix > 0)
+    {
+      ret = net_foreachroute_ipv6(handler, arg);
+    }
+  else
+    {
+      while (ret == 0 &&
+             (node = ramroute_trie_next(&g_ipv6_trie,
+                                        (FAR const uint8_t *)target,
+                                        node)) != NULL)
+        {
+          for (link = node->routes; ret == 0 && link != NULL;
+               link = link->next)
+            {
+              ret = handler(link->route, arg);
+            }
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
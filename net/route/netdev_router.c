@@ -34,28 +34,11 @@
 #include <nuttx/net/ip.h>
 
 #include "netdev/netdev.h"
-#include "route/cacheroute.h"
 #include "route/route.h"
 #include "utils/utils.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-#  define IPv4_ROUTER entry.router
-#else
-#  define IPv4_ROUTER router
-#endif
-
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-#  define IPv6_ROUTER entry.router
-#else
-#  define IPv6_ROUTER router
-#endif
-
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -65,11 +48,7 @@ struct route_ipv4_devmatch_s
 {
   FAR struct net_driver_s *dev;  /* The route must use this device */
   in_addr_t target;              /* Target IPv4 address on remote network */
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-  struct net_route_ipv4_s entry; /* Full entry from the IPv4 routing table */
-#else
   in_addr_t router;              /* IPv4 address of router a local networks */
-#endif
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
   /* Only match prefix longer than prefixlen, equals to entry.netmask if we
    * have got a match (then we only find longer prefix later).
@@ -86,11 +65,7 @@ struct route_ipv6_devmatch_s
 {
   FAR struct net_driver_s *dev;  /* The route must use this device */
   net_ipv6addr_t target;         /* Target IPv4 address on remote network */
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-  struct net_route_ipv6_s entry; /* Full entry from the IPv6 routing table */
-#else
   net_ipv6addr_t router;         /* IPv6 address of router a local networks */
-#endif
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
   /* Only match prefix longer than prefixlen, equals to entry.netmask if we
    * have got a match (then we only find longer prefix later).
@@ -147,15 +122,9 @@ static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
 #endif
       )
     {
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-      /* They match.. Copy the entire routing table entry */
-
-      memcpy(&match->entry, route, sizeof(struct net_route_ipv4_s));
-#else
       /* They match.. Copy the router address */
 
       net_ipv4addr_copy(match->router, route->router);
-#endif
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
       /* Cache the prefix length */
 
@@ -210,15 +179,9 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
 #endif
       )
     {
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-      /* They match.. Copy the entire routing table entry */
-
-      memcpy(&match->entry, route, sizeof(struct net_route_ipv6_s));
-#else
       /* They match.. Copy the router address */
 
       net_ipv6addr_copy(match->router, route->router);
-#endif
 #ifdef CONFIG_ROUTE_LONGEST_MATCH
       /* Cache the prefix length */
 
@@ -273,19 +236,11 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
   match.prefixlen = -1;
 #endif
 
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-  /* First see if we can find a router entry in the cache */
-
-  ret = net_foreachcache_ipv4(net_ipv4_devmatch, &match);
-  if (ret <= 0)
-#endif
-    {
-      /* Not found in the cache.  Try to find a router entry with the
-       * routing table that can forward to this address
-       */
+  /* Try to find a router entry with the routing table that can forward
+   * to this address
+   */
 
-      ret = net_foreachroute_ipv4(net_ipv4_devmatch, &match);
-    }
+  ret = net_lookuproute_ipv4(match.target, net_ipv4_devmatch, &match);
 
   /* Did we find a route? */
 
@@ -296,19 +251,9 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
   if (ret > 0)
 #endif
     {
-      /* We found a route. */
-
-#ifdef CONFIG_ROUTE_IPv4_CACHEROUTE
-      /* Add the route to the cache.  If the route is already in the cache,
-       * this will update it to the most recently accessed.
-       */
-
-      ret = net_addcache_ipv4(&match.entry);
-#endif
-
-      /* We Return the router address. */
+      /* We found a route.  Return the router address. */
 
-      net_ipv4addr_copy(*router, match.IPv4_ROUTER);
+      net_ipv4addr_copy(*router, match.router);
     }
   else
     {
@@ -360,19 +305,11 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
   match.prefixlen = -1;
 #endif
 
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-  /* First see if we can find a router entry in the cache */
-
-  ret = net_foreachcache_ipv6(net_ipv6_devmatch, &match);
-  if (ret <= 0)
-#endif
-    {
-      /* Not found in the cache.  Try to find a router entry with the
-       * routing table that can forward to this address
-       */
+  /* Try to find a router entry with the routing table that can forward
+   * to this address
+   */
 
-      ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
-    }
+  ret = net_lookuproute_ipv6(match.target, net_ipv6_devmatch, &match);
 
   /* Did we find a route? */
 
@@ -383,18 +320,9 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
   if (ret > 0)
 #endif
     {
-      /* We found a route. */
-
-#ifdef CONFIG_ROUTE_IPv6_CACHEROUTE
-      /* Add the route to the cache.  If the route is already in the cache,
-       * this will update it to the most recently accessed.
-       */
-
-      ret = net_addcache_ipv6(&match.entry);
-#endif
-      /* Return the router address. */
+      /* We found a route.  Return the router address. */
 
-      net_ipv6addr_copy(router, match.IPv6_ROUTER);
+      net_ipv6addr_copy(router, match.router);
     }
   else
     {
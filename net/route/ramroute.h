@@ -218,5 +218,54 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
                        FAR struct net_route_ipv6_queue_s *list);
 #endif
 
+/****************************************************************************
+ * Name: net_init_ramroute_trie
+ *
+ * Description:
+ *   Initialize the indexes of the in-memory routing tables.
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_TRIE
+void net_init_ramroute_trie(void);
+#endif
+
+/****************************************************************************
+ * Name: ramroute_ipv4_trie_add/del and ramroute_ipv6_trie_add/del
+ *
+ * Description:
+ *   Update the index of an in-memory routing table: after a route is added
+ *   to the table, and after a route is removed from it.
+ *
+ * Input Parameters:
+ *   route - The route added or removed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+void ramroute_ipv4_trie_add(FAR struct net_route_ipv4_s *route);
+void ramroute_ipv4_trie_del(FAR struct net_route_ipv4_s *route);
+#else
+#  define ramroute_ipv4_trie_add(route)
+#  define ramroute_ipv4_trie_del(route)
+#endif
+
+#if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+void ramroute_ipv6_trie_add(FAR struct net_route_ipv6_s *route);
+void ramroute_ipv6_trie_del(FAR struct net_route_ipv6_s *route);
+#else
+#  define ramroute_ipv6_trie_add(route)
+#  define ramroute_ipv6_trie_del(route)
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
 #endif /* __NET_ROUTE_RAMROUTE_H */
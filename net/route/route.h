@@ -283,6 +283,43 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: net_lookuproute_ipv4/net_lookuproute_ipv6
+ *
+ * Description:
+ *   Visit the routes of the routing table that may match a target address.
+ *   The in-memory routing tables are indexed by a trie when
+ *   CONFIG_ROUTE_TRIE is enabled, and only the matching routes are visited
+ *   from the shortest to the longest prefix, the routes with the same
+ *   prefix in table order.  Otherwise, the whole table
+ *   is traversed.
+ *
+ * Input Parameters:
+ *   target  - The address to look up.
+ *   handler - Will be called for each route visited.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   The same as net_foreachroute_ipv4/net_foreachroute_ipv6.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+int net_lookuproute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                         FAR void *arg);
+#elif defined(CONFIG_NET_IPv4)
+#  define net_lookuproute_ipv4(target, handler, arg) \
+     net_foreachroute_ipv4(handler, arg)
+#endif
+
+#if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+int net_lookuproute_ipv6(const net_ipv6addr_t target,
+                         route_handler_ipv6_t handler, FAR void *arg);
+#elif defined(CONFIG_NET_IPv6)
+#  define net_lookuproute_ipv6(target, handler, arg) \
+     net_foreachroute_ipv6(handler, arg)
+#endif
+
 /****************************************************************************
  * Name: net_ipv4_dumproute and net_ipv6_dumproute
  *
@@ -156,6 +156,9 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:  /* Generates a timestamp for each incoming packet */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      case SO_ZEROCOPY:   /* Allow the MSG_ZEROCOPY send flag */
 #endif
         {
           sockopt_t optionset;
@@ -74,11 +74,32 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 {
   unsigned long msg_controllen;
   FAR void *msg_control;
+  bool iovreq = true;
   int ret;
 
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* Only a control message is read from the error queue of a TCP socket,
+   * the data buffer is optional.
+   */
+
+  if ((flags & MSG_ERRQUEUE) != 0 && psock->s_type == SOCK_STREAM &&
+      (psock->s_domain == PF_INET || psock->s_domain == PF_INET6))
+    {
+      iovreq = false;
+    }
+#endif
+
   /* Verify that non-NULL pointers were passed */
 
-  if (msg == NULL || msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
+  if (msg == NULL || (iovreq && (msg->msg_iov == NULL ||
+                                 msg->msg_iov->iov_base == NULL)))
     {
       return -EINVAL;
     }
@@ -88,18 +109,11 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       return -EINVAL;
     }
 
-  if (msg->msg_iovlen != 1)
+  if (iovreq && msg->msg_iovlen != 1)
     {
       return -ENOTSUP;
     }
 
-  /* Verify that the sockfd corresponds to valid, allocated socket */
-
-  if (psock == NULL || psock->s_conn == NULL)
-    {
-      return -EBADF;
-    }
-
   /* Let logic specific to this address family handle the recvmsg()
    * operation.
    */
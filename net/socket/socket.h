@@ -66,10 +66,11 @@
 #define _SO_TYPE         _SO_BIT(SO_TYPE)
 #define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
 #define _SO_BINDTODEVICE _SO_BIT(SO_BINDTODEVICE)
+#define _SO_ZEROCOPY     _SO_BIT(SO_ZEROCOPY)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (18)
+#define _SO_MAXOPT       (19)
 
 /* Macros to set, test, clear options */
 
@@ -94,6 +95,14 @@
 #  define _SO_TIMEOUT(t) (UINT_MAX)
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/* The inet sockets release the network lock while they wait, so a batch of
+ * messages may be processed with the lock held: the device polls then pick
+ * the whole batch up at once instead of one message at a time.
+ */
+
+#define _SO_BATCHLOCK(s) ((s)->s_domain == PF_INET || \
+                          (s)->s_domain == PF_INET6)
+
 /* Macro to set socket errors */
 
 #ifdef CONFIG_NET_SOCKOPTS
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -131,6 +132,40 @@
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* Increments a size inc and holds at max value rather than rollover. */
+
+#define CC_CWND_INC(wnd, inc) \
+ do { \
+  if ((uint32_t)((wnd) + (inc)) >= (wnd)) \
+    { \
+      (wnd) = (uint32_t)((wnd) + (inc)); \
+    } \
+  else \
+    { \
+      (wnd) = (uint32_t)-1; \
+    } \
+ } while(0)
+
+/* The size of the private state of the congestion control algorithms */
+
+#if defined(CONFIG_NET_TCP_CC_BBR)
+#  define TCP_CC_PRIV_SIZE 48
+#elif defined(CONFIG_NET_TCP_CC_CUBIC)
+#  define TCP_CC_PRIV_SIZE 16
+#endif
+
+/* The algorithm of the new connections */
+
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_cubic)
+#elif defined(CONFIG_NET_TCP_CC_DEFAULT_BBR)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_bbr)
+#else
+#  define TCP_CC_DEFAULT (&g_tcp_cc_newreno)
+#endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -153,6 +188,7 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_cc_ops_s;      /* Forward reference */
 
 /* This is a container that holds the poll-related information */
 
@@ -212,6 +248,8 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+  hash_node_t hnode;      /* Link in the connection hashtable */
+  hash_node_t pnode;      /* Link in the local port hashtable */
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -256,6 +294,12 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  FAR const struct tcp_cc_ops_s *cc_ops; /* The congestion control
+                                          * algorithm */
+#ifdef TCP_CC_PRIV_SIZE
+  uint32_t cc_priv[TCP_CC_PRIV_SIZE / 4]; /* Private state of cc_ops */
+#endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -386,6 +430,17 @@ struct tcp_conn_s
   FAR struct devif_callback_s *sndcb;
 #endif
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY sends are numbered, the range of the completed ones not
+   * yet read from the error queue is zc_lo..zc_hi.
+   */
+
+  uint32_t   zc_next;     /* Id of the send in progress */
+  uint32_t   zc_lo;       /* First completed send */
+  uint32_t   zc_hi;       /* Last completed send */
+  bool       zc_pending;  /* True: zc_lo..zc_hi is to be reported */
+#endif
+
   /* accept() is called when the TCP logic has created a connection
    *
    *   accept_private: This is private data that will be available to the
@@ -419,6 +474,11 @@ struct tcp_wrbuffer_s
   uint8_t    wb_nack;      /* The number of ack count */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  FAR struct tcp_conn_s *wb_zcconn; /* Connection of a MSG_ZEROCOPY send, the
+                                     * IOBs reference the user buffer */
+  uint32_t   wb_zcid;      /* Id of the MSG_ZEROCOPY send */
+#endif
 };
 #endif
 
@@ -443,6 +503,42 @@ struct tcp_backlog_s
 };
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  The loss detection and the recovery
+ * (fast retransmit, NewReno fast recovery and RTO) are common, the
+ * algorithm decides how the window grows and how much it shrinks on loss.
+ */
+
+struct tcp_cc_ops_s
+{
+  /* The name used with the TCP_CONGESTION socket option */
+
+  FAR const char *name;
+
+  /* init - Optional, reset the private state (conn->cc_priv) when the
+   *   connection starts or switches to the algorithm.
+   */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* cong_avoid - Grow cwnd on an ACK of new data, 'acked' bytes, outside
+   *   of the fast recovery.
+   */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* ssthresh - Return the slow start threshold after a loss */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* rto - Optional, set cwnd after a retransmission timeout.  Without it,
+   *   cwnd collapses to one segment (RFC5681).
+   */
+
+  CODE void (*rto)(FAR struct tcp_conn_s *conn);
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -452,6 +548,16 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#endif
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -1879,6 +1985,93 @@ uint32_t tcp_wrbuffer_inqueue_size(FAR struct tcp_conn_s *conn);
 int tcp_wrbuffer_test(void);
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+/****************************************************************************
+ * Name: tcp_zerocopy_append
+ *
+ * Description:
+ *   Add the user data to an empty write buffer of a MSG_ZEROCOPY send, by
+ *   reference.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   wrb  - The write buffer, holding no data
+ *   buf  - The user data, that must stay valid until the send completes
+ *   len  - The length of the user data
+ *
+ * Returned Value:
+ *   The number of bytes added, or -ENOMEM if none could be.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_append(FAR struct tcp_conn_s *conn,
+                            FAR struct tcp_wrbuffer_s *wrb,
+                            FAR const uint8_t *buf, size_t len);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_finish
+ *
+ * Description:
+ *   End a MSG_ZEROCOPY send that queued some data.  It completes when the
+ *   last of its write buffers is released.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_finish(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_release
+ *
+ * Description:
+ *   A write buffer of a MSG_ZEROCOPY send is released, complete the send if
+ *   it was the last one.  The write buffer must not be in the queues of the
+ *   connection anymore.
+ *
+ * Input Parameters:
+ *   wrb - The released write buffer
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_release(FAR struct tcp_wrbuffer_s *wrb);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Read the completions of the MSG_ZEROCOPY sends from the error queue, as
+ *   an IP_RECVERR or IPV6_RECVERR control message.
+ *
+ * Input Parameters:
+ *   psock - The socket of interest
+ *   msg   - Buffer to receive the control message
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EAGAIN if no send completed.
+ *
+ ****************************************************************************/
+
+int tcp_zerocopy_recverr(FAR struct socket *psock, FAR struct msghdr *msg);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_pending
+ *
+ * Description:
+ *   True if completions are waiting to be read from the error queue.
+ *
+ ****************************************************************************/
+
+#  define tcp_zerocopy_pending(conn) ((conn)->zc_pending)
+#endif /* CONFIG_NET_TCP_ZEROCOPY */
+
 /****************************************************************************
  * Name: tcp_event_handler_dump
  *
@@ -2307,6 +2500,46 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_rto
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_set
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, as
+ *   with the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_set(FAR struct tcp_conn_s *conn, FAR const char *name);
 #endif
 
 #ifdef __cplusplus
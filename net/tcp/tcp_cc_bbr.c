@@ -0,0 +1,367 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A delay-based congestion control modeled after BBR: the window follows
+ * the bandwidth-delay product estimated from the delivery rate and the
+ * minimum RTT, instead of reacting to losses.  The stack has no pacing, so
+ * only the window is controlled:
+ *
+ *   STARTUP   - Grow the window exponentially until the delivery rate
+ *               stops increasing for BBR_FULL_BW_ROUNDS rounds.
+ *   PROBE_BW  - Keep twice the BDP in flight, probing for more bandwidth
+ *               by cycling through window gains, one phase per round.
+ *   PROBE_RTT - When the minimum RTT has not been seen for
+ *               BBR_MIN_RTT_WIN ms, drain the queue for BBR_PROBE_RTT_TIME
+ *               ms to measure it again.
+ *
+ * A round is the time for the data sent at its start to be acknowledged,
+ * which gives the RTT and the delivery rate samples.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <debug.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BBR_STARTUP          0
+#define BBR_PROBE_BW         1
+#define BBR_PROBE_RTT        2
+
+#define BBR_FULL_BW_ROUNDS   3     /* Rounds without growth in STARTUP */
+#define BBR_BW_ROUNDS        10    /* Length of the bandwidth max filter */
+#define BBR_MIN_RTT_WIN      10000 /* Length of the min RTT filter (ms) */
+#define BBR_PROBE_RTT_TIME   200   /* Time spent in PROBE_RTT (ms) */
+#define BBR_MIN_CWND_SEGS    4
+
+/* The window gains of PROBE_BW, in quarters */
+
+#define BBR_CWND_GAIN        2
+#define BBR_GAIN_CYCLE       8
+
+#define BBR_NOW()            ((uint32_t)TICK2MSEC(clock_systime_ticks()))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tcp_bbr_s
+{
+  uint32_t min_rtt;          /* Minimum RTT (ms) */
+  uint32_t min_rtt_stamp;    /* When min_rtt was measured (ms) */
+  uint32_t bw[2];            /* Max delivery rate of the current and of the
+                              * previous BBR_BW_ROUNDS rounds (bytes/s) */
+  uint32_t full_bw;          /* Delivery rate at the last STARTUP growth */
+  uint32_t round_start;      /* Start time of the round (ms) */
+  uint32_t round_seq;        /* The round ends when this is acked */
+  uint32_t delivered;        /* Bytes acked in the round */
+  uint32_t probe_rtt_done;   /* End time of PROBE_RTT (ms) */
+  uint32_t prior_cwnd;       /* cwnd before PROBE_RTT */
+  uint8_t  mode;             /* BBR_STARTUP, BBR_PROBE_BW or BBR_PROBE_RTT */
+  uint8_t  cycle;            /* Phase in the PROBE_BW gain cycle */
+  uint8_t  full_bw_cnt;      /* Rounds without growth in STARTUP */
+  uint8_t  rounds;           /* Rounds in the current bw[] slot */
+};
+
+static_assert(sizeof(struct tcp_bbr_s) <= TCP_CC_PRIV_SIZE,
+              "TCP_CC_PRIV_SIZE is too small for BBR");
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_bbr_init(FAR struct tcp_conn_s *conn);
+static void tcp_bbr_cong_avoid(FAR struct tcp_conn_s *conn,
+                               uint32_t acked);
+static uint32_t tcp_bbr_ssthresh(FAR struct tcp_conn_s *conn);
+static void tcp_bbr_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Probe for more bandwidth for one round, drain the queue that it built
+ * for one round, then cruise.
+ */
+
+static const uint8_t g_bbr_gain[BBR_GAIN_CYCLE] =
+{
+  5, 3, 4, 4, 4, 4, 4, 4
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",                    /* name */
+  tcp_bbr_init,             /* init */
+  tcp_bbr_cong_avoid,       /* cong_avoid */
+  tcp_bbr_ssthresh,         /* ssthresh */
+  tcp_bbr_rto               /* rto */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_bbr_max_bw
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_max_bw(FAR struct tcp_bbr_s *bbr)
+{
+  return MAX(bbr->bw[0], bbr->bw[1]);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_target
+ *
+ * Description:
+ *   The window for a gain, in quarters, of the estimated BDP.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_target(FAR struct tcp_conn_s *conn,
+                               FAR struct tcp_bbr_s *bbr, uint32_t gain)
+{
+  uint64_t bdp;
+
+  bdp = (uint64_t)tcp_bbr_max_bw(bbr) * bbr->min_rtt / 1000;
+  bdp = bdp * BBR_CWND_GAIN * gain / 4;
+
+  return MAX(MIN(bdp, UINT32_MAX), BBR_MIN_CWND_SEGS * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_round
+ *
+ * Description:
+ *   Take the RTT and delivery rate samples at the end of a round, and
+ *   advance the state machine.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_round(FAR struct tcp_conn_s *conn,
+                          FAR struct tcp_bbr_s *bbr, uint32_t now)
+{
+  uint32_t rtt = MAX(now - bbr->round_start, 1);
+  uint64_t bw = (uint64_t)bbr->delivered * 1000 / rtt;
+  bool expired = now - bbr->min_rtt_stamp > BBR_MIN_RTT_WIN;
+
+  /* Windowed min RTT, windowed max delivery rate */
+
+  if (rtt <= bbr->min_rtt || expired)
+    {
+      bbr->min_rtt = rtt;
+      bbr->min_rtt_stamp = now;
+    }
+
+  if (++bbr->rounds >= BBR_BW_ROUNDS)
+    {
+      bbr->bw[1] = bbr->bw[0];
+      bbr->bw[0] = 0;
+      bbr->rounds = 0;
+    }
+
+  bbr->bw[0] = MAX(bbr->bw[0], MIN(bw, UINT32_MAX));
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+
+        /* The pipe is full once the delivery rate grows less than 25% for
+         * a few rounds.
+         */
+
+        if (tcp_bbr_max_bw(bbr) >= (uint64_t)bbr->full_bw * 5 / 4)
+          {
+            bbr->full_bw = tcp_bbr_max_bw(bbr);
+            bbr->full_bw_cnt = 0;
+          }
+        else if (++bbr->full_bw_cnt >= BBR_FULL_BW_ROUNDS)
+          {
+            bbr->mode = BBR_PROBE_BW;
+            bbr->cycle = BBR_GAIN_CYCLE - 1;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        bbr->cycle = (bbr->cycle + 1) % BBR_GAIN_CYCLE;
+        break;
+
+      case BBR_PROBE_RTT:
+        if ((int32_t)(now - bbr->probe_rtt_done) >= 0)
+          {
+            bbr->min_rtt_stamp = now;
+            conn->cwnd = MAX(conn->cwnd, bbr->prior_cwnd);
+            bbr->mode = bbr->full_bw_cnt >= BBR_FULL_BW_ROUNDS ?
+                        BBR_PROBE_BW : BBR_STARTUP;
+          }
+        break;
+    }
+
+  /* Enter PROBE_RTT when the min RTT was not seen again in its window */
+
+  if (bbr->mode != BBR_PROBE_RTT && expired)
+    {
+      bbr->mode = BBR_PROBE_RTT;
+      bbr->prior_cwnd = conn->cwnd;
+      bbr->probe_rtt_done = now + BBR_PROBE_RTT_TIME;
+    }
+
+  /* Start the next round */
+
+  bbr->round_start = now;
+  bbr->round_seq = tcp_getsequence(conn->sndseq);
+  bbr->delivered = 0;
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_init
+ ****************************************************************************/
+
+static void tcp_bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = (FAR struct tcp_bbr_s *)conn->cc_priv;
+
+  memset(bbr, 0, sizeof(*bbr));
+  bbr->min_rtt = UINT32_MAX;
+  bbr->min_rtt_stamp = BBR_NOW();
+  bbr->round_start = bbr->min_rtt_stamp;
+  bbr->round_seq = tcp_getsequence(conn->sndseq);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_cong_avoid
+ ****************************************************************************/
+
+static void tcp_bbr_cong_avoid(FAR struct tcp_conn_s *conn,
+                               uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = (FAR struct tcp_bbr_s *)conn->cc_priv;
+  uint32_t now = BBR_NOW();
+  uint32_t target;
+
+  bbr->delivered += acked;
+  if (TCP_SEQ_GTE(conn->last_ackno, bbr->round_seq))
+    {
+      tcp_bbr_round(conn, bbr, now);
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+
+        /* Double the window per round, like slow start */
+
+        CC_CWND_INC(conn->cwnd, acked);
+        break;
+
+      case BBR_PROBE_BW:
+
+        /* Grow towards the target after a loss or an RTO, follow it
+         * otherwise.
+         */
+
+        target = tcp_bbr_target(conn, bbr, g_bbr_gain[bbr->cycle]);
+        if (conn->cwnd < target)
+          {
+            CC_CWND_INC(conn->cwnd, acked);
+            conn->cwnd = MIN(conn->cwnd, target);
+          }
+        else
+          {
+            conn->cwnd = target;
+          }
+        break;
+
+      case BBR_PROBE_RTT:
+        conn->cwnd = BBR_MIN_CWND_SEGS * conn->mss;
+        break;
+    }
+
+  ninfo("update bbr mode %u cwnd to %" PRIu32 "\n", bbr->mode, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_ssthresh
+ *
+ * Description:
+ *   Losses are not a congestion signal, the window is restored after the
+ *   recovery.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->cwnd, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_rto
+ *
+ * Description:
+ *   A timeout is not a congestion signal either: restore the window of the
+ *   model, the estimated BDP, and start a new round so that the time spent
+ *   waiting is not sampled as a delivery rate.  Collapse to one segment
+ *   only if there is no estimate yet.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_rto(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = (FAR struct tcp_bbr_s *)conn->cc_priv;
+
+  if (bbr->min_rtt == UINT32_MAX || tcp_bbr_max_bw(bbr) == 0)
+    {
+      conn->cwnd = conn->mss;
+    }
+  else if (bbr->mode == BBR_PROBE_RTT)
+    {
+      conn->cwnd = BBR_MIN_CWND_SEGS * conn->mss;
+    }
+  else
+    {
+      conn->cwnd = tcp_bbr_target(conn, bbr, 4);
+    }
+
+  bbr->round_start = BBR_NOW();
+  bbr->round_seq   = tcp_getsequence(conn->sndseq);
+  bbr->delivered   = 0;
+}
@@ -0,0 +1,244 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <debug.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The window is W(t) = C * (t - K)^3 + W_max (RFC 8312), in segments and
+ * seconds, with C = 0.4 and a multiplicative decrease of beta = 0.7.  The
+ * computations below are done in milliseconds:
+ *
+ *   K = cbrt(W_max * (1 - beta) / C)     -> cbrt(2.5e9 * dW) ms
+ *   C * (t - K)^3                        -> (t - K)^3 * 4 / 1e10 segments
+ */
+
+#define CUBIC_K_SCALE      2500000000ull
+#define CUBIC_BETA_NUM     7
+#define CUBIC_BETA_DEN     10
+
+/* The time since the epoch start is clamped so that the cube fits */
+
+#define CUBIC_MAX_TIME     (1 << 20)
+
+/* The window of a standard TCP with the same decrease grows by
+ * 3 * (1 - beta) / (1 + beta) segments per RTT.
+ */
+
+#define CUBIC_EST_NUM      9
+#define CUBIC_EST_DEN      17
+
+#define CUBIC_NOW()        ((uint32_t)TICK2MSEC(clock_systime_ticks()))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tcp_cubic_s
+{
+  uint32_t epoch_start;    /* Start of the growth epoch (ms), 0 if none */
+  uint32_t w_max;          /* Window before the last reduction (bytes) */
+  uint32_t k;              /* Time to grow back to w_max (ms) */
+  uint32_t w_est;          /* Window of a standard TCP (bytes) */
+};
+
+static_assert(sizeof(struct tcp_cubic_s) <= TCP_CC_PRIV_SIZE,
+              "TCP_CC_PRIV_SIZE is too small for CUBIC");
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn);
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked);
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                  /* name */
+  tcp_cubic_init,           /* init */
+  tcp_cubic_cong_avoid,     /* cong_avoid */
+  tcp_cubic_ssthresh,       /* ssthresh */
+  NULL                      /* rto */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      if ((x >> s) >= 3 * y * (y + 1) + 1)
+        {
+          x -= (3 * y * (y + 1) + 1) << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_init
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(conn->cc_priv, 0, sizeof(struct tcp_cubic_s));
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_cong_avoid
+ ****************************************************************************/
+
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = (FAR struct tcp_cubic_s *)conn->cc_priv;
+  uint32_t now = CUBIC_NOW();
+  uint64_t increase;
+  int64_t target;
+  int64_t t;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      /* Slow start as standard TCP */
+
+      CC_CWND_INC(conn->cwnd, MIN(acked, conn->mss));
+      return;
+    }
+
+  if (cubic->epoch_start == 0)
+    {
+      /* First ACK after a loss, start a growth epoch */
+
+      cubic->epoch_start = MAX(now, 1);
+      cubic->w_est = conn->cwnd;
+      if (conn->cwnd < cubic->w_max)
+        {
+          cubic->k = tcp_cubic_cbrt((cubic->w_max - conn->cwnd) /
+                                    conn->mss * CUBIC_K_SCALE);
+        }
+      else
+        {
+          cubic->k = 0;
+          cubic->w_max = conn->cwnd;
+        }
+    }
+
+  /* The cubic function of the time since the epoch start */
+
+  t = MIN(now - cubic->epoch_start, CUBIC_MAX_TIME) - (int64_t)cubic->k;
+  target = (int64_t)cubic->w_max +
+           t * t * t / 100000 * 4 * conn->mss / 100000;
+
+  if (target > conn->cwnd)
+    {
+      /* Reach the target in one RTT, but grow by 1.5x per RTT at most */
+
+      increase = (uint64_t)(target - conn->cwnd) * acked / conn->cwnd;
+      increase = MIN(increase, acked / 2);
+    }
+  else
+    {
+      /* Plateau around w_max, grow very slowly */
+
+      increase = (uint64_t)acked * conn->mss / (100 * conn->cwnd);
+    }
+
+  /* Never grow slower than a standard TCP would (TCP-friendly region) */
+
+  cubic->w_est += (uint64_t)acked * conn->mss * CUBIC_EST_NUM /
+                  ((uint64_t)CUBIC_EST_DEN * conn->cwnd);
+  if (cubic->w_est > conn->cwnd)
+    {
+      increase = MAX(increase, (uint64_t)(cubic->w_est - conn->cwnd) *
+                               acked / conn->cwnd);
+    }
+
+  CC_CWND_INC(conn->cwnd, (uint32_t)MAX(increase, 1));
+  ninfo("update cubic cwnd to %" PRIu32 "\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_ssthresh
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = (FAR struct tcp_cubic_s *)conn->cc_priv;
+
+  cubic->epoch_start = 0;
+
+  /* Fast convergence: a flow that lost before reaching its previous
+   * w_max releases bandwidth to the new flows.
+   */
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = (uint64_t)conn->cwnd *
+                     (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+                     (2 * CUBIC_BETA_DEN);
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  return MAX((uint64_t)conn->cwnd * CUBIC_BETA_NUM / CUBIC_BETA_DEN,
+             2 * conn->mss);
+}
@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -91,10 +92,114 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The connected TCP connections hashed by local port, remote port and
+ * remote address, and hashed by local port only.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_conn_hash, CONFIG_NET_TCP_HASH_BITS);
+static DECLARE_HASHTABLE(g_tcp_port_hash, CONFIG_NET_TCP_HASH_BITS);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_ipv4_hashkey/tcp_ipv6_hashkey
+ *
+ * Description:
+ *   Return the connection hashtable key of a local port, remote port and
+ *   remote address.  The local address is not part of the key, because a
+ *   connection bound to INADDR_ANY must be found for any of them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_hashkey(uint16_t lport, uint16_t rport,
+                                        in_addr_t raddr)
+{
+  return raddr ^ ((uint32_t)lport << 16 | rport);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hashkey(uint16_t lport, uint16_t rport,
+                                        FAR const uint16_t *raddr)
+{
+  return ((uint32_t)raddr[0] << 16 | raddr[1]) ^
+         ((uint32_t)raddr[2] << 16 | raddr[3]) ^
+         ((uint32_t)raddr[4] << 16 | raddr[5]) ^
+         ((uint32_t)raddr[6] << 16 | raddr[7]) ^
+         ((uint32_t)lport << 16 | rport);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_hashkey
+ *
+ * Description:
+ *   Return the connection hashtable key of a connection.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_hashkey(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_ipv6_hashkey(conn->lport, conn->rport, conn->u.ipv6.raddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_ipv4_hashkey(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Name: tcp_conn_activate
+ *
+ * Description:
+ *   Add a connection, whose local and remote addresses and ports are set,
+ *   to the list of active connections and to the hashtables.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_conn_activate(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  hashtable_add(g_tcp_conn_hash, &conn->hnode, tcp_conn_hashkey(conn));
+  hashtable_add(g_tcp_port_hash, &conn->pnode, conn->lport);
+}
+
+/****************************************************************************
+ * Name: tcp_conn_deactivate
+ *
+ * Description:
+ *   Remove a connection from the list of active connections and from the
+ *   hashtables.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_conn_deactivate(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+  hashtable_delete(g_tcp_conn_hash, &conn->hnode, tcp_conn_hashkey(conn));
+  hashtable_delete(g_tcp_port_hash, &conn->pnode, conn->lport);
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -111,12 +216,15 @@ static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
                uint16_t portno)
 {
-  FAR struct tcp_conn_s *conn = NULL;
+  FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *p;
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
-  while ((conn = tcp_nextconn(conn)) != NULL)
+  hashtable_for_every_possible(g_tcp_port_hash, p, portno)
     {
+      conn = container_of(p, struct tcp_conn_s, pnode);
+
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -186,15 +294,18 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *p;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
+  hashtable_for_every_possible(g_tcp_conn_hash, p,
+    tcp_ipv4_hashkey(tcp->destport, tcp->srcport, srcipaddr))
     {
+      conn = container_of(p, struct tcp_conn_s, hnode);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -219,19 +330,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -253,15 +358,18 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct tcp_conn_s *conn;
+  FAR hash_node_t *p;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
-  while (conn)
+  hashtable_for_every_possible(g_tcp_conn_hash, p,
+    tcp_ipv6_hashkey(tcp->destport, tcp->srcport, *srcipaddr))
     {
+      conn = container_of(p, struct tcp_conn_s, hnode);
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -286,19 +394,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -795,6 +897,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcv_bufs      = CONFIG_NET_RECV_BUFSIZE;
 #endif
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops        = TCP_CC_DEFAULT;
+#endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs      = CONFIG_NET_SEND_BUFSIZE;
 
@@ -922,7 +1027,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_conn_deactivate(conn);
     }
 
   tcp_free_rx_buffers(conn);
@@ -1206,8 +1311,11 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-      /* Initialize the variables of congestion control */
+      /* Initialize the variables of congestion control, with the
+       * algorithm selected on the listener.
+       */
 
+      conn->cc_ops = listener->cc_ops;
       tcp_cc_init(conn);
 #endif
 
@@ -1231,7 +1339,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_conn_activate(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1542,7 +1650,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_conn_activate(conn);
   ret = OK;
 
 errout_with_lock:
@@ -355,6 +355,15 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLWRNORM;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* Completed MSG_ZEROCOPY sends are waiting in the error queue */
+
+  if (tcp_zerocopy_pending(conn))
+    {
+      eventset |= POLLERR;
+    }
+#endif
+
   /* Check if any requested events are already in effect */
 
   poll_notify(&fds, 1, eventset);
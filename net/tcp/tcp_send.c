@@ -48,6 +48,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <debug.h>
@@ -104,6 +105,49 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_gso_setup
+ *
+ * Description:
+ *   Mark a segment that carries more than one MSS of payload for TCP
+ *   segmentation offload, see netdev_gso_maxsize().
+ *
+ * Input Parameters:
+ *   dev     - The device driver structure to use in the send operation
+ *   conn    - The TCP connection structure holding connection information
+ *   tcp     - The TCP header of the segment
+ *   iplen   - The length of the IP header
+ *   gsotype - IOB_OFFLOAD_GSO_TCPV4 or IOB_OFFLOAD_GSO_TCPV6
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void tcp_gso_setup(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *conn,
+                          FAR struct tcp_hdr_s *tcp,
+                          unsigned int iplen, uint8_t gsotype)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  unsigned int paylen;
+
+  paylen = dev->d_len - iplen - ((tcp->tcpoffset >> 4) << 2);
+  if (conn->mss > 0 && paylen > conn->mss)
+    {
+      iob->io_offload = gsotype;
+      iob->io_gsosize = conn->mss;
+    }
+  else
+    {
+      iob->io_offload = 0;
+    }
+}
+#else
+#  define tcp_gso_setup(dev, conn, tcp, iplen, gsotype)
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -195,12 +239,18 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                         conn->u.ipv6.raddr,
                         conn->sconn.s_ttl, conn->sconn.s_tclass);
 
+      tcp_gso_setup(dev, conn, tcp, IPv6_HDRLEN, IOB_OFFLOAD_GSO_TCPV6);
+
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_txcsum_offload(dev, IP_PROTO_TCP, IPv6_HDRLEN,
+                                 offsetof(struct tcp_hdr_s, tcpchksum)))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -219,12 +269,18 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                         &dev->d_ipaddr, &conn->u.ipv4.raddr,
                         conn->sconn.s_ttl, conn->sconn.s_tos, NULL);
 
+      tcp_gso_setup(dev, conn, tcp, IPv4_HDRLEN, IOB_OFFLOAD_GSO_TCPV4);
+
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_txcsum_offload(dev, IP_PROTO_TCP, IPv4_HDRLEN,
+                                 offsetof(struct tcp_hdr_s, tcpchksum)))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -503,7 +559,11 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_txcsum_offload(dev, IP_PROTO_TCP, IPv6_HDRLEN,
+                                 offsetof(struct tcp_hdr_s, tcpchksum)))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -523,7 +583,11 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_txcsum_offload(dev, IP_PROTO_TCP, IPv4_HDRLEN,
+                                 offsetof(struct tcp_hdr_s, tcpchksum)))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
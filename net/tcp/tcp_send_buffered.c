@@ -36,6 +36,7 @@
 #  define CONFIG_DEBUG_NET 1
 #endif
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 
@@ -88,10 +89,47 @@
 #  define TCP_WBDUMP(msg,wrb,len,offset)
 #endif
 
+/* The write buffers of a MSG_ZEROCOPY send reference the user data */
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+#  define TCP_WBZEROCOPY(wrb) ((wrb)->wb_zcconn != NULL)
+#else
+#  define TCP_WBZEROCOPY(wrb) false
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_max_seg_size
+ *
+ * Description:
+ *   Return the largest amount of data that may be sent in one segment: a
+ *   multiple of the MSS if the device takes larger segments and segments
+ *   them itself or in software, otherwise the MSS.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_max_seg_size(FAR struct net_driver_s *dev,
+                                 FAR struct tcp_conn_s *conn)
+{
+  uint32_t size = conn->mss;
+  uint32_t gsomax;
+
+  gsomax = dev != NULL ? netdev_gso_maxsize(dev) : 0;
+  if (gsomax > tcpip_hdrsize(conn) + 2 * size)
+    {
+      gsomax -= tcpip_hdrsize(conn);
+      size    = gsomax - gsomax % size;
+    }
+
+  return size;
+}
+
 /****************************************************************************
  * Name: psock_insert_segment
  *
@@ -1032,9 +1070,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > tcp_max_seg_size(dev, conn))
             {
-              sndlen = conn->mss;
+              sndlen = tcp_max_seg_size(dev, conn);
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1098,6 +1136,17 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+          /* Let a super-segment exceed the MTU, tcp_send() then sets its
+           * exact GSO type.
+           */
+
+          if (sndlen > conn->mss)
+            {
+              dev->d_iob->io_offload = IOB_OFFLOAD_GSO;
+            }
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
@@ -1189,9 +1238,9 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
   const uint32_t mss = conn->mss;
   uint32_t size;
 
-  /* a few segments should be fine */
+  /* a few segments should be fine, or one super-segment */
 
-  size = 4 * mss;
+  size = MAX(4 * mss, tcp_max_seg_size(conn->dev, conn));
 
   /* but it should not hog too many IOB buffers */
 
@@ -1310,6 +1359,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   unsigned int timeout;
   ssize_t    result = 0;
   bool       nonblock;
+  bool       zerocopy = false;
   int        ret = OK;
   clock_t    start;
 
@@ -1366,6 +1416,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   start    = clock_systime_ticks();
   timeout  = _SO_TIMEOUT(conn->sconn.s_sndtimeo);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY is ignored unless SO_ZEROCOPY was set */
+
+  zerocopy = (flags & MSG_ZEROCOPY) != 0 &&
+             _SO_GETOPT(conn->sconn.s_options, SO_ZEROCOPY);
+#endif
+
   /* Dump the incoming buffer */
 
   BUF_DUMP("psock_tcp_send", buf, len);
@@ -1460,13 +1517,16 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            *
            * Also, for simplicity, do it only when we haven't sent anything
            * from the the wrb yet.
+           *
+           * The data of a MSG_ZEROCOPY send is never mixed with copied data.
            */
 
           max_wrb_size = tcp_max_wrb_size(conn);
           wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->write_q);
           if (wrb != NULL && TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
               TCP_WBPKTLEN(wrb) < max_wrb_size &&
-              (TCP_WBPKTLEN(wrb) % conn->mss) != 0)
+              (TCP_WBPKTLEN(wrb) % conn->mss) != 0 &&
+              !TCP_WBZEROCOPY(wrb) && !zerocopy)
             {
               wrb = (FAR struct tcp_wrbuffer_s *)sq_remlast(&conn->write_q);
               ninfo("coalesce %zu bytes to wrb %p (%" PRIu16 ")\n", len, wrb,
@@ -1526,7 +1586,17 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          if (zerocopy)
+            {
+              chunk_result = tcp_zerocopy_append(conn, wrb, cp, chunk_len);
+            }
+          else
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1653,6 +1723,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   /* Return the number of bytes actually sent */
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if (zerocopy && result > 0)
+    {
+      tcp_zerocopy_finish(conn);
+    }
+#endif
+
   return result;
 
 errout_with_lock:
@@ -1661,6 +1738,13 @@ errout_with_lock:
 errout:
   if (result > 0)
     {
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      if (zerocopy)
+        {
+          tcp_zerocopy_finish(conn);
+        }
+#endif
+
       return result;
     }
 
@@ -26,9 +26,11 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/time.h>
 #include <stdint.h>
 #include <errno.h>
+#include <string.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -260,6 +262,26 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          char name[TCP_CA_NAME_MAX];
+
+          if (value_len == 0 || value_len > TCP_CA_NAME_MAX)
+            {
+              return -EINVAL;
+            }
+
+          /* The name is not necessarily NUL terminated */
+
+          value_len = MIN(value_len, TCP_CA_NAME_MAX - 1);
+          memcpy(name, value, value_len);
+          name[value_len] = '\0';
+          ret = tcp_cc_set(conn, name);
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
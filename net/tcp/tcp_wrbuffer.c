@@ -239,6 +239,16 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
       iob_free_chain(wrb->wb_iob);
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The user buffer is not referenced anymore */
+
+  if (wrb->wb_zcconn != NULL)
+    {
+      tcp_zerocopy_release(wrb);
+      wrb->wb_zcconn = NULL;
+    }
+#endif
+
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   /* Reset the ack counter */
 
@@ -0,0 +1,322 @@
+/****************************************************************************
+ * net/tcp/tcp_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_free
+ *
+ * Description:
+ *   The IOBs only reference the user data, there is nothing to free.  The
+ *   completion is tracked per write buffer instead.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_free(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_inqueue
+ *
+ * Description:
+ *   True if a write buffer of the send is still in the queue.
+ *
+ ****************************************************************************/
+
+static bool tcp_zerocopy_inqueue(FAR sq_queue_t *queue,
+                                 FAR struct tcp_conn_s *conn, uint32_t id)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+
+  for (entry = sq_peek(queue); entry != NULL; entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (wrb->wb_zcconn == conn && wrb->wb_zcid == id)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_complete
+ *
+ * Description:
+ *   Record the completion of a send and wake up the poll waiters.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_complete(FAR struct tcp_conn_s *conn, uint32_t id)
+{
+  int i;
+
+  /* The write buffers are released in sequence order, so every send before
+   * this one has completed too: the range can be extended up to it.
+   */
+
+  if (!conn->zc_pending)
+    {
+      conn->zc_lo      = id;
+      conn->zc_pending = true;
+    }
+
+  conn->zc_hi = id;
+
+  for (i = 0; i < CONFIG_NET_TCP_NPOLLWAITERS; i++)
+    {
+      if (conn->pollinfo[i].conn != NULL)
+        {
+          poll_notify(&conn->pollinfo[i].fds, 1, POLLERR);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_append
+ *
+ * Description:
+ *   Add the user data to an empty write buffer of a MSG_ZEROCOPY send, by
+ *   reference.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *   wrb  - The write buffer, holding no data
+ *   buf  - The user data, that must stay valid until the send completes
+ *   len  - The length of the user data
+ *
+ * Returned Value:
+ *   The number of bytes added, or -ENOMEM if none could be.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_append(FAR struct tcp_conn_s *conn,
+                            FAR struct tcp_wrbuffer_s *wrb,
+                            FAR const uint8_t *buf, size_t len)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *iob;
+  size_t off = 0;
+
+  DEBUGASSERT(TCP_WBPKTLEN(wrb) == 0);
+
+  while (off < len)
+    {
+      uint16_t n = MIN(len - off, UINT16_MAX);
+
+      iob = iob_alloc_with_data((FAR void *)(buf + off), n,
+                                tcp_zerocopy_free);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      iob->io_len = n;
+      if (tail != NULL)
+        {
+          tail->io_flink = iob;
+        }
+      else
+        {
+          head = iob;
+        }
+
+      tail = iob;
+      off += n;
+    }
+
+  if (head == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Replace the empty IOB of the write buffer by the references */
+
+  head->io_pktlen = off;
+  iob_free_chain(wrb->wb_iob);
+  wrb->wb_iob    = head;
+  wrb->wb_zcconn = conn;
+  wrb->wb_zcid   = conn->zc_next;
+
+  return off;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_finish
+ *
+ * Description:
+ *   End a MSG_ZEROCOPY send that queued some data.  It completes when the
+ *   last of its write buffers is released.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_finish(FAR struct tcp_conn_s *conn)
+{
+  uint32_t id;
+
+  net_lock();
+
+  id = conn->zc_next++;
+  if (!tcp_zerocopy_inqueue(&conn->unacked_q, conn, id) &&
+      !tcp_zerocopy_inqueue(&conn->write_q, conn, id))
+    {
+      /* Already acknowledged */
+
+      tcp_zerocopy_complete(conn, id);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_release
+ *
+ * Description:
+ *   A write buffer of a MSG_ZEROCOPY send is released, complete the send if
+ *   it was the last one.  The write buffer must not be in the queues of the
+ *   connection anymore.
+ *
+ * Input Parameters:
+ *   wrb - The released write buffer
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_release(FAR struct tcp_wrbuffer_s *wrb)
+{
+  FAR struct tcp_conn_s *conn = wrb->wb_zcconn;
+  uint32_t id = wrb->wb_zcid;
+
+  /* The send is still in progress if its id was not consumed yet */
+
+  if (id != conn->zc_next &&
+      !tcp_zerocopy_inqueue(&conn->unacked_q, conn, id) &&
+      !tcp_zerocopy_inqueue(&conn->write_q, conn, id))
+    {
+      tcp_zerocopy_complete(conn, id);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Read the completions of the MSG_ZEROCOPY sends from the error queue, as
+ *   an IP_RECVERR or IPV6_RECVERR control message.
+ *
+ * Input Parameters:
+ *   psock - The socket of interest
+ *   msg   - Buffer to receive the control message
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EAGAIN if no send completed.
+ *
+ ****************************************************************************/
+
+int tcp_zerocopy_recverr(FAR struct socket *psock, FAR struct msghdr *msg)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  struct sock_extended_err serr;
+  int level = IPPROTO_IP;
+  int type = IP_RECVERR;
+  int ret = OK;
+
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET6)
+    {
+      level = IPPROTO_IPV6;
+      type  = IPV6_RECVERR;
+    }
+#endif
+
+  net_lock();
+
+  if (!conn->zc_pending)
+    {
+      ret = -EAGAIN;
+      goto out;
+    }
+
+  memset(&serr, 0, sizeof(serr));
+  serr.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  serr.ee_info   = conn->zc_lo;
+  serr.ee_data   = conn->zc_hi;
+
+  /* Keep the completions if they can not be reported */
+
+  if (cmsg_append(msg, level, type, &serr, sizeof(serr)) == NULL)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+      goto out;
+    }
+
+  conn->zc_pending = false;
+  msg->msg_flags |= MSG_ERRQUEUE;
+
+out:
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_TCP_ZEROCOPY */
@@ -32,6 +32,8 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
+#include <nuttx/mutex.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -112,12 +114,16 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+  hash_node_t hnode;      /* Link in the port hashtable, if lport != 0 */
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
   uint8_t  flags;         /* See _UDP_FLAG_* definitions */
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  crefs;         /* Reference counts on this instance */
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+  uint16_t gso_size;      /* UDP_SEGMENT size, 0 if disabled */
+#endif
 
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcvbufs;       /* Maximum amount of bytes queued in recv */
@@ -132,9 +138,12 @@ struct udp_conn_s
   /* Read-ahead buffering.
    *
    *   readahead - An IOB chain where the UDP/IP read-ahead data is retained.
+   *   rdlock    - Protects readahead, which is also accessed without the
+   *               network lock.
    */
 
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
+  mutex_t rdlock;                /* Read-ahead lock */
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Write buffering
@@ -257,6 +266,22 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_set_lport
+ *
+ * Description:
+ *   Bind a UDP connection to a local port, or unbind it if portno is zero.
+ *   The local port must only be changed through this function, so that the
+ *   port hashtable stays consistent.
+ *
+ * Input Parameters:
+ *   conn   - A reference to UDP connection structure.
+ *   portno - The local port in network byte order.
+ *
+ ****************************************************************************/
+
+void udp_set_lport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_select_port
  *
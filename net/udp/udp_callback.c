@@ -79,14 +79,18 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
   int offset;
 
 #if CONFIG_NET_RECV_BUFSIZE > 0
+  nxmutex_lock(&conn->rdlock);
   if (conn->readahead && conn->readahead->io_pktlen > conn->rcvbufs)
     {
+      nxmutex_unlock(&conn->rdlock);
       netdev_iob_release(dev);
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.udp.drop++;
 #endif
       return 0;
     }
+
+  nxmutex_unlock(&conn->rdlock);
 #endif
 
   iob = dev->d_iob;
@@ -216,7 +220,9 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+  nxmutex_lock(&conn->rdlock);
   net_iob_concat(&conn->readahead, &iob);
+  nxmutex_unlock(&conn->rdlock);
 
 #ifdef CONFIG_NET_UDP_NOTIFIER
   ninfo("Buffered %d bytes\n", buflen);
@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/net/netconfig.h>
@@ -93,10 +94,27 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+/* The bound UDP connections hashed by local port */
+
+static DECLARE_HASHTABLE(g_udp_port_hash, CONFIG_NET_UDP_HASH_BITS);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_port_bucket
+ *
+ * Description:
+ *   Return the port hashtable bucket of a local port number.
+ *
+ ****************************************************************************/
+
+static inline FAR hash_head_t *udp_port_bucket(uint16_t portno)
+{
+  return &g_udp_port_hash[HASH(portno, hashtable_bits(g_udp_port_hash))];
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -119,15 +137,18 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
                                             uint16_t portno, sockopt_t opt)
 {
-  FAR struct udp_conn_s *conn = NULL;
+  FAR struct udp_conn_s *conn;
+  FAR hash_node_t *p;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
 #endif
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure bound to this port. */
 
-  while ((conn = udp_nextconn(conn)) != NULL)
+  hashtable_for_every_possible(g_udp_port_hash, p, portno)
     {
+      conn = container_of(p, struct udp_conn_s, hnode);
+
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
        */
@@ -198,11 +219,25 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
+  FAR hash_node_t *p;
 
-  conn = udp_nextconn(conn);
+  /* Only connections bound to the destination port can match, they are
+   * all in the same bucket of the port hashtable.
+   */
+
+  if (conn == NULL)
+    {
+      p = udp_port_bucket(udp->destport)->head;
+    }
+  else
+    {
+      p = conn->hnode.flink;
+    }
 
-  while (conn)
+  for (; p != NULL; p = p->flink)
     {
+      conn = container_of(p, struct udp_conn_s, hnode);
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -292,31 +327,27 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
                    net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
                 {
-                  /* Matching connection found.. Break out of the loop and
-                   * return this reference to it.
+                  /* Matching connection found.. return this reference to
+                   * it.
                    */
 
-                  break;
+                  return conn;
                 }
             }
           else
             {
               /* This UDP socket is not connected.  We need to match only
                * the destination address with the bound socket address.
-               * Break out out of the loop and return this reference to
-               * the matching connection structure.
+               * Return this reference to the matching connection
+               * structure.
                */
 
-              break;
+              return conn;
             }
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -338,11 +369,25 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
                 FAR struct udp_hdr_s *udp)
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  FAR hash_node_t *p;
+
+  /* Only connections bound to the destination port can match, they are
+   * all in the same bucket of the port hashtable.
+   */
 
-  conn = udp_nextconn(conn);
+  if (conn == NULL)
+    {
+      p = udp_port_bucket(udp->destport)->head;
+    }
+  else
+    {
+      p = conn->hnode.flink;
+    }
 
-  while (conn != NULL)
+  for (; p != NULL; p = p->flink)
     {
+      conn = container_of(p, struct udp_conn_s, hnode);
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -432,31 +477,27 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
                    net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
                 {
-                  /* Matching connection found.. Break out of the loop and
-                   * return this reference to it.
+                  /* Matching connection found.. return this reference to
+                   * it.
                    */
 
-                  break;
+                  return conn;
                 }
             }
           else
             {
               /* This UDP socket is not connected.  We need to match only
                * the destination address with the bound socket address.
-               * Break out out of the loop and return this reference to
-               * the matching connection structure.
+               * Return this reference to the matching connection
+               * structure.
                */
 
-              break;
+              return conn;
             }
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -582,6 +623,42 @@ errout:
   return portno;
 }
 
+/****************************************************************************
+ * Name: udp_set_lport
+ *
+ * Description:
+ *   Bind a UDP connection to a local port, or unbind it if portno is zero.
+ *   The local port must only be changed through this function, so that the
+ *   port hashtable stays consistent.
+ *
+ * Input Parameters:
+ *   conn   - A reference to UDP connection structure.
+ *   portno - The local port in network byte order.
+ *
+ ****************************************************************************/
+
+void udp_set_lport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  net_lock();
+
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->hnode, udp_port_bucket(conn->lport));
+    }
+
+  /* Keep the bucket in binding order, the first bound connection wins if
+   * several of them match an incoming datagram.
+   */
+
+  if (portno != 0)
+    {
+      dq_addlast(&conn->hnode, udp_port_bucket(portno));
+    }
+
+  conn->lport = portno;
+  net_unlock();
+}
+
 /****************************************************************************
  * Name: udp_initialize
  *
@@ -651,6 +728,8 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       nxsem_init(&conn->sndsem, 0, 0);
 #endif
 
+      nxmutex_init(&conn->rdlock);
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Initialize the write buffer lists */
 
@@ -684,8 +763,9 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+  udp_set_lport(conn, 0);
+
   nxmutex_lock(&g_free_lock);
-  conn->lport = 0;
 
   /* Remove the connection from the active list */
 
@@ -694,6 +774,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
   iob_free_chain(conn->readahead);
+  nxmutex_destroy(&conn->rdlock);
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -928,7 +1009,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_set_lport(conn, portno);
           ret         = OK;
         }
     }
@@ -953,7 +1034,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_set_lport(conn, portno);
           ret         = OK;
         }
       else
@@ -997,6 +1078,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
 int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 {
+  uint16_t portno;
+
   /* Has this address already been bound to a local port (lport)? */
 
   if (!conn->lport)
@@ -1005,12 +1088,14 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
-      if (!conn->lport)
+      portno = HTONS(udp_select_port(conn->domain, &conn->u));
+      if (!portno)
         {
           nerr("ERROR: Failed to get a local port!\n");
           return -EADDRINUSE;
         }
+
+      udp_set_lport(conn, portno);
     }
 
   /* Is there a remote port (rport)? */
@@ -55,6 +55,7 @@
 #include <nuttx/net/netstats.h>
 
 #include "devif/devif.h"
+#include "netdev/netdev.h"
 #include "utils/utils.h"
 #include "udp/udp.h"
 #include "icmp/icmp.h"
@@ -246,7 +247,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
   chksum = udp->udpchksum;
-  if (chksum != 0)
+  if (chksum != 0 && !netdev_rxcsum_valid(dev))
     {
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -71,6 +71,7 @@ int udp_readahead_notifier_setup(worker_t worker,
                                  FAR void *arg)
 {
   struct work_notifier_s info;
+  bool buffered;
 
   DEBUGASSERT(worker != NULL);
 
@@ -78,7 +79,11 @@ int udp_readahead_notifier_setup(worker_t worker,
    * setting up the notification.
    */
 
-  if (conn->readahead != NULL)
+  nxmutex_lock(&conn->rdlock);
+  buffered = conn->readahead != NULL;
+  nxmutex_unlock(&conn->rdlock);
+
+  if (buffered)
     {
       return 0;
     }
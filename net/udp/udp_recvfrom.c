@@ -169,111 +169,219 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
   return recvlen;
 }
 
+/****************************************************************************
+ * Name: udp_readahead_split
+ *
+ * Description:
+ *   Split a read-ahead I/O buffer chain after its first 'len' bytes, so
+ *   that a datagram can be detached from the read-ahead queue.  If the
+ *   split falls inside a buffer, the rest of that buffer is moved to a new
+ *   one.
+ *
+ * Input Parameters:
+ *   iob  - The read-ahead I/O buffer chain
+ *   len  - The length of the first datagram, including its meta info
+ *   rest - The location to return the remainder of the chain, NULL if
+ *          there is none
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOMEM if no buffer was free.
+ *
+ ****************************************************************************/
+
+static int udp_readahead_split(FAR struct iob_s *iob, unsigned int len,
+                               FAR struct iob_s **rest)
+{
+  FAR struct iob_s *head = iob;
+  FAR struct iob_s *prev = NULL;
+  unsigned int offset = len;
+
+  if (len >= iob->io_pktlen)
+    {
+      *rest = NULL;
+      return OK;
+    }
+
+  while (offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      prev    = iob;
+      iob     = iob->io_flink;
+    }
+
+  if (offset == 0)
+    {
+      /* The datagram ends on a buffer boundary */
+
+      DEBUGASSERT(prev != NULL);
+      prev->io_flink = NULL;
+      *rest = iob;
+    }
+  else
+    {
+      *rest = iob_tryalloc(false);
+      if (*rest == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      if (IOB_FREESPACE(*rest) < iob->io_len - offset)
+        {
+          iob_free(*rest);
+          return -ENOMEM;
+        }
+
+      memcpy(IOB_DATA(*rest), IOB_DATA(iob) + offset,
+             iob->io_len - offset);
+      (*rest)->io_len   = iob->io_len - offset;
+      (*rest)->io_flink = iob->io_flink;
+      iob->io_len       = offset;
+      iob->io_flink     = NULL;
+    }
+
+  (*rest)->io_pktlen = head->io_pktlen - len;
+  head->io_pktlen    = len;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: udp_readahead
+ *
+ * Description:
+ *   Copy out the first datagram buffered in the read-ahead queue, if any.
+ *   The datagram is detached from the queue holding the read-ahead lock,
+ *   and copied to the user buffer after the lock is released, so that the
+ *   network input path never waits for the copy.  A datagram is only
+ *   copied holding the lock with MSG_PEEK, or if it could not be detached.
+ *
+ ****************************************************************************/
+
 static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 {
   FAR struct udp_conn_s *conn = pstate->ir_conn;
   FAR struct iob_s *iob;
+  FAR struct iob_s *rest;
+  bool detached = false;
+  int recvlen;
+  int offset = 0;
+  uint16_t datalen;
+  uint8_t src_addr_size;
+  uint8_t ifindex;
+#ifdef CONFIG_NET_TIMESTAMP
+  struct timespec timestamp;
+#endif
+#ifdef CONFIG_NET_IPv6
+  uint8_t srcaddr[sizeof(struct sockaddr_in6)];
+#else
+  uint8_t srcaddr[sizeof(struct sockaddr_in)];
+#endif
 
   /* Check there is any UDP datagram already buffered in a read-ahead
-   * buffer.
+   * buffer.  The read-ahead queue is protected by the read-ahead lock,
+   * the network may or may not be locked.
    */
 
   pstate->ir_recvlen = -1;
 
-  if ((iob = conn->readahead) != NULL)
+  nxmutex_lock(&conn->rdlock);
+  if ((iob = conn->readahead) == NULL)
     {
-      int recvlen;
-      int offset = 0;
-      uint16_t datalen;
-      uint8_t src_addr_size;
-      uint8_t ifindex;
-#ifdef CONFIG_NET_IPv6
-      uint8_t srcaddr[sizeof(struct sockaddr_in6)];
-#else
-      uint8_t srcaddr[sizeof(struct sockaddr_in)];
-#endif
+      nxmutex_unlock(&conn->rdlock);
+      return;
+    }
 
-      /* Unflatten saved connection information
-       * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
-       */
+  /* Unflatten saved connection information
+   * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
+   */
 
-      recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
-                            sizeof(datalen), offset);
-      offset += sizeof(datalen);
-      DEBUGASSERT(recvlen == sizeof(datalen));
+  recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
+                        sizeof(datalen), offset);
+  offset += sizeof(datalen);
+  DEBUGASSERT(recvlen == sizeof(datalen));
 
 #ifdef CONFIG_NETDEV_IFINDEX
-      recvlen = iob_copyout(&ifindex, iob, sizeof(ifindex), offset);
-      offset += sizeof(ifindex);
-      DEBUGASSERT(recvlen == sizeof(ifindex));
+  recvlen = iob_copyout(&ifindex, iob, sizeof(ifindex), offset);
+  offset += sizeof(ifindex);
+  DEBUGASSERT(recvlen == sizeof(ifindex));
 #else
-      ifindex = 1;
+  ifindex = 1;
 #endif
-      recvlen = iob_copyout(&src_addr_size, iob,
-                            sizeof(src_addr_size), offset);
-      offset += sizeof(src_addr_size);
-      DEBUGASSERT(recvlen == sizeof(src_addr_size));
+  recvlen = iob_copyout(&src_addr_size, iob,
+                        sizeof(src_addr_size), offset);
+  offset += sizeof(src_addr_size);
+  DEBUGASSERT(recvlen == sizeof(src_addr_size));
 
-      recvlen = iob_copyout(srcaddr, iob, src_addr_size, offset);
-      offset += src_addr_size;
-      DEBUGASSERT(recvlen == src_addr_size);
+  recvlen = iob_copyout(srcaddr, iob, src_addr_size, offset);
+  offset += src_addr_size;
+  DEBUGASSERT(recvlen == src_addr_size);
 
 #ifdef CONFIG_NET_TIMESTAMP
-      /* Unpack stored timestamp if SO_TIMESTAMP socket option is enabled */
-
-      if (conn->timestamp)
-        {
-          struct timespec timestamp;
-          recvlen = iob_copyout((FAR uint8_t *)&timestamp, iob,
-                                sizeof(struct timespec), offset);
-          DEBUGASSERT(recvlen == sizeof(struct timespec));
+  /* The timestamp is stored unconditionally */
 
-          udp_store_cmsg_timestamp(pstate, &timestamp);
-        }
-
-      offset += sizeof(struct timespec);
+  recvlen = iob_copyout((FAR uint8_t *)&timestamp, iob,
+                        sizeof(struct timespec), offset);
+  offset += sizeof(struct timespec);
+  DEBUGASSERT(recvlen == sizeof(struct timespec));
 #endif
 
-      /* Copy to user */
-
-      recvlen = iob_copyout(pstate->ir_msg->msg_iov->iov_base, iob,
-                            MIN(pstate->ir_msg->msg_iov->iov_len, datalen),
-                            offset);
+  /* Detach the datagram from the head of the I/O buffer chain */
 
-      /* Update the accumulated size of the data read */
+  if (!(pstate->ir_flags & MSG_PEEK) &&
+      udp_readahead_split(iob, offset + datalen, &rest) >= 0)
+    {
+      conn->readahead = rest;
+      detached        = true;
+      nxmutex_unlock(&conn->rdlock);
+    }
 
-      pstate->ir_recvlen = recvlen;
+  /* Copy to user */
 
-      ninfo("Received %d bytes (of %d, total %d)\n",
-            recvlen, datalen, iob->io_pktlen);
+  recvlen = iob_copyout(pstate->ir_msg->msg_iov->iov_base, iob,
+                        MIN(pstate->ir_msg->msg_iov->iov_len, datalen),
+                        offset);
 
-      if (pstate->ir_msg->msg_name)
+  if (detached)
+    {
+      iob_free_chain(iob);
+    }
+  else
+    {
+      if (!(pstate->ir_flags & MSG_PEEK))
         {
-          pstate->ir_msg->msg_namelen =
-                src_addr_size > pstate->ir_msg->msg_namelen ?
-                pstate->ir_msg->msg_namelen : src_addr_size;
+          /* Not detached for lack of a buffer, trim it in place */
 
-          memcpy(pstate->ir_msg->msg_name, srcaddr,
-                 pstate->ir_msg->msg_namelen);
+          conn->readahead = iob_trimhead(iob, offset + datalen);
         }
 
-      udp_recvpktinfo(pstate, srcaddr, ifindex);
+      nxmutex_unlock(&conn->rdlock);
+    }
 
-      /* Remove the packet from the head of the I/O buffer chain. */
+  /* Update the accumulated size of the data read */
 
-      if (!(pstate->ir_flags & MSG_PEEK))
-        {
-          if (offset + datalen >= iob->io_pktlen)
-            {
-              iob_free_chain(iob);
-              conn->readahead = NULL;
-            }
-          else
-            {
-              conn->readahead = iob_trimhead(iob, offset + datalen);
-            }
-        }
+  pstate->ir_recvlen = recvlen;
+
+  ninfo("Received %d bytes (of %d)\n", recvlen, datalen);
+
+#ifdef CONFIG_NET_TIMESTAMP
+  /* Unpack stored timestamp if SO_TIMESTAMP socket option is enabled */
+
+  if (conn->timestamp)
+    {
+      udp_store_cmsg_timestamp(pstate, &timestamp);
+    }
+#endif
+
+  if (pstate->ir_msg->msg_name)
+    {
+      pstate->ir_msg->msg_namelen =
+            src_addr_size > pstate->ir_msg->msg_namelen ?
+            pstate->ir_msg->msg_namelen : src_addr_size;
+
+      memcpy(pstate->ir_msg->msg_name, srcaddr,
+             pstate->ir_msg->msg_namelen);
     }
+
+  udp_recvpktinfo(pstate, srcaddr, ifindex);
 }
 
 /****************************************************************************
@@ -685,12 +793,29 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Perform the UDP recvfrom() operation */
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
+  udp_recvfrom_initialize(conn, msg, &state, flags);
+
+  /* If a datagram is already buffered, detach it from the read-ahead
+   * queue and copy it out without the network lock.
+   */
+
+  udp_readahead(&state);
+  if (state.ir_recvlen >= 0)
+    {
+#ifdef CONFIG_NETDEV_RSS
+      net_lock();
+      udp_notify_recvcpu(conn);
+      net_unlock();
+#endif
+      udp_recvfrom_uninitialize(&state);
+      return state.ir_recvlen;
+    }
+
+  /* Otherwise lock the network, nothing can be added to the read-ahead
+   * buffer until we are ready to wait for new data.
    */
 
   net_lock();
-  udp_recvfrom_initialize(conn, msg, &state, flags);
 
   /* Copy the read-ahead data from the packet */
 
@@ -46,6 +46,7 @@
 #include <nuttx/config.h>
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
+#include <stddef.h>
 #include <string.h>
 #include <debug.h>
 #include <assert.h>
@@ -59,6 +60,7 @@
 #include <nuttx/net/udp.h>
 
 #include "devif/devif.h"
+#include "netdev/netdev.h"
 #include "inet/inet.h"
 #include "socket/socket.h"
 #include "utils/utils.h"
@@ -255,7 +257,11 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       if (IFF_IS_IPv4(dev->d_flags))
 #endif
         {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
+          if (!netdev_txcsum_offload(dev, IP_PROTO_UDP, IPv4_HDRLEN,
+                                     offsetof(struct udp_hdr_s, udpchksum)))
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -264,7 +270,11 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       else
 #endif
         {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
+          if (!netdev_txcsum_offload(dev, IP_PROTO_UDP, IPv6_HDRLEN,
+                                     offsetof(struct udp_hdr_s, udpchksum)))
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
         }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -258,12 +258,14 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
-      if (!conn->lport)
+      uint16_t portno = HTONS(udp_select_port(conn->domain, &conn->u));
+      if (!portno)
         {
           nerr("ERROR: Failed to get a local port!\n");
           return -EADDRINUSE;
         }
+
+      udp_set_lport(conn, portno);
     }
 
   /* Get the device that will handle the remote packet transfers.  This
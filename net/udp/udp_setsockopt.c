@@ -76,7 +76,43 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-  return -ENOPROTOOPT;
+  FAR struct udp_conn_s *conn;
+  int ret = OK;
+
+  DEBUGASSERT(psock != NULL && value != NULL && psock->s_conn != NULL);
+  conn = psock->s_conn;
+
+  switch (option)
+    {
+      case UDP_SEGMENT: /* Split sends in datagrams of this size */
+        if (value_len != sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            int gso_size = *(FAR int *)value;
+
+            if (gso_size < 0 || gso_size > UINT16_MAX)
+              {
+                nerr("ERROR: UDP_SEGMENT value out of range: %d\n",
+                     gso_size);
+                ret = -EINVAL;
+              }
+            else
+              {
+                conn->gso_size = gso_size;
+              }
+          }
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized UDP option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  return ret;
 }
 
 #endif /* CONFIG_NET_UDPPROTO_OPTIONS */
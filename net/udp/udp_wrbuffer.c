@@ -34,6 +34,7 @@
 #  define CONFIG_DEBUG_NET 1
 #endif
 
+#include <sys/param.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -268,12 +269,20 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_tryalloc(void)
 
   /* Now get the first I/O buffer for the write buffer structure */
 
-  wrb->wb_iob =
 #ifdef CONFIG_NET_JUMBO_FRAME
-    iob_alloc_dynamic(len);
+#  ifdef CONFIG_IOB_CLASSES
+  /* Prefer a pool buffer that holds the whole datagram to the heap */
+
+  wrb->wb_iob = iob_tryalloc_size(MAX(len, CONFIG_IOB_BUFSIZE), false);
+  if (!wrb->wb_iob)
+#  endif
+    {
+      wrb->wb_iob = iob_alloc_dynamic(len);
+    }
 #else
-    iob_tryalloc(false);
+  wrb->wb_iob = iob_tryalloc(false);
 #endif
+
   if (!wrb->wb_iob)
     {
       nerr("ERROR: Failed to allocate I/O buffer\n");
@@ -27,87 +27,171 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/endian.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The value of a byte in the first or the second byte of a 16-bit word
+ * loaded in host byte order.
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_LANE0(b)  ((uint16_t)(b) << 8)
+#  define CHKSUM_LANE1(b)  ((uint16_t)(b))
+#else
+#  define CHKSUM_LANE0(b)  ((uint16_t)(b))
+#  define CHKSUM_LANE1(b)  ((uint16_t)(b) << 8)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: checksum
+ * Name: chksum_add
  *
  * Description:
- *   Calculate the raw change sum over the memory region described by
- *   data and len.
+ *   Add two 16-bit values in one's complement arithmetic.
+ *
+ ****************************************************************************/
+
+static inline uint16_t chksum_add(uint16_t sum, uint16_t val)
+{
+  sum += val;
+  if (sum < val)
+    {
+      sum++; /* carry */
+    }
+
+  return sum;
+}
+
+/****************************************************************************
+ * Name: chksum_load16 and chksum_load32
+ *
+ * Description:
+ *   Load a word in host byte order.  memcpy() keeps the access free of
+ *   alignment and aliasing assumptions, the compiler turns it into a
+ *   single load where it can.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static inline uint16_t chksum_load16(FAR const uint8_t *data)
+{
+  uint16_t val;
+
+  memcpy(&val, data, sizeof(val));
+  return val;
+}
+
+static inline uint32_t chksum_load32(FAR const uint8_t *data)
+{
+  uint32_t val;
+
+  memcpy(&val, data, sizeof(val));
+  return val;
+}
+#endif
+
+/****************************************************************************
+ * Name: chksum_partial
+ *
+ * Description:
+ *   Calculate the one's complement sum of the 16-bit words of a memory
+ *   region, taking data[0] as the first byte of a word.  The words are
+ *   loaded in host byte order and added 32 bits at a time into a 64-bit
+ *   accumulator, so no carry needs to be handled until the final fold.
+ *   The one's complement sum does not depend on the byte order (RFC1071),
+ *   the result is simply the wanted sum in host byte order.
  *
  * Input Parameters:
- *   sum  - Partial calculations carried over from a previous call to
- *          chksum().  This should be zero on the first time that check
- *          sum is called.
  *   data - Beginning of the data to include in the checksum.
  *   len  - Length of the data to include in the checksum.
- *   odd  - the flag of the Calculated data sum
  *
  * Returned Value:
- *   The updated checksum value.
+ *   The sum, to be converted with NTOHS().
  *
  ****************************************************************************/
 
 #ifndef CONFIG_NET_ARCH_CHKSUM
-uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
-                    uint16_t len, bool *odd)
+static uint16_t chksum_partial(FAR const uint8_t *data, size_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
-
-  dataptr = data;
-  last_byte = data + len - 1;
+  uint64_t acc = 0;
+  bool swap = false;
 
-  if (*odd == true)
+  if (len == 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 1;
+      return 0;
     }
 
-  while (dataptr < last_byte)
+  /* Align the data to 16 bits.  The first byte then sits in the second
+   * byte of a word, which swaps the two bytes of the whole sum.
+   */
+
+  if (((uintptr_t)data & 1) != 0)
     {
-      /* At least two more bytes */
+      acc  = CHKSUM_LANE1(data[0]);
+      swap = true;
+      data++;
+      len--;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* And to 32 bits */
 
-      dataptr += 2;
+  if (((uintptr_t)data & 2) != 0 && len >= 2)
+    {
+      acc  += chksum_load16(data);
+      data += 2;
+      len  -= 2;
     }
 
-  *odd = false;
+  while (len >= 16)
+    {
+      acc  += chksum_load32(data);
+      acc  += chksum_load32(data + 4);
+      acc  += chksum_load32(data + 8);
+      acc  += chksum_load32(data + 12);
+      data += 16;
+      len  -= 16;
+    }
 
-  if (dataptr == last_byte)
+  while (len >= 4)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      acc  += chksum_load32(data);
+      data += 4;
+      len  -= 4;
+    }
 
-      *odd = true;
+  if (len >= 2)
+    {
+      acc  += chksum_load16(data);
+      data += 2;
+      len  -= 2;
     }
 
-  /* Return sum in host byte order. */
+  if (len > 0)
+    {
+      acc += CHKSUM_LANE0(data[0]);
+    }
 
-  return sum;
+  /* Fold the end-around carries back into 16 bits */
+
+  while ((acc >> 16) != 0)
+    {
+      acc = (acc & 0xffff) + (acc >> 16);
+    }
+
+  return swap ? __swap_uint16((uint16_t)acc) : (uint16_t)acc;
 }
+#endif /* CONFIG_NET_ARCH_CHKSUM */
 
 /****************************************************************************
  * Public Functions
@@ -132,13 +216,11 @@ uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  bool odd = false;
-
-  return checksum(sum, data, len, &odd);
+  return chksum_add(sum, NTOHS(chksum_partial(data, len)));
 }
-
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
 /****************************************************************************
@@ -162,10 +244,12 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 #ifdef CONFIG_MM_IOB
 uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 {
-  /* Skip to the I/O buffer containing the data offset */
-
+  FAR const uint8_t *data;
+  uint16_t len;
   bool odd = false;
 
+  /* Skip to the I/O buffer containing the data offset */
+
   while (iob != NULL && offset > iob->io_len)
     {
       offset -= iob->io_len;
@@ -173,14 +257,27 @@ uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
     }
 
   /* If the link pointer is not empty, loop to walk through all I/O buffer
-   * and accumulate the sum
+   * and accumulate the sum.  A buffer that starts at an odd position of
+   * the stream is summed on its own and its bytes swapped, rather than
+   * being walked byte by byte.
    */
 
   while (iob != NULL)
     {
-      sum = checksum(sum, iob->io_data + iob->io_offset + offset,
-                      iob->io_len - offset, &odd);
-      iob = iob->io_flink;
+      data = iob->io_data + iob->io_offset + offset;
+      len  = iob->io_len - offset;
+
+      if (odd)
+        {
+          sum = chksum_add(sum, __swap_uint16(chksum(0, data, len)));
+        }
+      else
+        {
+          sum = chksum(sum, data, len);
+        }
+
+      odd   ^= (len & 1) != 0;
+      iob    = iob->io_flink;
       offset = 0;
     }
 
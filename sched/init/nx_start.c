@@ -344,7 +344,9 @@ static void tasklist_initialize(void)
 static void idle_task_initialize(void)
 {
   FAR struct tcb_s *tcb;
+#ifdef CONFIG_SMP
   FAR dq_queue_t *tasklist;
+#endif
   int i;
 
   memset(g_idletcb, 0, sizeof(g_idletcb));
@@ -421,10 +423,10 @@ static void idle_task_initialize(void)
 
 #ifdef CONFIG_SMP
       tasklist = TLIST_HEAD(tcb, i);
+      dq_addfirst((FAR dq_entry_t *)tcb, tasklist);
 #else
-      tasklist = TLIST_HEAD(tcb);
+      nxsched_priobitmap_add(tcb);
 #endif
-      dq_addfirst((FAR dq_entry_t *)tcb, tasklist);
 
       /* Mark the idle task as the running task */
 
@@ -324,6 +324,21 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 
+/* Constant time g_readytorun insertion/removal */
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+bool nxsched_priobitmap_add(FAR struct tcb_s *tcb);
+void nxsched_priobitmap_remove(FAR struct tcb_s *tcb);
+void nxsched_priobitmap_reprio(FAR struct tcb_s *tcb, int priority);
+#else
+#  define nxsched_priobitmap_add(tcb) \
+     nxsched_add_prioritized(tcb, list_readytorun())
+#  define nxsched_priobitmap_remove(tcb) \
+     dq_rem((FAR dq_entry_t *)(tcb), list_readytorun())
+#  define nxsched_priobitmap_reprio(tcb,priority) \
+     ((tcb)->sched_priority = (uint8_t)(priority))
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -33,6 +33,63 @@
 #include "sched/queue.h"
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  nxsched_add_notrunning
+ *
+ * Description:
+ *   Add a TCB that is ready-to-run, but that will not run now, to the
+ *   appropriate ready-to-run list.  A thread whose affinity mask permits
+ *   exactly one CPU can never be picked up by any other CPU, so it is kept
+ *   in the g_assignedtasks[] list of that CPU in the TSTATE_TASK_ASSIGNED
+ *   state.  This keeps CPU-bound threads out of the shared g_readytorun
+ *   list, which then holds only threads that may migrate, and spares every
+ *   other CPU from skipping over them when it selects its next task.
+ *   Threads that may run on more than one CPU go to g_readytorun as
+ *   before; an idle CPU pulls work from there (and from the assigned lists
+ *   of other CPUs) in nxsched_remove_running().
+ *
+ * Input Parameters:
+ *   btcb - Points to the TCB that is ready-to-run
+ *   cpu  - The CPU selected by nxsched_select_cpu() for btcb
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static inline_function void nxsched_add_notrunning(FAR struct tcb_s *btcb,
+                                                   int cpu)
+{
+  if ((btcb->affinity & (btcb->affinity - 1)) == 0 &&
+      btcb->sched_priority <= current_task(cpu)->sched_priority)
+    {
+      /* The thread is bound to a single CPU.  The running task at the head
+       * of the list has an equal or higher priority and the IDLE task at
+       * the tail has the lowest, so btcb always lands in the middle.
+       */
+
+      DEBUGASSERT(CPU_ISSET(cpu, &btcb->affinity));
+
+      nxsched_add_prioritized(btcb, &g_assignedtasks[cpu]);
+      btcb->cpu        = cpu;
+      btcb->task_state = TSTATE_TASK_ASSIGNED;
+    }
+  else
+    {
+      nxsched_add_prioritized(btcb, &g_readytorun);
+      btcb->task_state = TSTATE_TASK_READYTORUN;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -90,7 +147,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
   /* Otherwise, add the new task to the ready-to-run task list */
 
-  else if (nxsched_add_prioritized(btcb, list_readytorun()))
+  else if (nxsched_priobitmap_add(btcb))
     {
       /* The new btcb was added at the head of the ready-to-run list.  It
        * is now the new active task!
@@ -124,8 +181,8 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
  *
  *   1. The g_readytorun list if the task is ready-to-run but not running
  *      and not assigned to a CPU.
- *   2. The g_assignedtask[cpu] list if the task is running or if has been
- *      assigned to a CPU.
+ *   2. The g_assignedtask[cpu] list if the task is running, if has been
+ *      assigned to a CPU, or if its affinity mask permits only that CPU.
  *
  *   If the currently active task has preemption disabled and the new TCB
  *   would cause this task to be pre-empted, the new task is added to the
@@ -215,10 +272,8 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * Add the task to the ready-to-run (but not running) task list
        */
 
-      nxsched_add_prioritized(btcb, list_readytorun());
-
-      btcb->task_state = TSTATE_TASK_READYTORUN;
-      doswitch         = false;
+      nxsched_add_notrunning(btcb, cpu);
+      doswitch = false;
     }
   else /* (task_state == TSTATE_TASK_RUNNING) */
     {
@@ -244,13 +299,11 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
                   g_delivertasks[cpu] = btcb;
                   btcb->cpu = cpu;
                   btcb->task_state = TSTATE_TASK_ASSIGNED;
-                  nxsched_add_prioritized(rtcb, &g_readytorun);
-                  rtcb->task_state = TSTATE_TASK_READYTORUN;
+                  nxsched_add_notrunning(rtcb, cpu);
                 }
               else
                 {
-                  nxsched_add_prioritized(btcb, &g_readytorun);
-                  btcb->task_state = TSTATE_TASK_READYTORUN;
+                  nxsched_add_notrunning(btcb, cpu);
                 }
             }
 
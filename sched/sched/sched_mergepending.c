@@ -71,7 +71,51 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && defined(CONFIG_SCHED_PRIORITY_BITMAP)
+bool nxsched_merge_pending(void)
+{
+  FAR struct tcb_s *ptcb;
+  FAR struct tcb_s *pnext;
+  bool ret = false;
+
+  /* Do nothing if pre-emption is still disabled */
+
+  if (this_task()->lockcount == 0)
+    {
+      /* Each insertion is constant time, so simply move every TCB in the
+       * g_pendingtasks list into the ready-to-run list.
+       */
+
+      for (ptcb = (FAR struct tcb_s *)list_pendingtasks()->head;
+           ptcb;
+           ptcb = pnext)
+        {
+          pnext = ptcb->flink;
+
+          if (nxsched_priobitmap_add(ptcb))
+            {
+              /* ptcb was inserted at the head of the list */
+
+              ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+              ptcb->task_state        = TSTATE_TASK_RUNNING;
+              up_update_task(ptcb);
+              ret                     = true;
+            }
+          else
+            {
+              ptcb->task_state        = TSTATE_TASK_READYTORUN;
+            }
+        }
+
+      /* Mark the input list empty */
+
+      list_pendingtasks()->head = NULL;
+      list_pendingtasks()->tail = NULL;
+    }
+
+  return ret;
+}
+#elif !defined(CONFIG_SMP)
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -0,0 +1,261 @@
+/****************************************************************************
+ * sched/sched/sched_priobitmap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PRIOBITMAP_NWORDS   ((SCHED_PRIORITY_MAX + 32) >> 5)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* g_rtrlast[prio] points to the last TCB of priority 'prio' in the
+ * g_readytorun list, or is NULL if there is no such TCB.  Bit 'prio' of
+ * g_rtrbitmap is set if and only if g_rtrlast[prio] is not NULL.
+ */
+
+static FAR struct tcb_s *g_rtrlast[SCHED_PRIORITY_MAX + 1];
+static uint32_t g_rtrbitmap[PRIOBITMAP_NWORDS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_priobitmap_set/clear
+ *
+ * Description:
+ *   Make the TCB the last entry of its priority level or remove the
+ *   priority level from the index.
+ *
+ ****************************************************************************/
+
+static inline void nxsched_priobitmap_set(uint8_t prio,
+                                          FAR struct tcb_s *tcb)
+{
+  g_rtrlast[prio] = tcb;
+  g_rtrbitmap[prio >> 5] |= (uint32_t)1 << (prio & 31);
+}
+
+static inline void nxsched_priobitmap_clear(uint8_t prio)
+{
+  g_rtrlast[prio] = NULL;
+  g_rtrbitmap[prio >> 5] &= ~((uint32_t)1 << (prio & 31));
+}
+
+/****************************************************************************
+ * Name: nxsched_priobitmap_above
+ *
+ * Description:
+ *   Return the lowest priority level strictly above 'prio' that holds at
+ *   least one ready-to-run task, or -1 if there is none.  This visits at
+ *   most PRIOBITMAP_NWORDS words.
+ *
+ ****************************************************************************/
+
+static inline int nxsched_priobitmap_above(uint8_t prio)
+{
+  unsigned int next = (unsigned int)prio + 1;
+  unsigned int i    = next >> 5;
+  uint32_t word;
+
+  if (i >= PRIOBITMAP_NWORDS)
+    {
+      return -1;
+    }
+
+  word = g_rtrbitmap[i] & ~(((uint32_t)1 << (next & 31)) - 1);
+  while (word == 0)
+    {
+      if (++i >= PRIOBITMAP_NWORDS)
+        {
+          return -1;
+        }
+
+      word = g_rtrbitmap[i];
+    }
+
+  return (int)(i << 5) + ffs(word) - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_priobitmap_add
+ *
+ * Description:
+ *   Insert a TCB into the g_readytorun list in constant time.  The TCB is
+ *   placed after every task of equal or higher priority, exactly where
+ *   nxsched_add_prioritized() would place it.
+ *
+ * Input Parameters:
+ *   tcb - The TCB to be inserted.
+ *
+ * Returned Value:
+ *   true if the TCB was added at the head of the list.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+bool nxsched_priobitmap_add(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = list_readytorun();
+  uint8_t prio = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+  int above;
+
+  DEBUGASSERT(prio >= SCHED_PRIORITY_MIN || is_idle_task(tcb));
+
+  /* Go behind the last task of the same priority or, if there is none,
+   * behind the last task of the nearest higher priority level.
+   */
+
+  prev = g_rtrlast[prio];
+  if (prev == NULL)
+    {
+      above = nxsched_priobitmap_above(prio);
+      if (above >= 0)
+        {
+          prev = g_rtrlast[above];
+        }
+    }
+
+  nxsched_priobitmap_set(prio, tcb);
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      return true;
+    }
+
+  dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsched_priobitmap_remove
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list in constant time.
+ *
+ * Input Parameters:
+ *   tcb - The TCB to be removed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_priobitmap_remove(FAR struct tcb_s *tcb)
+{
+  uint8_t prio = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (g_rtrlast[prio] == tcb)
+    {
+      prev = tcb->blink;
+      if (prev != NULL && prev->sched_priority == prio)
+        {
+          g_rtrlast[prio] = prev;
+        }
+      else
+        {
+          nxsched_priobitmap_clear(prio);
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, list_readytorun());
+}
+
+/****************************************************************************
+ * Name: nxsched_priobitmap_reprio
+ *
+ * Description:
+ *   Change the priority of the task at the head of the g_readytorun list
+ *   without moving it.  The caller guarantees that the list stays ordered,
+ *   i.e. the new priority is still greater than or equal to that of the
+ *   next task.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB at the head of g_readytorun.
+ *   priority - The new priority.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_priobitmap_reprio(FAR struct tcb_s *tcb, int priority)
+{
+  DEBUGASSERT(tcb == (FAR struct tcb_s *)list_readytorun()->head);
+
+  /* The head is the first task of its level.  If it is also the last one,
+   * it is the only one.
+   */
+
+  if (g_rtrlast[tcb->sched_priority] == tcb)
+    {
+      nxsched_priobitmap_clear(tcb->sched_priority);
+    }
+
+  tcb->sched_priority = (uint8_t)priority;
+
+  /* If other tasks share the new level they follow the head, and the last
+   * of them remains the last entry.
+   */
+
+  if (g_rtrlast[priority] == NULL)
+    {
+      nxsched_priobitmap_set(priority, tcb);
+    }
+}
+
+#endif /* CONFIG_SCHED_PRIORITY_BITMAP */
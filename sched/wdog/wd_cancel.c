@@ -91,6 +91,10 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
 int wd_cancel_irq(FAR struct wdog_s *wdog)
 {
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+  clock_t before = 0;
+  clock_t after = 0;
+#endif
   bool head;
 
   /* Make sure that the watchdog is valid and still active. */
@@ -107,11 +111,21 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
    * cancellation is complete
    */
 
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+  /* The wheel only reports the tick of its next event; reassess the timer
+   * if removing the watchdog moves that tick.
+   */
+
+  wd_wheel_next(&before);
+  wd_wheel_delete(wdog);
+  head = !wd_wheel_next(&after) || before != after;
+#else
   head = list_is_head(&g_wdactivelist, &wdog->node);
 
   /* Now, remove the watchdog from the timer queue */
 
   list_delete(&wdog->node);
+#endif
 
   /* Mark the watchdog inactive */
 
@@ -129,6 +129,10 @@ static inline_function void wd_expiration(clock_t ticks)
    * other watchdogs that became ready to run at this time
    */
 
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+  while ((wdog = wd_wheel_expired(ticks)) != NULL)
+    {
+#else
   while (!list_is_empty(&g_wdactivelist))
     {
       wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
@@ -143,6 +147,7 @@ static inline_function void wd_expiration(clock_t ticks)
       /* Remove the watchdog from the head of the list */
 
       list_delete(&wdog->node);
+#endif
 
       /* Indicate that the watchdog is no longer active. */
 
@@ -189,6 +194,10 @@ static inline_function
 void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+  wdog->expired = expired;
+  wd_wheel_insert(wdog);
+#else
   FAR struct wdog_s *curr;
 
   /* Traverse the watchdog list */
@@ -211,11 +220,12 @@ void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
    */
 
   list_add_before(&curr->node, &wdog->node);
+  wdog->expired = expired;
+#endif
 
   wdog->func = wdentry;
   up_getpicbase(&wdog->picbase);
   wdog->arg = arg;
-  wdog->expired = expired;
 }
 
 /****************************************************************************
@@ -263,6 +273,10 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 {
   irqstate_t flags;
   bool reassess = false;
+#if defined(CONFIG_SCHED_TICKLESS) && defined(CONFIG_WDOG_TIMING_WHEEL)
+  clock_t before = 0;
+  clock_t after = 0;
+#endif
 
   /* Verify the wdog and setup parameters */
 
@@ -294,7 +308,29 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
    */
 
   flags = enter_critical_section();
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_SCHED_TICKLESS) && defined(CONFIG_WDOG_TIMING_WHEEL)
+  /* We need to reassess timer if the next wheel event has changed. */
+
+  reassess = !wd_wheel_next(&before);
+
+  if (WDOG_ISACTIVE(wdog))
+    {
+      wd_wheel_delete(wdog);
+      wdog->func = NULL;
+    }
+
+  wd_insert(wdog, ticks, wdentry, arg);
+
+  wd_wheel_next(&after);
+  if (!g_wdtimernested && (reassess || before != after))
+    {
+      /* Resume the interval timer that will generate the next
+       * interval event.
+       */
+
+      nxsched_reassess_timer();
+    }
+#elif defined(CONFIG_SCHED_TICKLESS)
   /* We need to reassess timer if the watchdog list head has changed. */
 
   if (WDOG_ISACTIVE(wdog))
@@ -323,7 +359,11 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   if (WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+      wd_wheel_delete(wdog);
+#else
       list_delete(&wdog->node);
+#endif
       wdog->func = NULL;
     }
 
@@ -414,7 +454,11 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 #ifdef CONFIG_SCHED_TICKLESS
 clock_t wd_timer(clock_t ticks, bool noswitches)
 {
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+  clock_t next;
+#else
   FAR struct wdog_s *wdog;
+#endif
   irqstate_t flags;
   sclock_t ret;
 
@@ -429,6 +473,15 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   /* Return the delay for the next watchdog to expire */
 
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+  if (!wd_wheel_next(&next))
+    {
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  ret = next - ticks;
+#else
   if (list_is_empty(&g_wdactivelist))
     {
       leave_critical_section(flags);
@@ -441,6 +494,7 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
   ret = wdog->expired - ticks;
+#endif
 
   leave_critical_section(flags);
 
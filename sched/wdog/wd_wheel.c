@@ -0,0 +1,448 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Level 'l' of the wheel has WHEEL_SLOTS slots, each covering
+ * 2^(l * WHEEL_BITS) ticks.  Watchdogs further away than WHEEL_RANGE ticks
+ * are kept in a sorted overflow list until they come into range.
+ */
+
+#define WHEEL_BITS         CONFIG_WDOG_WHEEL_BITS
+#define WHEEL_LEVELS       CONFIG_WDOG_WHEEL_LEVELS
+#define WHEEL_SLOTS        (1 << WHEEL_BITS)
+#define WHEEL_MASK         (WHEEL_SLOTS - 1)
+#define WHEEL_RANGE        ((clock_t)1 << (WHEEL_BITS * WHEEL_LEVELS))
+
+#define LEVEL_SHIFT(l)     ((l) * WHEEL_BITS)
+#define LEVEL_INDEX(t, l)  ((unsigned int)((t) >> LEVEL_SHIFT(l)) & WHEEL_MASK)
+
+#if WHEEL_BITS > 6
+#  error CONFIG_WDOG_WHEEL_BITS must not exceed 6
+#endif
+
+#if WHEEL_BITS * WHEEL_LEVELS >= 32
+#  error CONFIG_WDOG_WHEEL_BITS * CONFIG_WDOG_WHEEL_LEVELS must be below 32
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slot lists.  A slot list is only valid while its bit in g_wdbitmap
+ * is set; it is initialized when the first watchdog is added to it, so
+ * the wheel needs no run-time initialization.
+ */
+
+static struct list_node g_wdwheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t g_wdbitmap[WHEEL_LEVELS];
+
+/* Watchdogs that expire WHEEL_RANGE ticks or more after g_wdbase, sorted
+ * by expiration time.
+ */
+
+static struct list_node g_wdoverflow = LIST_INITIAL_VALUE(g_wdoverflow);
+
+/* The tick the wheel is positioned at.  All slots that belong to earlier
+ * ticks have been processed, and so have the cascades of g_wdbase itself.
+ */
+
+static clock_t g_wdbase;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_slot_add
+ ****************************************************************************/
+
+static void wd_wheel_slot_add(FAR struct wdog_s *wdog, unsigned int level,
+                              unsigned int index)
+{
+  FAR struct list_node *slot = &g_wdwheel[level][index];
+  uint64_t bit = (uint64_t)1 << index;
+
+  if ((g_wdbitmap[level] & bit) == 0)
+    {
+      list_initialize(slot);
+      g_wdbitmap[level] |= bit;
+    }
+
+  list_add_tail(slot, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_place
+ *
+ * Description:
+ *   Put a watchdog into the slot that matches its distance to g_wdbase.
+ *   Overdue watchdogs go to the current level 0 slot.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_place(FAR struct wdog_s *wdog)
+{
+  sclock_t delta = (sclock_t)(wdog->expired - g_wdbase);
+  FAR struct wdog_s *curr;
+  unsigned int level;
+
+  if (delta <= 0)
+    {
+      wd_wheel_slot_add(wdog, 0, LEVEL_INDEX(g_wdbase, 0));
+      return;
+    }
+
+  if ((clock_t)delta >= WHEEL_RANGE)
+    {
+      list_for_every_entry(&g_wdoverflow, curr, struct wdog_s, node)
+        {
+          if (!clock_compare(curr->expired, wdog->expired))
+            {
+              break;
+            }
+        }
+
+      list_add_before(&curr->node, &wdog->node);
+      return;
+    }
+
+  for (level = 0; level < WHEEL_LEVELS - 1; level++)
+    {
+      if ((clock_t)delta < ((clock_t)1 << LEVEL_SHIFT(level + 1)))
+        {
+          break;
+        }
+    }
+
+  wd_wheel_slot_add(wdog, level, LEVEL_INDEX(wdog->expired, level));
+}
+
+/****************************************************************************
+ * Name: wd_wheel_empty
+ ****************************************************************************/
+
+static bool wd_wheel_empty(void)
+{
+  unsigned int level;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      if (g_wdbitmap[level] != 0)
+        {
+          return false;
+        }
+    }
+
+  return list_is_empty(&g_wdoverflow);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_search
+ *
+ * Description:
+ *   Return the distance, in slots, from slot 'index' to the next non-empty
+ *   slot of a level (wrapping around), or -1 if the level is empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_search(unsigned int level, unsigned int index)
+{
+  uint64_t bitmap = g_wdbitmap[level];
+  uint64_t upper;
+
+  if (bitmap == 0)
+    {
+      return -1;
+    }
+
+  upper = bitmap & ~(((uint64_t)1 << index) - 1);
+  if (upper != 0)
+    {
+      return ffsll(upper) - 1 - index;
+    }
+
+  return ffsll(bitmap) - 1 + WHEEL_SLOTS - index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Called when g_wdbase moves to a new tick.  Re-distribute the higher
+ *   level slots that start at this tick and bring overflow watchdogs that
+ *   came into range into the wheel.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(void)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *tmp;
+  struct list_node list;
+  unsigned int level;
+  unsigned int index;
+
+  for (level = 1; level < WHEEL_LEVELS; level++)
+    {
+      if ((g_wdbase & (((clock_t)1 << LEVEL_SHIFT(level)) - 1)) != 0)
+        {
+          break;
+        }
+
+      index = LEVEL_INDEX(g_wdbase, level);
+      if ((g_wdbitmap[level] & ((uint64_t)1 << index)) != 0)
+        {
+          /* Detach the slot first, some entries may land in it again */
+
+          list            = g_wdwheel[level][index];
+          list.next->prev = &list;
+          list.prev->next = &list;
+          g_wdbitmap[level] &= ~((uint64_t)1 << index);
+
+          list_for_every_entry_safe(&list, wdog, tmp, struct wdog_s, node)
+            {
+              list_delete(&wdog->node);
+              wd_wheel_place(wdog);
+            }
+        }
+    }
+
+  while (!list_is_empty(&g_wdoverflow))
+    {
+      wdog = list_first_entry(&g_wdoverflow, struct wdog_s, node);
+      if ((clock_t)(wdog->expired - g_wdbase) >= WHEEL_RANGE)
+        {
+          break;
+        }
+
+      list_delete(&wdog->node);
+      wd_wheel_place(wdog);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add an inactive watchdog, whose 'expired' field has been set, to the
+ *   timing wheel.  O(1) unless the watchdog lies beyond the wheel range.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  /* g_wdbase only advances while the wheel is serviced, so it falls behind
+   * while the wheel is empty in tickless mode.  Move it to the current
+   * tick first, or the watchdog would be placed too far away or even
+   * appear overdue once the distance no longer fits in a sclock_t.
+   */
+
+  if (wd_wheel_empty())
+    {
+      g_wdbase = clock_systime_ticks();
+    }
+
+  wd_wheel_place(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_delete
+ *
+ * Description:
+ *   Remove an active watchdog from the timing wheel in constant time.
+ *
+ ****************************************************************************/
+
+void wd_wheel_delete(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *head = wdog->node.next;
+  uintptr_t offset;
+
+  /* If this is the only entry of a slot, the slot becomes empty */
+
+  if (head == wdog->node.prev &&
+      head >= &g_wdwheel[0][0] &&
+      head <  &g_wdwheel[0][0] + WHEEL_LEVELS * WHEEL_SLOTS)
+    {
+      offset = head - &g_wdwheel[0][0];
+      g_wdbitmap[offset >> WHEEL_BITS] &=
+        ~((uint64_t)1 << (offset & WHEEL_MASK));
+    }
+
+  list_delete(&wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the next tick at which the wheel needs service: either a
+ *   watchdog expires or a higher level slot must be cascaded.  The latter
+ *   may be earlier than any expiration, which only causes an early, empty
+ *   timer event.
+ *
+ * Input Parameters:
+ *   next - Location to return the tick
+ *
+ * Returned Value:
+ *   false if no watchdog is active.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  FAR struct wdog_s *wdog;
+  clock_t candidate;
+  clock_t boundary;
+  bool found = false;
+  unsigned int level;
+  int distance;
+
+  distance = wd_wheel_search(0, LEVEL_INDEX(g_wdbase, 0));
+  if (distance >= 0)
+    {
+      *next = g_wdbase + distance;
+      found = true;
+    }
+
+  for (level = 1; level < WHEEL_LEVELS; level++)
+    {
+      /* Higher level slots are cascaded at the first level boundary after
+       * g_wdbase; the cascade of g_wdbase itself is already done.
+       */
+
+      boundary  = ((g_wdbase >> LEVEL_SHIFT(level)) + 1) <<
+                  LEVEL_SHIFT(level);
+      distance  = wd_wheel_search(level, LEVEL_INDEX(boundary, level));
+      if (distance < 0)
+        {
+          continue;
+        }
+
+      candidate = boundary + ((clock_t)distance << LEVEL_SHIFT(level));
+      if (!found || clock_compare(candidate, *next))
+        {
+          *next = candidate;
+          found = true;
+        }
+    }
+
+  if (!list_is_empty(&g_wdoverflow))
+    {
+      wdog      = list_first_entry(&g_wdoverflow, struct wdog_s, node);
+      candidate = wdog->expired - WHEEL_RANGE + 1;
+      if (!found || clock_compare(candidate, *next))
+        {
+          *next = candidate;
+          found = true;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Advance the wheel towards 'ticks' and remove and return the next
+ *   watchdog that has expired at or before 'ticks'.  Empty stretches of
+ *   the wheel are skipped using the slot bitmaps, so a long tickless sleep
+ *   costs no more than the number of non-empty slots passed.
+ *
+ * Input Parameters:
+ *   ticks - The current time in ticks
+ *
+ * Returned Value:
+ *   The expired watchdog, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(clock_t ticks)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  unsigned int index;
+  clock_t next;
+
+  for (; ; )
+    {
+      index = LEVEL_INDEX(g_wdbase, 0);
+      if ((g_wdbitmap[0] & ((uint64_t)1 << index)) != 0)
+        {
+          if (!clock_compare(g_wdbase, ticks))
+            {
+              return NULL;
+            }
+
+          slot = &g_wdwheel[0][index];
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          wd_wheel_delete(wdog);
+          return wdog;
+        }
+
+      /* Nothing due at g_wdbase, jump to the next tick that matters.  No
+       * slot needs service in between, so the jump skips no cascade.
+       */
+
+      if (!wd_wheel_next(&next) || !clock_compare(next, ticks))
+        {
+          if (clock_compare(g_wdbase, ticks))
+            {
+              g_wdbase = ticks;
+            }
+
+          return NULL;
+        }
+
+      g_wdbase = next;
+      wd_wheel_cascade();
+    }
+}
+
+#endif /* CONFIG_WDOG_TIMING_WHEEL */
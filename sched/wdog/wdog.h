@@ -63,7 +63,9 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMING_WHEEL
 extern struct list_node g_wdactivelist;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -123,6 +125,28 @@ void wd_timer(clock_t ticks);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_wheel_insert, wd_wheel_delete, wd_wheel_next, wd_wheel_expired
+ *
+ * Description:
+ *   The hierarchical timing wheel backend that replaces the sorted
+ *   g_wdactivelist when CONFIG_WDOG_TIMING_WHEEL is selected.  Insertion
+ *   and deletion are O(1); wd_wheel_next() reports the next tick at which
+ *   the wheel needs service (for the tickless timer) and
+ *   wd_wheel_expired() removes the watchdogs that are due.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+void wd_wheel_delete(FAR struct wdog_s *wdog);
+bool wd_wheel_next(FAR clock_t *next);
+FAR struct wdog_s *wd_wheel_expired(clock_t ticks);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -36,7 +36,20 @@ echo $WORKSPACE
 config=$(basename $WD)
 if [ "$BOARD" == "sim" ]; then
   target="sim"
-  mark="common or ${BOARD}"
+  case "$config" in
+    tcploss)
+      mark="tcploss"
+      ;;
+    mmbench*)
+      mark="mmbench"
+      ;;
+    lfring*)
+      mark="lfring"
+      ;;
+    *)
+      mark="common or ${BOARD}"
+      ;;
+  esac
 else
   if [ "${config:$((-2))}" == "64" ]; then
     BOARD="${BOARD}64"
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/ci/testrun/script/test_libc/test_lfring.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+# encoding: utf-8
+import pytest
+
+# /proc/lfring runs the mpsc_ring and spsc_ring stress tests, then the
+# throughput comparison with the circbuf locked by a critical section.
+
+pytestmark = [pytest.mark.lfring]
+
+report = (
+    r"mpsc: [^\n]*, (\d+) errors.*?"
+    r"spsc: [^\n]*, (\d+) errors.*?"
+    r"circbuf\+csection\s+(\d+)\s+(\d+)\s+"
+    r"spsc_ring\s+(\d+)\s+(\d+)\s+"
+    r"mpsc_ring\s+(\d+)\s+(\d+)"
+)
+
+
+def test_lfring(p):
+    ret = p.sendCommand("cat /proc/lfring", report, timeout=300)
+    assert ret == 0
+
+    match = p.process.match
+    for i, ring in enumerate(["circbuf+csection", "spsc_ring", "mpsc_ring"]):
+        print(
+            "{}: {} ns/msg {} msgs/s".format(
+                ring, match.group(3 + 2 * i), match.group(4 + 2 * i)
+            )
+        )
+
+    assert int(match.group(1)) == 0
+    assert int(match.group(2)) == 0
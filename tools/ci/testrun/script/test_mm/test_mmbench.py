@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/ci/testrun/script/test_mm/test_mmbench.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+# encoding: utf-8
+import os
+
+import pytest
+
+# Each line of /proc/mmbench reports, for one heap and one pattern:
+# allocator calls, ops/sec, p99 latency (ns), peak heap usage (bytes),
+# fragmentation (%) and failed allocations.
+
+pytestmark = [pytest.mark.mmbench]
+
+result = r"(\S+)\s+{}\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)%\s+(\d+)"
+
+
+def check_result(p, pattern):
+    match = p.process.match
+    print(
+        "{} {}: {} ops/s p99 {} ns peak {} B frag {}%".format(
+            match.group(1),
+            pattern,
+            match.group(3),
+            match.group(4),
+            match.group(5),
+            match.group(6),
+        )
+    )
+    assert int(match.group(2)) > 0
+    assert int(match.group(3)) > 0
+
+
+def test_mmbench_synthetic(p):
+    p.sendCommand("echo > /proc/mmbench")
+    ret = p.sendCommand(
+        "cat /proc/mmbench",
+        result.format("netbuf"),
+        result.format("cxx"),
+        result.format("random"),
+        timeout=300,
+    )
+    assert ret == 0
+    check_result(p, "random")
+
+
+def test_mmbench_trace(p):
+    trace = os.path.dirname(os.path.abspath(__file__))
+    ret = p.sendCommand("mount -t hostfs -o fs={} /data".format(trace))
+    ret = p.sendCommand("echo /data/mmbench.trace > /proc/mmbench")
+    ret = p.sendCommand("cat /proc/mmbench", result.format("trace"), timeout=300)
+    assert ret == 0
+    check_result(p, "trace")
+    assert int(p.process.match.group(7)) == 0
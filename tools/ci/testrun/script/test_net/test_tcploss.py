@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/ci/testrun/script/test_net/test_tcploss.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+# encoding: utf-8
+import pytest
+
+# The tcploss configuration drops CONFIG_NET_LOOPBACK_LOSS per mille of the
+# loopback packets and delays the rest by CONFIG_NET_LOOPBACK_DELAY ms.
+
+pytestmark = [pytest.mark.tcploss]
+
+
+def test_tcploss_goodput(p):
+    ret = p.sendCommand("iperf -s -p 5001 &", "iperf")
+    assert ret == 0
+    ret = p.sendCommand(
+        "iperf -c 127.0.0.1 -p 5001 -t 10 -i 10",
+        r"(\d+\.\d+) Mbits/sec",
+        timeout=60,
+    )
+    assert ret == 0
+    goodput = float(p.process.match.group(1))
+    print("tcploss goodput: %.2f Mbits/sec" % goodput)
+    assert goodput > 0